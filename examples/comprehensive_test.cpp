@@ -2,6 +2,13 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <climits>
+#include <functional>
 
 extern "C" {
 #include <flint/flint.h>
@@ -11,6 +18,19 @@ extern "C" {
 }
 
 #include "expressive_accumulator.h"
+#include "standing_intersection.h"
+#include "query_engine.h"
+#include "set_reconciliation.h"
+#include "fr_polynomial.h"
+#include "fr_ntt.h"
+#include "fr_simd.h"
+#include "batch_inversion.h"
+#include "affine_msm.h"
+#include "powers_of_tau.h"
+#include "witness_store.h"
+#include "write_ahead_log.h"
+#include "keyed_accumulator.h"
+#include "multiset_accumulator.h"
 
 using namespace expressive_accumulator;
 
@@ -62,6 +82,1318 @@ void test_membership_proof(
     std::cout << std::endl;
 }
 
+void test_batch_membership_proof(
+    const ExpressiveTrustedSetup& setup,
+    const ExpressiveAccumulator& acc,
+    const std::vector<int>& members,
+    const std::vector<int>& mixed
+) {
+    BatchMembershipProof batch_proof = acc.generateBatchMembershipProof(members);
+    bool batch_verify = ExpressiveAccumulator::verifyBatchMembershipProof(acc.getDigest(), members, batch_proof, setup);
+    printTestResult("验证批量成员关系 (全部存在)", batch_verify && batch_proof.is_member);
+
+    // 证明不能被挪用到另一组元素上
+    std::vector<int> other(members.begin(), members.end() - 1);
+    printTestResult("拒绝挪用到其他子集的批量证明",
+                    !ExpressiveAccumulator::verifyBatchMembershipProof(acc.getDigest(), other, batch_proof, setup));
+
+    BatchMembershipProof mixed_proof = acc.generateBatchMembershipProof(mixed);
+    printTestResult("验证批量成员关系 (含非成员)",
+                    !mixed_proof.is_member &&
+                    !ExpressiveAccumulator::verifyBatchMembershipProof(acc.getDigest(), mixed, mixed_proof, setup));
+    std::cout << std::endl;
+}
+
+void test_membership_proofs(const ExpressiveTrustedSetup& setup, const ExpressiveAccumulator& acc) {
+    std::vector<int> query(acc.getElements().begin(), acc.getElements().end());
+    query.push_back(6); // 非成员
+    std::vector<MembershipProof> proofs = acc.generateMembershipProofs(query, 2);
+    bool ok = proofs.size() == query.size() && !proofs.back().is_member;
+    for (size_t i = 0; ok && i + 1 < query.size(); ++i) {
+        ok = proofs[i].is_member &&
+             proofs[i].witness_g2 == acc.generateMembershipProof(query[i]).witness_g2 &&
+             ExpressiveAccumulator::verifyMembershipProof(acc.getDigest(), query[i], proofs[i], setup);
+        // 批量输出的见证已一起规范化为仿射坐标
+        ok = ok && proofs[i].witness_g2.isNormalized();
+    }
+    printTestResult("批量求逆生成全部成员证明", ok);
+
+    // 增删路径增量维护的摘要与重新构建的一致
+    ExpressiveAccumulator incremental(setup, G1_TYPE);
+    for (int el = 0; el < 20; ++el) incremental.addElement(el);
+    for (int el = 0; el < 20; el += 3) incremental.deleteElement(el);
+    ExpressiveAccumulator rebuilt(setup, G1_TYPE);
+    for (int el : incremental.getElements()) rebuilt.addElement(el);
+    G1 expected;
+    G1::mul(expected, setup.getG1Generator(), incremental.getPolynomial().evaluate(setup.getSecretS()));
+    printTestResult("增删后的增量摘要正确",
+                    incremental.getDigest() == rebuilt.getDigest() && incremental.getDigest().value == expected);
+    std::cout << std::endl;
+}
+
+void test_cross_membership_proof(const ExpressiveTrustedSetup& setup) {
+    const int keyword = 42;
+    std::vector<std::unique_ptr<ExpressiveAccumulator>> owners;
+    std::vector<const ExpressiveAccumulator*> accs;
+    std::vector<AccumulatorDigest> digests;
+    for (int block = 0; block < 8; ++block) {
+        owners.push_back(std::make_unique<ExpressiveAccumulator>(setup, G1_TYPE));
+        owners.back()->addElement(keyword);
+        for (int j = 0; j < 5; ++j) owners.back()->addElement(block * 100 + j);
+        accs.push_back(owners.back().get());
+        digests.push_back(owners.back()->getDigest());
+    }
+
+    CrossMembershipProof proof = ExpressiveAccumulator::generateCrossMembershipProof(accs, keyword, setup, 4);
+    printTestResult("验证跨累加器成员关系",
+                    proof.is_member && ExpressiveAccumulator::verifyCrossMembershipProof(digests, keyword, proof, setup));
+    printTestResult("拒绝用于其他元素的跨累加器证明",
+                    !ExpressiveAccumulator::verifyCrossMembershipProof(digests, keyword + 1, proof, setup));
+
+    std::vector<AccumulatorDigest> reordered(digests.rbegin(), digests.rend());
+    printTestResult("拒绝摘要顺序被篡改的跨累加器证明",
+                    !ExpressiveAccumulator::verifyCrossMembershipProof(reordered, keyword, proof, setup));
+
+    CrossMembershipProof missing = ExpressiveAccumulator::generateCrossMembershipProof(accs, 1, setup);
+    printTestResult("元素缺失于部分集合时拒绝", !missing.is_member);
+    std::cout << std::endl;
+}
+
+void test_standing_intersection(const ExpressiveTrustedSetup& setup) {
+    ExpressiveAccumulator acc_a(setup, G1_TYPE);
+    ExpressiveAccumulator acc_b(setup, G1_TYPE);
+    for (int el : {1, 2, 3, 4}) acc_a.addElement(el);
+    for (int el : {3, 4, 5, 6}) acc_b.addElement(el);
+
+    StandingIntersectionQuery query(acc_a, acc_b, setup);
+
+    // 覆盖所有迁移路径：新增差集元素、移入交集、移出交集、删除差集元素
+    bool all_ok = true;
+    auto check = [&](const std::string& step) {
+        IntersectionProof fresh = ExpressiveAccumulator::generateIntersectionProof(acc_a, acc_b, setup);
+        bool ok = ExpressiveAccumulator::verifyIntersectionProof(acc_a.getDigest(), acc_b.getDigest(), query.getProof(), setup)
+                  && query.getProof().intersection_digest_g1 == fresh.intersection_digest_g1
+                  && query.getIntersection() == CharacteristicPolynomial::intersection(acc_a.getElements(), acc_b.getElements())
+                  && query.getDigest(QuerySide::A) == acc_a.getDigest()
+                  && query.getDigest(QuerySide::B) == acc_b.getDigest();
+        if (!ok) std::cout << "  常驻查询在步骤 '" << step << "' 后不一致" << std::endl;
+        all_ok = all_ok && ok;
+    };
+
+    check("初始");
+    query.applyUpdate(QuerySide::A, acc_a.addElement(7));    check("A 添加差集元素");
+    query.applyUpdate(QuerySide::A, acc_a.addElement(5));    check("A 添加 B 中元素");
+    query.applyUpdate(QuerySide::B, acc_b.addElement(1));    check("B 添加 A 中元素");
+    query.applyUpdate(QuerySide::B, acc_b.deleteElement(3)); check("B 删除交集元素");
+    query.applyUpdate(QuerySide::A, acc_a.deleteElement(2)); check("A 删除差集元素");
+    query.applyUpdate(QuerySide::A, acc_a.addElement(5));    check("重复添加");
+    query.applyUpdate(QuerySide::A, acc_a.deleteElement(1)); check("A 删除交集元素");
+    query.applyUpdate(QuerySide::B, acc_b.deleteElement(6)); check("B 删除差集元素");
+
+    printSet("常驻查询维护的交集", query.getIntersection());
+    printTestResult("常驻交集查询增量更新", all_ok);
+
+    // 重放旧证明、篡改元素或只置 is_valid 的更新都必须被拒绝，且状态不变
+    UpdateProof accepted = acc_a.addElement(9);
+    bool applied = query.applyUpdate(QuerySide::A, accepted);
+    UpdateProof forged = acc_b.addElement(11);
+    forged.element = 12;
+    UpdateProof unverified;
+    unverified.is_valid = true;
+    unverified.op_type = UpdateOperation::ADD;
+    unverified.element = 13;
+    unverified.old_digest = query.getDigest(QuerySide::A);
+    bool rejected = !query.applyUpdate(QuerySide::A, accepted) &&
+                    !query.applyUpdate(QuerySide::B, forged) &&
+                    !query.applyUpdate(QuerySide::A, unverified);
+    printTestResult("常驻查询拒绝未通过验证的更新",
+                    applied && rejected && query.getIntersection().count(12) == 0 &&
+                    query.getDigest(QuerySide::A) == acc_a.getDigest());
+    std::cout << std::endl;
+}
+
+void test_query_engine(const ExpressiveTrustedSetup& setup) {
+    ExpressiveAccumulator acc_a(setup, G1_TYPE), acc_b(setup, G1_TYPE), acc_c(setup, G1_TYPE), acc_d(setup, G1_TYPE);
+    for (int el : {1, 2, 3, 4, 5, 6}) acc_a.addElement(el);
+    for (int el : {2, 4, 6, 8}) acc_b.addElement(el);
+    for (int el : {4, 6, 10, 11}) acc_c.addElement(el);
+    for (int el : {6, 11}) acc_d.addElement(el);
+
+    QueryEngine engine(setup);
+    engine.registerAccumulator("A", acc_a);
+    engine.registerAccumulator("B", acc_b);
+    engine.registerAccumulator("C", acc_c);
+    engine.registerAccumulator("D", acc_d);
+
+    std::map<std::string, AccumulatorDigest> digests = {
+        {"A", acc_a.getDigest()}, {"B", acc_b.getDigest()}, {"C", acc_c.getDigest()}, {"D", acc_d.getDigest()}};
+
+    const std::string expression = "(A ∩ B) ∪ (C \\ D)";
+    CompositeQueryProof proof = engine.evaluate(expression);
+    printSet("(A ∩ B) ∪ (C \\ D)", proof.result);
+    bool expected_result = proof.result == std::set<int>({2, 4, 6, 10});
+    printTestResult("复合查询结果正确", expected_result);
+    printTestResult("验证复合查询证明", QueryEngine::verify(expression, digests, proof, setup));
+    printTestResult("拒绝与表达式不符的证明", !QueryEngine::verify("(A & B) | (D - C)", digests, proof, setup));
+
+    // 公共子表达式 A ∩ B 与 B ∩ C ∩ A 的交集链只计算一次
+    CompositeQueryProof shared = engine.evaluate("(A & B) - (B & C & A)");
+    printSet("(A ∩ B) \\ (A ∩ B ∩ C)", shared.result);
+    bool shared_ok = shared.result == std::set<int>({2}) &&
+                     shared.nodes.size() == 6 &&  // 3 个叶子 + A∩B + (A∩B)∩C + 差集
+                     QueryEngine::verify("(A & B) - (B & C & A)", digests, shared, setup);
+    printTestResult("复用公共子表达式的复合证明", shared_ok);
+    std::cout << std::endl;
+}
+
+void test_threshold_query(const ExpressiveTrustedSetup& setup) {
+    std::vector<std::set<int>> contents = {{1, 2, 3}, {2, 3, 4}, {3, 4, 5}, {1, 3, 5, 7}};
+    std::vector<std::unique_ptr<ExpressiveAccumulator>> owners;
+    std::vector<const ExpressiveAccumulator*> accs;
+    std::vector<AccumulatorDigest> digests;
+    for (const auto& content : contents) {
+        owners.push_back(std::make_unique<ExpressiveAccumulator>(setup, G1_TYPE));
+        for (int el : content) owners.back()->addElement(el);
+        accs.push_back(owners.back().get());
+        digests.push_back(owners.back()->getDigest());
+    }
+
+    ThresholdQueryProof proof = ThresholdQuery::generate(accs, 3, setup);
+    printSet("至少出现在 3 个集合中的元素", proof.result);
+    printTestResult("门限查询结果正确", proof.result == std::set<int>({3}));
+    printTestResult("验证门限查询证明", ThresholdQuery::verify(digests, proof, setup));
+
+    ThresholdQueryProof forged = ThresholdQuery::generate(accs, 2, setup);
+    forged.threshold = 3; // 声称 2-of-4 的结果满足 3-of-4
+    printTestResult("拒绝门限不符的证明", !ThresholdQuery::verify(digests, forged, setup));
+
+    ThresholdQueryProof tampered = ThresholdQuery::generate(accs, 2, setup);
+    tampered.subsets[0].insert(5); // 声称 5 也属于第一个集合
+    tampered.result.insert(5);
+    printTestResult("拒绝伪造子集的证明", !ThresholdQuery::verify(digests, tampered, setup));
+    std::cout << std::endl;
+}
+
+void test_ntt_polynomial_arithmetic() {
+    using FrPolynomial::Poly;
+    Fr w;
+    Fr::pow(w, FrNtt::rootOfUnity(FrNtt::MAX_LOG_SIZE), static_cast<int64_t>(1) << 31);
+    printTestResult("2^32 次本原单位根", w == -Fr(1));
+
+    std::set<int> roots_a, roots_b;
+    for (int el = 0; el < 700; ++el) roots_a.insert(el * 3);
+    for (int el = 0; el < 550; ++el) roots_b.insert(el * 3 + 1);
+    Poly pa = FrPolynomial::fromRoots(roots_a);
+    Poly pb = FrPolynomial::fromRoots(roots_b);
+
+    // NTT 乘法与逐项乘法一致
+    Poly expected(pa.size() + pb.size() - 1, Fr(0));
+    for (size_t i = 0; i < pa.size(); ++i) {
+        for (size_t j = 0; j < pb.size(); ++j) expected[i + j] += pa[i] * pb[j];
+    }
+    printTestResult("NTT 多项式乘法", FrPolynomial::mul(pa, pb, 4) == expected);
+
+    // 低于 NTT 阈值时走逐项与 Karatsuba 累加路径，结果缓冲区须从零开始
+    bool accumulate_ok = true;
+    for (size_t len : {5, 40, 63}) {
+        Poly a(pa.begin(), pa.begin() + len), b(pb.begin(), pb.begin() + len + 7);
+        Poly naive(a.size() + b.size() - 1, Fr(0));
+        for (size_t i = 0; i < a.size(); ++i) {
+            for (size_t j = 0; j < b.size(); ++j) naive[i + j] += a[i] * b[j];
+        }
+        FrPolynomial::trim(naive);
+        accumulate_ok = accumulate_ok && FrPolynomial::mul(a, b) == naive;
+    }
+    printTestResult("逐项/Karatsuba 多项式乘法", accumulate_ok);
+
+    // half-GCD 扩展欧几里得：互素时 u·a + v·b = 1，且满足次数约束
+    Poly g, u, v;
+    FrPolynomial::xgcd(g, u, v, pa, pb);
+    bool ok = FrPolynomial::isOne(g) &&
+              FrPolynomial::isOne(FrPolynomial::add(FrPolynomial::mul(u, pa), FrPolynomial::mul(v, pb))) &&
+              FrPolynomial::degree(u) < FrPolynomial::degree(pb) &&
+              FrPolynomial::degree(v) < FrPolynomial::degree(pa);
+    printTestResult("half-GCD 贝祖系数", ok);
+    std::cout << std::endl;
+}
+
+void test_fr_simd_kernels() {
+    const size_t n = 301; // 不是通道数的整数倍，覆盖尾部处理
+    std::vector<Fr> x(n, Fr(0)), y(n, Fr(0));
+    std::vector<int> roots(n);
+    for (size_t i = 0; i < n; ++i) {
+        x[i].setHashOf("simd/x/" + std::to_string(i));
+        y[i].setHashOf("simd/y/" + std::to_string(i));
+        roots[i] = static_cast<int>(i * 37) - 5000;
+    }
+    x[n / 2] = -Fr(1); // p - 1 检验进位
+    Fr a;
+    a.setHashOf("simd/a");
+    std::vector<Fr> expected_inv = y;
+    expected_inv[7] = 0;
+    for (auto& v : expected_inv) {
+        if (!v.isZero()) Fr::inv(v, v);
+    }
+
+    const FrSimd::Backend best = FrSimd::activeBackend();
+    const FrSimd::Backend backends[] = {FrSimd::Backend::SCALAR, FrSimd::Backend::AVX2,
+                                        FrSimd::Backend::AVX512, FrSimd::Backend::AVX512_IFMA};
+    for (FrSimd::Backend backend : backends) {
+        if (!FrSimd::setBackend(backend)) continue;
+        std::vector<Fr> prod(n, Fr(0)), sum(n, Fr(0)), diff(n, Fr(0));
+        FrSimd::mulVec(prod.data(), x.data(), y.data(), n);
+        FrSimd::addVec(sum.data(), x.data(), y.data(), n);
+        FrSimd::subVec(diff.data(), x.data(), y.data(), n);
+        bool ok = true;
+        Fr total = 1, linear = 1;
+        for (size_t i = 0; i < n; ++i) {
+            ok = ok && prod[i] == x[i] * y[i] && sum[i] == x[i] + y[i] && diff[i] == x[i] - y[i];
+            total *= x[i];
+            linear *= a - Fr(roots[i]);
+        }
+        ok = ok && FrSimd::product(x.data(), n) == total &&
+             FrSimd::linearProduct(a, roots.data(), n) == linear;
+
+        std::vector<Fr> inv = y;
+        inv[7] = 0;
+        FrSimd::batchInvert(inv.data(), n);
+        ok = ok && inv == expected_inv;
+        printTestResult(std::string("Fr 向量内核 (") + FrSimd::backendName(backend) + ")", ok);
+    }
+    FrSimd::setBackend(best);
+    std::cout << std::endl;
+}
+
+template <typename G>
+bool checkAffineMsm(const std::vector<G>& bases, const std::vector<Fr>& coeffs) {
+    typedef typename G::Fp Coord;
+    const size_t n = bases.size();
+    std::vector<G> normalized(bases);
+    BatchInversion::normalizePoints(normalized);
+    AlignedArray<Coord> xs(n), ys(n);
+    std::vector<uint8_t> infinity(n);
+    for (size_t i = 0; i < n; ++i) {
+        xs[i] = normalized[i].x;
+        ys[i] = normalized[i].y;
+        infinity[i] = normalized[i].isZero() ? 1 : 0;
+    }
+    bool ok = reinterpret_cast<uintptr_t>(xs.data()) % CACHE_LINE_BYTES == 0 &&
+              reinterpret_cast<uintptr_t>(ys.data()) % CACHE_LINE_BYTES == 0;
+
+    G expected;
+    G::mulVec(expected, bases.data(), coeffs.data(), n);
+    // 一整段与拆成两段
+    const size_t half = n / 3;
+    std::vector<AffineSpan<Coord>> whole = {{xs.data(), ys.data(), infinity.data(), coeffs.data(), n}};
+    std::vector<AffineSpan<Coord>> split = {
+        {xs.data(), ys.data(), infinity.data(), coeffs.data(), half},
+        {xs.data() + half, ys.data() + half, infinity.data() + half, coeffs.data() + half, n - half}};
+    for (size_t window : {3, 7, 0}) {
+        for (size_t threads : {1, 4}) {
+            G result;
+            AffineMsm::multiExp(result, whole, threads, window);
+            ok = ok && result == expected;
+            AffineMsm::multiExp(result, split, threads, window);
+            ok = ok && result == expected;
+        }
+    }
+    return ok;
+}
+
+void test_affine_msm(const Fr& secret_s, const Fr& secret_r) {
+    ExpressiveTrustedSetup setup(secret_s, secret_r, 60);
+    setup.generatePowers();
+
+    // 重复的底点与标量触发桶冲突和倍点，P 与 -P 触发抵消，另含无穷远点和零标量
+    const size_t n = 700;
+    std::vector<G1> g1_bases(n);
+    std::vector<G2> g2_bases(n);
+    std::vector<Fr> coeffs(n);
+    for (size_t i = 0; i < n; ++i) {
+        g1_bases[i] = setup.getG1_s_pow(static_cast<int>(i % 50));
+        g2_bases[i] = setup.getG2_s_pow(static_cast<int>(i % 50));
+        if (i % 7 == 3) {
+            g1_bases[i] = -g1_bases[i];
+            g2_bases[i] = -g2_bases[i];
+        }
+        coeffs[i].setHashOf("affine_msm/" + std::to_string(i % 90));
+    }
+    g1_bases[11].clear();
+    g2_bases[11].clear();
+    coeffs[12] = 0;
+    coeffs[13] = -1;
+    printTestResult("批量仿射多标量乘法 (G1)", checkAffineMsm(g1_bases, coeffs));
+    printTestResult("批量仿射多标量乘法 (G2)", checkAffineMsm(g2_bases, coeffs));
+
+    // AFFINE 幂次表的大规模承诺走批量仿射路径
+    const size_t degree = PowerTable<G1>::BATCH_AFFINE_MIN_POINTS + 100;
+    ExpressiveTrustedSetup affine_setup(secret_s, secret_r, degree, PowerStorage::AFFINE);
+    affine_setup.generatePowers();
+    std::vector<Fr> poly(degree + 1);
+    for (size_t i = 0; i < poly.size(); ++i) poly[i].setHashOf("affine_msm/poly/" + std::to_string(i));
+    Fr value = 0;
+    for (size_t i = poly.size(); i-- > 0;) value = value * secret_s + poly[i];
+    G1 expected;
+    G1::mul(expected, affine_setup.getG1Generator(), value);
+    printTestResult("AFFINE 幂次表 SoA 布局上的承诺", affine_setup.commitG1(poly) == expected);
+    std::cout << std::endl;
+}
+
+void test_batch_inversion(const ExpressiveTrustedSetup& setup) {
+    const size_t n = 3000;
+    std::vector<Fr> fr(n, Fr(0));
+    std::vector<Fp> fp(n, Fp(0));
+    for (size_t i = 0; i < n; ++i) {
+        fr[i].setHashOf("batch_inv/fr/" + std::to_string(i));
+        fp[i].setHashOf("batch_inv/fp/" + std::to_string(i));
+    }
+    fr[5] = 0;
+    fp[n - 1] = 0;
+
+    std::vector<Fr> fr_inv = fr;
+    std::vector<Fp> fp_inv = fp, fp_inv_parallel = fp;
+    BatchInversion::invertParallel(fr_inv, 4);
+    BatchInversion::invert(fp_inv);
+    BatchInversion::invertParallel(fp_inv_parallel, 3);
+    bool ok = fr_inv[5].isZero() && fp_inv[n - 1].isZero() && fp_inv == fp_inv_parallel;
+    for (size_t i = 0; ok && i < n; ++i) {
+        if (!fr[i].isZero()) ok = (fr[i] * fr_inv[i] == Fr(1));
+        if (!fp[i].isZero()) ok = ok && (fp[i] * fp_inv[i] == Fp(1));
+    }
+    printTestResult("Fr/Fp 批量求逆 (含零元素)", ok);
+
+    // 批量规范化后点不变且 z = 1
+    std::vector<G1> points(64);
+    std::vector<G2> points_g2(64);
+    for (size_t i = 0; i < points.size(); ++i) {
+        G1::mul(points[i], setup.getG1Generator(), Fr(static_cast<int64_t>(i * i + 1)));
+        G2::mul(points_g2[i], setup.getG2Generator(), Fr(static_cast<int64_t>(i + 7)));
+    }
+    points[3].clear();
+    std::vector<G1> normalized = points;
+    std::vector<G2> normalized_g2 = points_g2;
+    BatchInversion::normalizePoints(normalized, 2);
+    BatchInversion::normalizePoints(normalized_g2);
+    ok = normalized == points && normalized_g2 == points_g2;
+    for (size_t i = 0; ok && i < normalized.size(); ++i) {
+        ok = normalized[i].isNormalized() && normalized_g2[i].isNormalized();
+    }
+    printTestResult("G1/G2 批量规范化", ok);
+
+    // 批量序列化与逐个 getStr 的结果逐字节相同
+    std::vector<std::string> serialized = BatchInversion::serializePoints(points.data(), points.size());
+    std::vector<std::string> serialized_g2 = BatchInversion::serializePoints(points_g2.data(), points_g2.size(), 2);
+    std::vector<AccumulatorDigest> digests(points.size());
+    for (size_t i = 0; i < points.size(); ++i) digests[i].value = points[i];
+    std::vector<std::string> serialized_digests = AccumulatorDigest::serializeBatch(digests);
+    ok = serialized.size() == points.size() && serialized_g2.size() == points_g2.size();
+    for (size_t i = 0; ok && i < points.size(); ++i) {
+        ok = serialized[i] == points[i].getStr(mcl::IoSerialize) &&
+             serialized_g2[i] == points_g2[i].getStr(mcl::IoSerialize) && serialized_digests[i] == digests[i].serialize();
+    }
+    printTestResult("G1/G2 批量规范化后序列化", ok);
+    std::cout << std::endl;
+}
+
+void test_power_storage(const Fr& secret_s, const Fr& secret_r) {
+    const size_t degree = 40;
+    std::set<int> roots;
+    for (int el = 1; el <= 30; ++el) roots.insert(el * 11);
+    std::vector<Fr> coeffs = FrPolynomial::fromRoots(roots);
+    G1 expected_g1;
+    G2 expected_g2;
+    Fr value = CharacteristicPolynomial(roots).evaluate(secret_s);
+
+    size_t previous_bytes = 0;
+    const PowerStorage storages[] = {PowerStorage::JACOBIAN, PowerStorage::AFFINE, PowerStorage::COMPRESSED};
+    const char* names[] = {"JACOBIAN", "AFFINE", "COMPRESSED"};
+    for (size_t k = 0; k < 3; ++k) {
+        ExpressiveTrustedSetup setup(secret_s, secret_r, degree, storages[k]);
+        setup.generatePowers();
+        G1::mul(expected_g1, setup.getG1Generator(), value);
+        G2::mul(expected_g2, setup.getG2Generator(), value);
+
+        Fr s_pow;
+        Fr::pow(s_pow, secret_s, static_cast<int64_t>(7));
+        G1 p7;
+        G1::mul(p7, setup.getG1Generator(), s_pow);
+        bool ok = setup.g1_s_powers.size() == degree + 2 && setup.getG1_s_pow(7) == p7 &&
+                  setup.commitG1(coeffs, 2) == expected_g1 && setup.commitG2(coeffs) == expected_g2;
+        // 存储越紧凑占用越少
+        ok = ok && (k == 0 || setup.powerTableBytes() < previous_bytes);
+        previous_bytes = setup.powerTableBytes();
+        std::cout << names[k] << " 幂次表占用 " << previous_bytes << " 字节" << std::endl;
+        printTestResult(std::string("幂次表存储与多项式承诺 (") + names[k] + ")", ok);
+    }
+    std::cout << std::endl;
+}
+
+void test_pairing_cache(const ExpressiveTrustedSetup& setup) {
+    PairingCache& cache = setup.pairingCache();
+    cache.clear();
+
+    // 同一摘要上的多次验证只计算一次 e(A, g2)，伪造的证明在命中时仍被拒绝
+    ExpressiveAccumulator acc(setup, G1_TYPE);
+    for (int el = 1; el <= 12; ++el) acc.addElement(el * 5);
+    std::vector<int> query = {5, 10, 15, 20, 25};
+    std::vector<MembershipProof> proofs = acc.generateMembershipProofs(query);
+    bool ok = true;
+    for (size_t i = 0; i < query.size(); ++i) {
+        ok = ok && ExpressiveAccumulator::verifyMembershipProof(acc.getDigest(), query[i], proofs[i], setup);
+    }
+    ok = ok && !ExpressiveAccumulator::verifyMembershipProof(acc.getDigest(), 30, proofs[0], setup);
+    PairingCacheStats stats = cache.stats();
+    ok = ok && stats.misses == 1 && stats.hits == query.size() && stats.entries == 1;
+    printTestResult("配对缓存：热点摘要的重复验证命中缓存", ok);
+
+    // 缓存值与直接配对一致；超出容量时淘汰最久未用的条目；底点改变时缓存作废
+    cache.setCapacity(2);
+    G1 points[3];
+    GT cached, direct;
+    ok = true;
+    for (int k = 0; k < 3; ++k) {
+        G1::mul(points[k], setup.getG1Generator(), Fr(k + 2));
+        cache.pairing(cached, points[k], setup.getG2Generator());
+        pairing(direct, points[k], setup.getG2Generator());
+        ok = ok && cached == direct;
+    }
+    stats = cache.stats();
+    ok = ok && stats.entries == 2 && stats.evictions == 2;
+    G2 other_base;
+    G2::mul(other_base, setup.getG2Generator(), Fr(7));
+    cache.pairing(cached, points[2], other_base);
+    pairing(direct, points[2], other_base);
+    ok = ok && cached == direct && cache.stats().entries == 1;
+    printTestResult("配对缓存：容量上限与底点变化", ok);
+
+    cache.setCapacity(PairingCache::DEFAULT_CAPACITY);
+    cache.clear();
+    std::cout << std::endl;
+}
+
+void test_table_placement(const Fr& secret_s, const Fr& secret_r) {
+    std::cout << "NUMA 节点数: " << MemoryPlacement::numaNodeCount()
+              << ", 当前节点: " << MemoryPlacement::currentNode() << std::endl;
+
+    // 放置方式只影响内存的位置，读取与承诺必须与默认放置一致；EXPLICIT 在没有大页池时退回透明大页
+    const size_t degree = PowerTable<G1>::BATCH_AFFINE_MIN_POINTS + 100;
+    std::vector<Fr> poly(degree + 1);
+    for (size_t i = 0; i < poly.size(); ++i) poly[i].setHashOf("placement/poly/" + std::to_string(i));
+    Fr value = 0;
+    for (size_t i = poly.size(); i-- > 0;) value = value * secret_s + poly[i];
+
+    TablePlacement placements[3];
+    placements[0].huge_pages = HugePageMode::TRANSPARENT;
+    placements[1].huge_pages = HugePageMode::EXPLICIT;
+    placements[2].huge_pages = HugePageMode::TRANSPARENT;
+    placements[2].numa_replicas = true;
+    placements[2].replica_count = 2;
+    const char* names[] = {"透明大页", "显式大页", "两份 NUMA 副本"};
+    for (size_t k = 0; k < 3; ++k) {
+        ExpressiveTrustedSetup setup(secret_s, secret_r, degree, PowerStorage::AFFINE, placements[k]);
+        setup.generatePowers();
+        G1 expected_g1;
+        G2 expected_g2;
+        G1::mul(expected_g1, setup.getG1Generator(), value);
+        G2::mul(expected_g2, setup.getG2Generator(), value);
+        Fr s_pow;
+        Fr::pow(s_pow, secret_s, static_cast<int64_t>(degree));
+        G1 last;
+        G1::mul(last, setup.getG1Generator(), s_pow);
+
+        const size_t replicas = placements[k].numa_replicas ? placements[k].replica_count : 1;
+        bool ok = setup.g1_s_powers.replicaCount() == replicas && setup.getG1_s_pow(static_cast<int>(degree)) == last &&
+                  setup.commitG1(poly) == expected_g1 && setup.commitG2(poly, 2) == expected_g2;
+        // 每份副本单独映射，区域按大页对齐
+        ok = ok && setup.g1_s_powers.mappedBytes() >= setup.g1_s_powers.memoryBytes() &&
+             setup.g1_s_powers.mappedBytes() % MemoryPlacement::HUGE_PAGE_BYTES == 0;
+        printTestResult(std::string("幂次表内存放置 (") + names[k] + ")", ok);
+    }
+    std::cout << std::endl;
+}
+
+void test_precomputed_msm(const Fr& secret_s, const Fr& secret_r) {
+    const size_t degree = 300;
+    ExpressiveTrustedSetup setup(secret_s, secret_r, degree, PowerStorage::AFFINE);
+    setup.generatePowers();
+
+    // 随机系数，混入 0、1、-1 以覆盖有符号窗口编码的边界
+    std::vector<Fr> coeffs(degree + 1);
+    for (size_t i = 0; i < coeffs.size(); ++i) coeffs[i].setHashOf("precomputed_msm/" + std::to_string(i));
+    coeffs[3] = 0;
+    coeffs[4] = 1;
+    coeffs[5] = -1;
+    const G1 expected_g1 = setup.commitG1(coeffs);
+    const G2 expected_g2 = setup.commitG2(coeffs);
+
+    bool ok = true;
+    for (size_t window : {2, 5, 8, 13}) {
+        setup.enablePrecomputation(window);
+        ok = ok && setup.commitG1(coeffs, 1) == expected_g1 && setup.commitG1(coeffs, 4) == expected_g1 &&
+             setup.commitG2(coeffs) == expected_g2;
+    }
+    printTestResult("预计算窗口表承诺与多标量乘法一致", ok);
+
+    // 内存预算只够覆盖低次部分时，其余部分走幂次表
+    const size_t per_base = PrecomputedMsm<G1>::bytesPerBase(8) + PrecomputedMsm<G2>::bytesPerBase(8);
+    size_t covered = setup.enablePrecomputation(8, 100 * per_base);
+    ok = covered == 100 && setup.precomputedBytes() <= 100 * per_base &&
+         setup.commitG1(coeffs) == expected_g1 && setup.commitG2(coeffs) == expected_g2;
+    setup.disablePrecomputation();
+    ok = ok && setup.precomputedBytes() == 0 && setup.commitG1(coeffs) == expected_g1;
+    printTestResult("预计算内存预算与部分覆盖", ok);
+    std::cout << std::endl;
+}
+
+void test_growable_setup(const Fr& secret_s, const Fr& secret_r) {
+    ExpressiveTrustedSetup setup(secret_s, secret_r, 5000, PowerStorage::AFFINE);
+    setup.generatePowers(5);
+    auto expected_pow = [&](size_t i) {
+        Fr s_pow;
+        Fr::pow(s_pow, secret_s, static_cast<int64_t>(i));
+        G1 P;
+        G1::mul(P, setup.getG1Generator(), s_pow);
+        return P;
+    };
+    printTestResult("惰性生成：未覆盖的幂次直接计算",
+                    setup.availableDegree() == 5 && setup.getG1_s_pow(50) == expected_pow(50));
+
+    // 后台扩展跨越多个块，同时有读取者并发读取已发布的点
+    std::atomic<bool> done(false);
+    std::atomic<bool> reader_ok(true);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            size_t n = setup.g1_s_powers.size();
+            G1 last = setup.g1_s_powers.get(n - 1);
+            if (last.isZero()) reader_ok = false;
+        }
+    });
+    setup.reserveDegree(9000);
+    setup.waitForExtension();
+    done = true;
+    reader.join();
+
+    const size_t CHUNK = PowerTable<G1>::CHUNK_SIZE;
+    bool ok = reader_ok && setup.availableDegree() >= 9000;
+    for (size_t i : {CHUNK - 1, CHUNK, CHUNK + 1, 2 * CHUNK + 7}) {
+        ok = ok && setup.g1_s_powers.get(i) == expected_pow(i) &&
+             setup.g2_s_powers.get(i) == setup.getG2_s_pow(static_cast<int>(i));
+    }
+    printTestResult("后台扩展幂次表 (并发读取)", ok);
+
+    // 超出幂次表的承诺：表内部分做多标量乘法，剩余部分直接求值
+    std::set<int> roots;
+    for (int el = 0; el < 9500; ++el) roots.insert(el);
+    G1 expected;
+    G1::mul(expected, setup.getG1Generator(), CharacteristicPolynomial(roots).evaluate(secret_s));
+    printTestResult("超出幂次表的多项式承诺", setup.commitG1(FrPolynomial::fromRoots(roots)) == expected);
+    setup.waitForExtension();
+
+    // 集合增长时累加器自动预留次数
+    ExpressiveTrustedSetup small(secret_s, secret_r, 3);
+    small.generatePowers();
+    ExpressiveAccumulator acc(small, G1_TYPE);
+    for (int el = 0; el < 20; ++el) acc.addElement(el);
+    small.waitForExtension();
+    printTestResult("集合增长触发幂次表扩展", small.availableDegree() >= 20);
+
+    // 关闭后台扩展后集合增长不再扩展幂次表，摘要仍正确
+    ExpressiveTrustedSetup fixed(secret_s, secret_r, 3);
+    fixed.generatePowers();
+    fixed.setBackgroundExtension(false);
+    const size_t fixed_degree = fixed.availableDegree();
+    ExpressiveAccumulator fixed_acc(fixed, G1_TYPE);
+    for (int el = 0; el < 20; ++el) fixed_acc.addElement(el);
+    fixed.waitForExtension();
+    G1 fixed_expected;
+    G1::mul(fixed_expected, fixed.getG1Generator(), CharacteristicPolynomial(fixed_acc.getElements()).evaluate(secret_s));
+    printTestResult("关闭后台扩展", fixed.availableDegree() == fixed_degree &&
+                                    fixed_acc.getDigest().value == fixed_expected);
+    std::cout << std::endl;
+}
+
+void test_validate_setup(const ExpressiveTrustedSetup& setup, const Fr& secret_s, const Fr& secret_r) {
+    printTestResult("随机化验证可信设置", setup.validateSetup());
+
+    // 篡改 G1 表中的一个点
+    ExpressiveTrustedSetup tampered(secret_s, secret_r, 30);
+    tampered.generatePowers();
+    std::vector<G1> g1_points(tampered.g1_s_powers.size());
+    tampered.g1_s_powers.getBlock(g1_points.data(), 0, g1_points.size());
+    g1_points[17] += tampered.getG1Generator();
+    tampered.g1_s_powers.clear();
+    tampered.g1_s_powers.append(g1_points);
+    printTestResult("拒绝被篡改的 G1 幂次表", !tampered.validateSetup());
+
+    // G2 表与 G1 表使用不同的秘密值
+    Fr other_s;
+    other_s.setHashOf("validate_setup/other_s");
+    ExpressiveTrustedSetup mixed(secret_s, secret_r, 30);
+    ExpressiveTrustedSetup other(other_s, secret_r, 30);
+    mixed.generatePowers();
+    other.generatePowers();
+    std::vector<G2> g2_points(other.g2_s_powers.size());
+    other.g2_s_powers.getBlock(g2_points.data(), 0, g2_points.size());
+    mixed.g2_s_powers.clear();
+    mixed.g2_s_powers.append(g2_points);
+    printTestResult("拒绝 G1/G2 秘密值不一致的幂次表", !mixed.validateSetup());
+    std::cout << std::endl;
+}
+
+// Fp 的小端字节（snarkjs 文件中先乘以 Montgomery 因子 R = 2^384）
+void appendFpLE(std::string& out, const Fp& v) {
+    std::string hex = v.getStr(16);
+    hex = std::string(96 - hex.size(), '0') + hex;
+    for (size_t i = 48; i-- > 0;) out.push_back(static_cast<char>(std::stoul(hex.substr(2 * i, 2), nullptr, 16)));
+}
+
+void appendU32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+}
+
+void appendU64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>(v >> (8 * i)));
+}
+
+void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(data.data(), data.size());
+}
+
+void test_powers_of_tau_import(const ExpressiveTrustedSetup& setup) {
+    const uint32_t power = 4;
+    const size_t tau_powers = size_t(1) << power;
+    const std::string dir = std::filesystem::temp_directory_path().string();
+    const std::string response_path = dir + "/accumulator_test.response";
+    const std::string ptau_path = dir + "/accumulator_test.ptau";
+
+    // 压缩编码往返
+    bool roundtrip = true;
+    for (int i = 0; i < 5; ++i) {
+        uint8_t buf1[PowersOfTau::G1_COMPRESSED_BYTES], buf2[PowersOfTau::G2_COMPRESSED_BYTES];
+        G1 P = setup.getG1_s_pow(i), P_dec;
+        G2 Q = setup.getG2_s_pow(i), Q_dec;
+        PowersOfTau::encodeG1(buf1, P);
+        PowersOfTau::encodeG2(buf2, Q);
+        roundtrip = roundtrip && PowersOfTau::decodeG1(P_dec, buf1) && P_dec == P &&
+                    PowersOfTau::decodeG2(Q_dec, buf2) && Q_dec == Q;
+    }
+    G1 zero1, dec1;
+    zero1.clear();
+    uint8_t inf[PowersOfTau::G1_COMPRESSED_BYTES];
+    PowersOfTau::encodeG1(inf, zero1);
+    roundtrip = roundtrip && PowersOfTau::decodeG1(dec1, inf) && dec1.isZero();
+    printTestResult("Zcash 压缩点编码往返", roundtrip);
+
+    // response 格式：64 字节哈希、2·2^p - 1 个 G1 点、2^p 个 G2 点
+    std::string response(64, '\0');
+    for (size_t i = 0; i < 2 * tau_powers - 1; ++i) {
+        uint8_t buf[PowersOfTau::G1_COMPRESSED_BYTES];
+        PowersOfTau::encodeG1(buf, setup.getG1_s_pow(static_cast<int>(i)));
+        response.append(reinterpret_cast<const char*>(buf), sizeof(buf));
+    }
+    const size_t g2_offset = response.size();
+    for (size_t i = 0; i < tau_powers; ++i) {
+        uint8_t buf[PowersOfTau::G2_COMPRESSED_BYTES];
+        PowersOfTau::encodeG2(buf, setup.getG2_s_pow(static_cast<int>(i)));
+        response.append(reinterpret_cast<const char*>(buf), sizeof(buf));
+    }
+    writeFile(response_path, response);
+
+    // snarkjs 格式：头部节 + G1/G2 节，小端 Montgomery 坐标
+    Fp R, p_minus_one = -Fp(1);
+    Fp::pow(R, Fp(2), 384);
+    std::string header, g1_section, g2_section;
+    appendU32(header, 48);
+    std::string q;
+    appendFpLE(q, p_minus_one);
+    for (size_t i = 0; i < q.size(); ++i) {
+        if (++q[i] != 0) break; // p = (p - 1) + 1
+    }
+    header += q;
+    appendU32(header, power);
+    appendU32(header, power);
+    for (size_t i = 0; i < 2 * tau_powers - 1; ++i) {
+        G1 P = setup.getG1_s_pow(static_cast<int>(i));
+        P.normalize();
+        appendFpLE(g1_section, P.x * R);
+        appendFpLE(g1_section, P.y * R);
+    }
+    for (size_t i = 0; i < tau_powers; ++i) {
+        G2 Q = setup.getG2_s_pow(static_cast<int>(i));
+        Q.normalize();
+        appendFpLE(g2_section, Q.x.a * R);
+        appendFpLE(g2_section, Q.x.b * R);
+        appendFpLE(g2_section, Q.y.a * R);
+        appendFpLE(g2_section, Q.y.b * R);
+    }
+    std::string ptau = "ptau";
+    appendU32(ptau, 1);
+    appendU32(ptau, 3);
+    const std::string* sections[3] = {&header, &g1_section, &g2_section};
+    for (uint32_t type = 1; type <= 3; ++type) {
+        appendU32(ptau, type);
+        appendU64(ptau, sections[type - 1]->size());
+        ptau += *sections[type - 1];
+    }
+    writeFile(ptau_path, ptau);
+
+    auto matches = [&](const ExpressiveTrustedSetup& imported, size_t count) {
+        if (imported.g1_s_powers.size() != count || imported.g2_s_powers.size() != count) return false;
+        for (size_t i = 0; i < count; ++i) {
+            if (!(imported.getG1_s_pow(static_cast<int>(i)) == setup.getG1_s_pow(static_cast<int>(i))) ||
+                !(imported.getG2_s_pow(static_cast<int>(i)) == setup.getG2_s_pow(static_cast<int>(i)))) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    try {
+        PtauImportOptions options;
+        options.format = PtauFormat::POWERSOFTAU_RESPONSE;
+        options.ceremony_power = power;
+        options.num_threads = 3;
+        auto from_response = ExpressiveTrustedSetup::importPowersOfTau(response_path, options);
+        printTestResult("导入 powersoftau response 文件", matches(*from_response, tau_powers) &&
+                                                         from_response->validateSetup() &&
+                                                         !from_response->hasSecret());
+
+        PtauImportOptions ptau_options;
+        ptau_options.max_degree = 10;
+        ptau_options.storage = PowerStorage::COMPRESSED;
+        auto from_ptau = ExpressiveTrustedSetup::importPowersOfTau(ptau_path, ptau_options);
+        std::vector<Fr> coeffs(12);
+        for (size_t i = 0; i < coeffs.size(); ++i) coeffs[i] = Fr(static_cast<int>(3 * i + 1));
+        printTestResult("导入 snarkjs .ptau 文件（截取到 max_degree）",
+                        matches(*from_ptau, 12) && from_ptau->validateSetup() &&
+                        from_ptau->commitG1(coeffs) == setup.commitG1(coeffs));
+
+        bool beyond_rejected = false;
+        try {
+            from_ptau->getG1_s_pow(12);
+        } catch (const std::out_of_range&) {
+            beyond_rejected = true;
+        }
+        printTestResult("导入的 setup 不能超出幂次表", beyond_rejected);
+
+        // 导入的 setup 不知道 s：维护 P(s) 的累加器与读取秘密都必须拒绝，而不是悄悄用 s = 0
+        auto needs_secret = [](const std::function<void()>& build) {
+            try {
+                build();
+            } catch (const std::logic_error&) {
+                return true;
+            }
+            return false;
+        };
+        const ExpressiveTrustedSetup& imported = *from_ptau;
+        printTestResult("无秘密的导入 setup 拒绝构造累加器",
+                        needs_secret([&]() { ExpressiveAccumulator acc(imported, G1_TYPE); }) &&
+                        needs_secret([&]() { KeyedAccumulator<uint64_t> keyed(imported); }) &&
+                        needs_secret([&]() { MultisetAccumulator multiset(imported); }) &&
+                        needs_secret([&]() { imported.getSecretS(); }));
+
+        // 保存的状态也不能在无秘密的 setup 上恢复：P(s) 与摘要核对都需要 s
+        const std::string state_path = std::filesystem::temp_directory_path().string() + "/accumulator_test_ptau.state";
+        ExpressiveAccumulator saved(setup, G1_TYPE);
+        for (int el : {3, 1, 4}) saved.addElement(el);
+        saved.save(state_path);
+        printTestResult("无秘密的导入 setup 拒绝加载保存的状态",
+                        needs_secret([&]() { ExpressiveAccumulator::load(state_path, imported); }) &&
+                        ExpressiveAccumulator::load(state_path, setup)->getDigest() == saved.getDigest());
+        std::remove(state_path.c_str());
+    } catch (const std::exception& e) {
+        std::cout << "调试: 仪式文件导入失败: " << e.what() << std::endl;
+        printTestResult("导入仪式文件", false);
+    }
+
+    // 损坏的文件：清除一个 G2 点的压缩标志；截断的文件
+    auto rejected = [](const std::string& path, const PtauImportOptions& options) {
+        try {
+            ExpressiveTrustedSetup::importPowersOfTau(path, options);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    PtauImportOptions options;
+    options.format = PtauFormat::POWERSOFTAU_RESPONSE;
+    options.ceremony_power = power;
+    std::string corrupted = response;
+    corrupted[g2_offset + 3 * PowersOfTau::G2_COMPRESSED_BYTES] &= 0x7F;
+    writeFile(response_path, corrupted);
+    bool corrupt_ok = rejected(response_path, options);
+    writeFile(response_path, response.substr(0, response.size() - 1));
+    corrupt_ok = corrupt_ok && rejected(response_path, options);
+    writeFile(ptau_path, "ptaX" + ptau.substr(4));
+    corrupt_ok = corrupt_ok && rejected(ptau_path, PtauImportOptions());
+    printTestResult("拒绝损坏或截断的仪式文件", corrupt_ok);
+
+    std::remove(response_path.c_str());
+    std::remove(ptau_path.c_str());
+    std::cout << std::endl;
+}
+
+void test_witness_store(const ExpressiveTrustedSetup& setup) {
+    const std::string path = std::filesystem::temp_directory_path().string() + "/accumulator_test.witnesses";
+
+    ExpressiveAccumulator acc(setup, G1_TYPE);
+    for (int el = 1; el <= 300; ++el) acc.addElement(el * 7 - 1000);
+    bool ok = WitnessStore::freeze(acc, path, 2) == acc.getElements().size();
+    WitnessStore store(path);
+    ok = ok && store.size() == acc.getElements().size() && store.digest() == acc.getDigest();
+    for (int el : acc.getElements()) {
+        MembershipProof proof;
+        ok = ok && store.lookup(el, proof) && proof.is_member &&
+             proof.witness_g2 == acc.generateMembershipProof(el).witness_g2 &&
+             ExpressiveAccumulator::verifyMembershipProof(store.digest(), el, proof, setup);
+        if (!ok) break;
+    }
+    printTestResult("冻结见证库：全部成员一次探测命中且可验证", ok);
+
+    // 非成员查不到；重新冻结原子替换文件，已打开的库仍读取旧内容
+    MembershipProof missing;
+    ok = !store.lookup(-999, missing) && !store.lookup(0, missing) && !missing.is_member;
+    acc.addElement(-999);
+    WitnessStore::freeze(acc, path);
+    WitnessStore refreshed(path);
+    ok = ok && refreshed.lookup(-999, missing) && !store.lookup(-999, missing) && store.size() + 1 == refreshed.size();
+    ExpressiveAccumulator empty(setup, G1_TYPE);
+    WitnessStore::freeze(empty, path);
+    ok = ok && WitnessStore(path).size() == 0 && !WitnessStore(path).lookup(1, missing);
+    printTestResult("冻结见证库：非成员、重新冻结与空集合", ok);
+
+    // 截断或格式不符的文件被拒绝
+    WitnessStore::freeze(acc, path);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    bool rejected = false;
+    try {
+        WitnessStore truncated(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    {
+        std::fstream corrupt(path, std::ios::in | std::ios::out | std::ios::binary);
+        corrupt.seekp(0);
+        corrupt.put('X');
+    }
+    try {
+        WitnessStore bad_magic(path);
+        rejected = false;
+    } catch (const std::runtime_error&) {
+    }
+    printTestResult("冻结见证库：拒绝截断或损坏的文件", rejected);
+
+    // 记录本身被篡改：打开时的 CRC 校验即拒绝，包括解码后仍像合法坐标的改动
+    ExpressiveAccumulator single(setup, G1_TYPE);
+    single.addElement(42);
+    auto open_rejected = [&](size_t offset_in_record, char byte) {
+        WitnessStore::freeze(single, path);
+        const size_t record_offset = std::filesystem::file_size(path) - (8 + 4 * 48);
+        {
+            std::fstream corrupt(path, std::ios::in | std::ios::out | std::ios::binary);
+            corrupt.seekp(static_cast<std::streamoff>(record_offset + offset_in_record));
+            corrupt.put(byte);
+        }
+        try {
+            WitnessStore store(path);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    bool record_rejected = open_rejected(4, 2) && open_rejected(8 + 47, '\xFF') && open_rejected(8, '\x5A');
+    printTestResult("冻结见证库：拒绝损坏的见证记录", record_rejected);
+    std::remove(path.c_str());
+    std::cout << std::endl;
+}
+
+void test_accumulator_persistence(const Fr& secret_s, const Fr& secret_r) {
+    const std::string path = std::filesystem::temp_directory_path().string() + "/accumulator_test.state";
+    // 独立的 setup：大集合触发的后台扩展不影响其他测试
+    ExpressiveTrustedSetup setup(secret_s, secret_r, 20);
+    setup.generatePowers();
+
+    // 超过一块的集合，含极端元素与大跨度差分；加载后摘要、证明与后续增删都与原累加器一致
+    ExpressiveAccumulator acc(setup, G1_TYPE);
+    for (int el = 0; el < static_cast<int>(ExpressiveAccumulator::PERSIST_BLOCK) + 500; ++el) acc.addElement(el * 3 - 5000);
+    acc.addElement(INT_MIN);
+    acc.addElement(INT_MAX);
+    acc.save(path, false, 2);
+    std::unique_ptr<ExpressiveAccumulator> loaded = ExpressiveAccumulator::load(path, setup, 3);
+    bool ok = loaded->getElements() == acc.getElements() && loaded->getDigest() == acc.getDigest() &&
+              loaded->generateMembershipProof(INT_MAX).witness_g2 == acc.generateMembershipProof(INT_MAX).witness_g2;
+    acc.addElement(1);
+    loaded->addElement(1);
+    acc.deleteElement(-5000);
+    loaded->deleteElement(-5000);
+    ok = ok && loaded->getDigest() == acc.getDigest();
+    printTestResult("累加器状态保存与并行加载 (多块)", ok);
+
+    // G2 累加器与系数形式
+    ExpressiveAccumulator acc_g2(setup, G2_TYPE);
+    for (int el : {-7, 3, 11, 400}) acc_g2.addElement(el);
+    acc_g2.save(path, true);
+    std::vector<Fr> coeffs;
+    loaded = ExpressiveAccumulator::load(path, setup, 0, &coeffs);
+    ok = loaded->getGroupType() == G2_TYPE && loaded->getDigestG2().value == acc_g2.getDigestG2().value &&
+         coeffs == FrPolynomial::fromRoots(acc_g2.getElements());
+    ExpressiveAccumulator empty(setup, G1_TYPE);
+    empty.save(path);
+    loaded = ExpressiveAccumulator::load(path, setup, 0, &coeffs);
+    ok = ok && loaded->getElements().empty() && loaded->getDigest() == empty.getDigest() && coeffs.empty();
+    printTestResult("累加器状态保存与加载 (G2、系数形式、空集合)", ok);
+
+    // 截断、损坏或属于其他 setup 的文件被拒绝
+    acc_g2.save(path);
+    Fr other_s, other_r;
+    other_s.setHashOf("persistence/other_s");
+    other_r.setHashOf("persistence/other_r");
+    ExpressiveTrustedSetup other(other_s, other_r, 20);
+    other.generatePowers();
+    int rejected = 0;
+    try {
+        ExpressiveAccumulator::load(path, other);
+    } catch (const std::runtime_error&) {
+        ++rejected;
+    }
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+    try {
+        ExpressiveAccumulator::load(path, setup);
+    } catch (const std::runtime_error&) {
+        ++rejected;
+    }
+    printTestResult("累加器状态加载：拒绝截断或不匹配的文件", rejected == 2);
+    std::remove(path.c_str());
+    std::cout << std::endl;
+}
+
+void test_write_ahead_log(const Fr& secret_s, const Fr& secret_r) {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "accumulator_test.wal";
+    std::filesystem::remove_all(dir);
+    ExpressiveTrustedSetup setup(secret_s, secret_r, 20);
+    setup.generatePowers();
+    WalOptions options;
+    options.checkpoint_bytes = 0;
+    options.log_proofs = true;
+
+    // 重新打开后按元素合并、批量回放日志，状态与逐个操作的参照累加器一致
+    ExpressiveAccumulator reference(setup, G1_TYPE);
+    bool ok = true;
+    {
+        std::unique_ptr<WriteAheadLog> wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+        for (int el = 0; el < 40; ++el) {
+            wal->addElement(el * 5);
+            reference.addElement(el * 5);
+        }
+        for (int el : {0, 25, 190, 999}) {
+            wal->deleteElement(el);
+            reference.deleteElement(el);
+        }
+        wal->addElement(25);
+        reference.addElement(25);
+        ok = wal->digest() == reference.getDigest() && wal->durableLsn() == 44;
+    }
+    std::vector<WalRecord> records = WriteAheadLog::scan(dir.string());
+    ok = ok && records.size() == 44 && records.back().has_proof &&
+         ExpressiveAccumulator::verifyUpdateProof(records[40].proof, setup);
+    std::unique_ptr<WriteAheadLog> wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+    ok = ok && wal->digest() == reference.getDigest() && wal->stats().replayed == 44 && wal->durableLsn() == 44;
+    printTestResult("预写日志：重新打开后批量回放恢复状态", ok);
+
+    // 并发写者共享落盘批次
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&wal, t]() {
+            for (int i = 0; i < 25; ++i) wal->addElement(1000 + t * 100 + i);
+        });
+    }
+    for (auto& th : writers) th.join();
+    for (int t = 0; t < 4; ++t) {
+        for (int i = 0; i < 25; ++i) reference.addElement(1000 + t * 100 + i);
+    }
+    WalStats stats = wal->stats();
+    ok = wal->digest() == reference.getDigest() && stats.records == 100 && stats.group_commits <= stats.records &&
+         stats.syncs == stats.group_commits && wal->durableLsn() == 144;
+    printTestResult("预写日志：并发写者的组提交", ok);
+
+    // 检查点：脏元素少时写增量，多时写完整快照；检查点后的操作仍由日志恢复
+    wal->checkpoint();
+    ok = wal->stats().full_snapshots == 1 && WriteAheadLog::scan(dir.string()).empty();
+    wal->deleteElement(5);
+    reference.deleteElement(5);
+    wal->checkpoint();
+    ok = ok && wal->stats().checkpoints == 2 && wal->stats().full_snapshots == 1;
+    wal->addElement(-3);
+    reference.addElement(-3);
+    wal.reset();
+    wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+    ok = ok && wal->digest() == reference.getDigest() && wal->stats().replayed == 1 && wal->durableLsn() == 146;
+    printTestResult("预写日志：增量与完整检查点", ok);
+
+    // 崩溃时写了一半的记录被截掉，之后的写入继续有效
+    wal->addElement(-4);
+    reference.addElement(-4);
+    wal.reset();
+    const std::filesystem::path log_path = dir / "wal.log";
+    std::filesystem::resize_file(log_path, std::filesystem::file_size(log_path) - 3);
+    reference.deleteElement(-4);
+    wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+    ok = wal->digest() == reference.getDigest() && !wal->contains(-4) && wal->durableLsn() == 146;
+    wal->addElement(-6);
+    reference.addElement(-6);
+    wal.reset();
+    wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+    ok = ok && wal->digest() == reference.getDigest() && wal->durableLsn() == 147;
+    printTestResult("预写日志：截断不完整的尾部记录", ok);
+
+    // 日志超过阈值时自动检查点
+    wal.reset();
+    options.checkpoint_bytes = 256;
+    options.log_proofs = false;
+    wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+    for (int el = 2000; el < 2030; ++el) {
+        wal->addElement(el);
+        reference.addElement(el);
+    }
+    ok = wal->stats().checkpoints > 0 && wal->digest() == reference.getDigest();
+    wal.reset();
+    wal = WriteAheadLog::open(dir.string(), setup, G1_TYPE, options);
+    ok = ok && wal->digest() == reference.getDigest() && wal->size() == reference.getElements().size();
+    printTestResult("预写日志：按日志大小自动检查点", ok);
+    wal.reset();
+    std::filesystem::remove_all(dir);
+    std::cout << std::endl;
+}
+
+void test_blinding(const Fr& secret_s, const Fr& secret_r) {
+    ExpressiveTrustedSetup setup(secret_s, secret_r, 20);
+    setup.generatePowers();
+    setup.generateBlindingPowers(4, 1);
+    ExpressiveAccumulator acc(setup, G1_TYPE);
+    for (int el : {3, 8, 15, 42}) acc.addElement(el);
+
+    // 盲化摘要与未盲化摘要、以及两次盲化之间都不同；盲化证明只对盲化摘要成立
+    Blinding blinding, other_blinding;
+    AccumulatorDigest blinded = acc.blindDigest(blinding);
+    AccumulatorDigest other = acc.blindDigest(other_blinding);
+    BlindedMembershipProof proof = acc.generateBlindedMembershipProof(8, blinding);
+    bool ok = !(blinded == acc.getDigest()) && !(blinded == other) && proof.openings.size() == 1 &&
+              ExpressiveAccumulator::verifyBlindedMembershipProof(blinded, 8, proof, setup) &&
+              !ExpressiveAccumulator::verifyBlindedMembershipProof(other, 8, proof, setup) &&
+              !ExpressiveAccumulator::verifyBlindedMembershipProof(acc.getDigest(), 8, proof, setup) &&
+              !ExpressiveAccumulator::verifyBlindedMembershipProof(blinded, 9, proof, setup) &&
+              !acc.generateBlindedMembershipProof(9, blinding).is_member;
+    for (int el : {3, 15, 42}) {
+        ok = ok && ExpressiveAccumulator::verifyBlindedMembershipProof(
+                       blinded, el, acc.generateBlindedMembershipProof(el, blinding), setup);
+    }
+    printTestResult("零知识盲化：盲化摘要与成员证明", ok);
+
+    // 多行 (r 的次数 > 1) 的二维幂次表与按项读取
+    setup.generateBlindingPowers(3, 2);
+    blinded = acc.blindDigest(blinding);
+    proof = acc.generateBlindedMembershipProof(42, blinding);
+    G1 expected;
+    G1::mul(expected, setup.getG1Generator(), secret_s * secret_s * secret_r * secret_r);
+    ok = proof.openings.size() == 2 && ExpressiveAccumulator::verifyBlindedMembershipProof(blinded, 42, proof, setup) &&
+         setup.getG1_sr_pow(Term2D(2, 2)) == expected && setup.getG1_sr_pow(Term2D(0, 0)) == setup.getG1Generator();
+    int rejected = 0;
+    try {
+        setup.getG2_sr_pow(Term2D(4, 1));
+    } catch (const std::out_of_range&) {
+        ++rejected;
+    }
+    try {
+        acc.generateBlindedMembershipProof(42, other_blinding);
+    } catch (const std::invalid_argument&) {
+        ++rejected;
+    }
+    try {
+        ExpressiveAccumulator acc_g2(setup, G2_TYPE);
+        acc_g2.blindDigest(blinding);
+    } catch (const std::logic_error&) {
+        ++rejected;
+    }
+    printTestResult("零知识盲化：二维幂次表与参数检查", ok && rejected == 3);
+    std::cout << std::endl;
+}
+
+void test_keyed_accumulator(const ExpressiveTrustedSetup& setup) {
+    // 直接编码与 int 累加器的摘要、证明互通
+    KeyedAccumulator<int, IntegerEncoding> keyed_int(setup);
+    ExpressiveAccumulator acc(setup, G1_TYPE);
+    for (int el : {-9, 4, 17, 250}) {
+        keyed_int.addElement(el);
+        acc.addElement(el);
+    }
+    keyed_int.deleteElement(4);
+    acc.deleteElement(4);
+    bool ok = keyed_int.getDigest() == acc.getDigest() && !keyed_int.addElement(17) &&
+              ExpressiveAccumulator::verifyMembershipProof(acc.getDigest(), -9, keyed_int.generateMembershipProof(-9), setup);
+    printTestResult("任意键累加器：直接编码与 int 累加器一致", ok);
+
+    // 字符串键：编码缓存、求值、系数形式与证明
+    KeyedAccumulator<std::string> keyed_str(setup);
+    const std::vector<std::string> keys = {"alpha", "beta", "gamma", "", std::string("\0x", 2)};
+    for (const std::string& key : keys) keyed_str.addElement(key);
+    G1 expected;
+    G1::mul(expected, setup.getG1Generator(), keyed_str.evaluate(setup.getSecretS()));
+    Fr z;
+    z.setHashOf("keyed/z");
+    ok = keyed_str.size() == keys.size() && *keyed_str.encoded("beta") == HashToField<std::string>()("beta") &&
+         keyed_str.encoded("delta") == nullptr && expected == keyed_str.getDigest().value &&
+         FrPolynomial::evaluate(keyed_str.coefficients(2), z) == keyed_str.evaluate(z);
+    std::vector<std::string> query = {"gamma", "delta", "alpha"};
+    std::vector<MembershipProof> proofs = keyed_str.generateMembershipProofs(query, 2);
+    ok = ok && proofs.size() == 3 && !proofs[1].is_member &&
+         KeyedAccumulator<std::string>::verifyMembershipProof(keyed_str.getDigest(), "gamma", proofs[0], setup) &&
+         KeyedAccumulator<std::string>::verifyMembershipProof(keyed_str.getDigest(), "alpha", proofs[2], setup) &&
+         !KeyedAccumulator<std::string>::verifyMembershipProof(keyed_str.getDigest(), "delta", proofs[0], setup) &&
+         proofs[0].witness_g2 == keyed_str.generateMembershipProof("gamma").witness_g2;
+    keyed_str.deleteElement("beta");
+    ok = ok && !keyed_str.contains("beta") &&
+         KeyedAccumulator<std::string>::verifyMembershipProof(keyed_str.getDigest(), "", keyed_str.generateMembershipProof(""), setup);
+    printTestResult("任意键累加器：字符串键的编码缓存与证明", ok);
+
+    // 64 位键：不同类型的相同比特不会得到相同编码
+    KeyedAccumulator<uint64_t> keyed_u64(setup);
+    keyed_u64.addElement(UINT64_MAX);
+    keyed_u64.addElement(1ULL << 40);
+    ok = !(HashToField<uint64_t>()(UINT64_MAX) == HashToField<int64_t>()(-1)) &&
+         KeyedAccumulator<uint64_t>::verifyMembershipProof(keyed_u64.getDigest(), UINT64_MAX,
+                                                           keyed_u64.generateMembershipProof(UINT64_MAX), setup);
+    printTestResult("任意键累加器：64 位键与类型域分离", ok);
+    std::cout << std::endl;
+}
+
+void test_multiset_accumulator(const ExpressiveTrustedSetup& setup) {
+    MultisetAccumulator multiset(setup);
+    multiset.addElement(7, 3);
+    multiset.addElement(11);
+    multiset.addElement(-2, 5);
+    multiset.addElement(7, 2);
+
+    // 摘要与逐个相乘 (s - x) 的结果一致
+    Fr expected_s = 1;
+    const Fr s = setup.getSecretS();
+    for (int i = 0; i < 5; ++i) expected_s *= (s - Fr(7)) * (s - Fr(-2));
+    expected_s *= s - Fr(11);
+    G1 expected;
+    G1::mul(expected, setup.getG1Generator(), expected_s);
+    bool ok = multiset.multiplicity(7) == 5 && multiset.distinctCount() == 3 && multiset.totalCount() == 11 &&
+              multiset.getDigest().value == expected && multiset.evaluate(s) == expected_s;
+    printTestResult("多重集累加器：按幂次维护的摘要", ok);
+
+    // 至少 k 次与恰好 k 次的重数证明
+    const AccumulatorDigest& digest = multiset.getDigest();
+    MultiplicityProof at_least = multiset.generateMultiplicityProof(7, 3);
+    MultiplicityProof exact = multiset.generateMultiplicityProof(7, 5, true);
+    MultiplicityProof forged = multiset.generateMultiplicityProof(7, 4);
+    forged.exact = true;
+    forged.remainder = 1;
+    forged.exact_witness_g2 = exact.exact_witness_g2;
+    ok = MultisetAccumulator::verifyMultiplicityProof(digest, 7, at_least, setup) &&
+         MultisetAccumulator::verifyMultiplicityProof(digest, 7, exact, setup) &&
+         MultisetAccumulator::verifyMultiplicityProof(digest, 11, multiset.generateMultiplicityProof(11, 1, true), setup) &&
+         !MultisetAccumulator::verifyMultiplicityProof(digest, 11, at_least, setup) &&
+         !MultisetAccumulator::verifyMultiplicityProof(digest, 7, forged, setup) &&
+         !multiset.generateMultiplicityProof(7, 6).is_valid &&
+         !multiset.generateMultiplicityProof(7, 4, true).is_valid;
+    printTestResult("多重集累加器：至少与恰好 k 次的重数证明", ok);
+
+    // 删除部分与全部重数
+    ok = !multiset.removeElement(11, 2) && multiset.removeElement(-2, 2) && multiset.multiplicity(-2) == 3 &&
+         multiset.removeElement(7, 5) && multiset.multiplicity(7) == 0;
+    expected_s = s - Fr(11);
+    for (int i = 0; i < 3; ++i) expected_s *= s - Fr(-2);
+    G1::mul(expected, setup.getG1Generator(), expected_s);
+    ok = ok && multiset.getDigest().value == expected && multiset.totalCount() == 4 &&
+         MultisetAccumulator::verifyMultiplicityProof(multiset.getDigest(), -2,
+                                                      multiset.generateMultiplicityProof(-2, 3, true), setup);
+    printTestResult("多重集累加器：减少重数与移除元素", ok);
+    std::cout << std::endl;
+}
+
+void test_multi_evaluate() {
+    std::set<int> elements;
+    for (int el = -50; el < 250; ++el) elements.insert(el * 7);
+    CharacteristicPolynomial poly(elements);
+
+    std::vector<Fr> points;
+    for (int j = 0; j < 200; ++j) {
+        Fr z;
+        z.setHashOf("multi_evaluate/" + std::to_string(j));
+        points.push_back(z);
+    }
+    points.push_back(Fr(21)); // 集合中的元素，值应为 0
+
+    std::vector<Fr> single_thread = poly.multiEvaluate(points, 1);
+    std::vector<Fr> multi_thread = poly.multiEvaluate(points, 4);
+    bool ok = single_thread.size() == points.size() && single_thread == multi_thread;
+    for (size_t j = 0; ok && j < points.size(); ++j) {
+        ok = (single_thread[j] == poly.evaluate(points[j]));
+    }
+    printTestResult("多点求值与逐点求值一致", ok && single_thread.back().isZero());
+    std::cout << std::endl;
+}
+
+void test_set_reconciliation(const ExpressiveTrustedSetup& setup) {
+    ExpressiveAccumulator replica_a(setup, G1_TYPE);
+    ExpressiveAccumulator replica_b(setup, G1_TYPE);
+    for (int el = 1; el <= 40; ++el) {
+        replica_a.addElement(el);
+        replica_b.addElement(el);
+    }
+    replica_a.deleteElement(7);
+    replica_a.addElement(-3);
+    replica_b.addElement(41);
+    replica_b.addElement(42);
+    replica_b.deleteElement(20);
+
+    // 对称差为 5，概要只含 max_difference + 1 个求值
+    ReconciliationSketch sketch = SetReconciliation::makeSketch(replica_b, 6);
+    ReconciliationResult result = SetReconciliation::reconcile(replica_a, sketch, replica_b.getDigest(), setup);
+    printSet("只在副本 B 中的元素", result.remote_only);
+    printSet("只在副本 A 中的元素", result.local_only);
+    printTestResult("协调出的对称差正确",
+                    result.success &&
+                    result.remote_only == std::set<int>({7, 41, 42}) &&
+                    result.local_only == std::set<int>({-3, 20}) &&
+                    result.remote_elements == replica_b.getElements());
+
+    ReconciliationSketch same = SetReconciliation::makeSketch(replica_a, 2);
+    ReconciliationResult identical = SetReconciliation::reconcile(replica_a, same, replica_a.getDigest(), setup);
+    printTestResult("相同副本的对称差为空",
+                    identical.success && identical.remote_only.empty() && identical.local_only.empty());
+
+    ReconciliationSketch small = SetReconciliation::makeSketch(replica_b, 2);
+    printTestResult("对称差超出概要容量时报告失败",
+                    !SetReconciliation::reconcile(replica_a, small, replica_b.getDigest(), setup).success);
+
+    // 差异只在一侧：分子与分母次数不等，插值矩阵两段列宽不同
+    ExpressiveAccumulator superset(setup, G1_TYPE);
+    for (int el : replica_a.getElements()) superset.addElement(el);
+    superset.addElement(100);
+    superset.addElement(101);
+    superset.addElement(102);
+    ReconciliationSketch one_sided = SetReconciliation::makeSketch(superset, 4);
+    ReconciliationResult grown = SetReconciliation::reconcile(replica_a, one_sided, superset.getDigest(), setup);
+    printTestResult("只有对端多出元素时协调正确",
+                    grown.success && grown.local_only.empty() &&
+                    grown.remote_only == std::set<int>({100, 101, 102}) &&
+                    grown.remote_elements == superset.getElements());
+
+    // 概要来自另一个集合，恢复出的集合与 B 公开的摘要不符
+    ExpressiveAccumulator forged(setup, G1_TYPE);
+    for (int el : replica_b.getElements()) forged.addElement(el);
+    forged.addElement(43);
+    ReconciliationSketch forged_sketch = SetReconciliation::makeSketch(forged, 6);
+    printTestResult("拒绝与摘要不符的概要",
+                    !SetReconciliation::reconcile(replica_a, forged_sketch, replica_b.getDigest(), setup).success);
+    std::cout << std::endl;
+}
+
 void test_all() {
     // 初始化 MCL 库
     mcl::bn::initPairing(mcl::BLS12_381);
@@ -127,6 +1459,9 @@ void test_all() {
     // 测试一个存在的成员
     int member_element = 5;
     test_membership_proof(setup, acc_a, member_element, 6);
+    test_batch_membership_proof(setup, acc_a, {1, 3, 5, 9}, {1, 3, 6});
+    test_membership_proofs(setup, acc_a);
+    test_cross_membership_proof(setup);
     
     // 6. 集合交集证明测试 (精确验证模型)
     std::cout << "--- 6. 集合交集证明测试 (精确验证模型) ---" << std::endl;
@@ -170,6 +1505,40 @@ void test_all() {
         return;
     }
     std::cout << std::endl;
+
+    // 7. 常驻交集查询测试
+    std::cout << "--- 7. 常驻交集查询测试 ---" << std::endl;
+    test_standing_intersection(setup);
+
+    // 8. 证明查询引擎测试
+    std::cout << "--- 8. 证明查询引擎测试 ---" << std::endl;
+    test_query_engine(setup);
+
+    // 9. 门限查询测试
+    std::cout << "--- 9. 门限 (t-of-k) 查询测试 ---" << std::endl;
+    test_threshold_query(setup);
+
+    // 10. 多项式运算与副本间集合协调测试
+    std::cout << "--- 10. 多项式运算与副本间集合协调测试 ---" << std::endl;
+    test_ntt_polynomial_arithmetic();
+    test_fr_simd_kernels();
+    test_batch_inversion(setup);
+    test_pairing_cache(setup);
+    test_affine_msm(secret_s, secret_r);
+    test_power_storage(secret_s, secret_r);
+    test_table_placement(secret_s, secret_r);
+    test_precomputed_msm(secret_s, secret_r);
+    test_growable_setup(secret_s, secret_r);
+    test_validate_setup(setup, secret_s, secret_r);
+    test_powers_of_tau_import(setup);
+    test_witness_store(setup);
+    test_accumulator_persistence(secret_s, secret_r);
+    test_write_ahead_log(secret_s, secret_r);
+    test_blinding(secret_s, secret_r);
+    test_keyed_accumulator(setup);
+    test_multiset_accumulator(setup);
+    test_multi_evaluate();
+    test_set_reconciliation(setup);
     
     std::cout << "--- 所有测试已完成 ---" << std::endl;
 }
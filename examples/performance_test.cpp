@@ -3,7 +3,21 @@
 #include <vector>
 #include <chrono>
 #include <functional> // 需要包含 functional 头文件
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <thread>
 #include "../include/expressive_accumulator.h"
+#include "../include/standing_intersection.h"
+#include "../include/set_reconciliation.h"
+#include "../include/fr_simd.h"
+#include "../include/batch_inversion.h"
+#include "../include/fr_polynomial.h"
+#include "../include/powers_of_tau.h"
+#include "../include/witness_store.h"
+#include "../include/write_ahead_log.h"
+#include "../include/keyed_accumulator.h"
+#include "../include/multiset_accumulator.h"
 extern "C" {
 #include <flint/flint.h>
 #include <flint/fmpz.h>
@@ -89,6 +103,200 @@ int main() {
             }
         });
 
+        // 零知识盲化：盲化摘要与盲化证明只比未盲化版本多一次小规模的定基多标量乘法
+        setup.generateBlindingPowers();
+        Blinding blinding;
+        AccumulatorDigest blinded_digest;
+        run_benchmark("blindDigest", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) blinded_digest = acc_prove.blindDigest(blinding);
+        });
+        run_benchmark("generateBlindedMembershipProof", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) acc_prove.generateBlindedMembershipProof(i, blinding);
+        });
+        auto blinded_proof = acc_prove.generateBlindedMembershipProof(0, blinding);
+        run_benchmark("verifyBlindedMembershipProof", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) {
+                volatile bool result =
+                    ExpressiveAccumulator::verifyBlindedMembershipProof(blinded_digest, 0, blinded_proof, setup);
+                (void)result;
+            }
+        });
+
+        // 字符串键：编码在加入时缓存，乘积树展开不再逐个哈希
+        KeyedAccumulator<std::string> keyed_acc(setup);
+        std::vector<std::string> keyed_keys;
+        for (int i = 0; i < NUM_OPS; ++i) keyed_keys.push_back("document/" + std::to_string(i));
+        run_benchmark("KeyedAccumulator<std::string>::addElement", NUM_OPS, [&]() {
+            for (const std::string& key : keyed_keys) keyed_acc.addElement(key);
+        });
+        run_benchmark("KeyedAccumulator::coefficients (cached encodings)", 1, [&]() {
+            auto coeffs = keyed_acc.coefficients();
+            (void)coeffs;
+        });
+        run_benchmark("fromRoots (hashing every key)", 1, [&]() {
+            std::vector<Fr> roots;
+            for (const std::string& key : keyed_keys) roots.push_back(HashToField<std::string>()(key));
+            auto coeffs = FrPolynomial::fromRoots(roots, 0);
+            (void)coeffs;
+        });
+        run_benchmark("KeyedAccumulator::generateMembershipProofs", NUM_OPS, [&]() {
+            auto proofs = keyed_acc.generateMembershipProofs(keyed_keys);
+            (void)proofs;
+        });
+
+        // 多重集：(s - x)^k 以一次幂运算计算，与重数无关
+        MultisetAccumulator multiset(setup);
+        run_benchmark("MultisetAccumulator::addElement (multiplicity 1000)", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) multiset.addElement(i, 1000);
+        });
+        run_benchmark("MultisetAccumulator::generateMultiplicityProof (exact)", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) multiset.generateMultiplicityProof(i, 1000, true);
+        });
+        auto multiplicity_proof = multiset.generateMultiplicityProof(0, 1000, true);
+        run_benchmark("MultisetAccumulator::verifyMultiplicityProof (exact)", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) {
+                volatile bool result = MultisetAccumulator::verifyMultiplicityProof(
+                    multiset.getDigest(), 0, multiplicity_proof, setup);
+                (void)result;
+            }
+        });
+
+        std::vector<int> batch_elements;
+        for (int i = 0; i < NUM_OPS; ++i) batch_elements.push_back(i);
+
+        run_benchmark("generateMembershipProofs (" + std::to_string(NUM_OPS) + " elements, batch inversion)", NUM_OPS, [&]() {
+            auto proofs = acc_prove.generateMembershipProofs(batch_elements);
+            (void)proofs;
+        });
+
+        // 冻结的见证库：一次哈希探测加一次拷贝
+        const std::string witness_path = std::filesystem::temp_directory_path().string() + "/perf_test.witnesses";
+        run_benchmark("WitnessStore::freeze (" + std::to_string(acc_prove.getElements().size()) + " members)", 1, [&]() {
+            WitnessStore::freeze(acc_prove, witness_path);
+        });
+        {
+            WitnessStore witness_store(witness_path);
+            run_benchmark("WitnessStore::lookup", NUM_OPS, [&]() {
+                MembershipProof proof;
+                for (int i = 0; i < NUM_OPS; ++i) witness_store.lookup(i, proof);
+            });
+        }
+        std::remove(witness_path.c_str());
+
+        // 重启恢复：逐个重放 addElement vs 保存的二进制状态并行加载
+        const std::string state_path = std::filesystem::temp_directory_path().string() + "/perf_test.state";
+        run_benchmark("replay addElement (" + std::to_string(acc_prove.getElements().size()) + " elements)", 1, [&]() {
+            ExpressiveAccumulator replayed(setup, G1_TYPE);
+            for (int el : acc_prove.getElements()) replayed.addElement(el);
+        });
+        run_benchmark("ExpressiveAccumulator::save", 1, [&]() { acc_prove.save(state_path); });
+        run_benchmark("ExpressiveAccumulator::load (mmap + parallel decode)", 1, [&]() {
+            auto restored = ExpressiveAccumulator::load(state_path, setup);
+        });
+
+        // 1000 万元素的状态：目标是 1 秒内加载完成。
+        // 关闭后台扩展，避免 reserveDegree 把幂次表扩展到千万次；测得的是解码、P(s)、建集合与摘要核对的代价
+        {
+            const int BULK_SIZE = 10000000;
+            ExpressiveTrustedSetup bulk_setup(secret_s, secret_r, 16);
+            bulk_setup.generatePowers();
+            bulk_setup.setBackgroundExtension(false);
+            std::vector<int> bulk_elements(BULK_SIZE);
+            for (int i = 0; i < BULK_SIZE; ++i) bulk_elements[i] = 3 * i - BULK_SIZE;
+            {
+                ExpressiveAccumulator bulk(bulk_setup, G1_TYPE);
+                bulk.applyUpdates(bulk_elements, {});
+                bulk.save(state_path);
+            }
+            bulk_elements = std::vector<int>();
+            run_benchmark("ExpressiveAccumulator::load (" + std::to_string(BULK_SIZE) + " elements, target < 1 s)", 1, [&]() {
+                auto restored = ExpressiveAccumulator::load(state_path, bulk_setup);
+            });
+        }
+        std::remove(state_path.c_str());
+
+        // 预写日志：单写者每次操作一次 fdatasync vs 并发写者组提交 vs 不落盘
+        const std::filesystem::path wal_dir = std::filesystem::temp_directory_path() / "perf_test.wal";
+        auto run_wal = [&](const std::string& name, int num_writers, bool sync) {
+            std::filesystem::remove_all(wal_dir);
+            WalOptions options;
+            options.sync = sync;
+            auto wal = WriteAheadLog::open(wal_dir.string(), setup, G1_TYPE, options);
+            run_benchmark(name, NUM_OPS, [&]() {
+                std::vector<std::thread> writers;
+                for (int t = 0; t < num_writers; ++t) {
+                    writers.emplace_back([&, t]() {
+                        for (int i = t; i < NUM_OPS; i += num_writers) wal->addElement(-1 - i);
+                    });
+                }
+                for (auto& th : writers) th.join();
+            });
+            WalStats stats = wal->stats();
+            std::cout << "    records: " << stats.records << ", group commits: " << stats.group_commits << std::endl;
+        };
+        run_wal("WriteAheadLog::addElement (1 writer, fdatasync)", 1, true);
+        run_wal("WriteAheadLog::addElement (4 writers, group commit)", 4, true);
+        run_wal("WriteAheadLog::addElement (1 writer, no sync)", 1, false);
+        std::filesystem::remove_all(wal_dir);
+
+        run_benchmark("generateBatchMembershipProof (" + std::to_string(NUM_OPS) + " elements)", 1, [&]() {
+            acc_prove.generateBatchMembershipProof(batch_elements);
+        });
+
+        auto batch_proof = acc_prove.generateBatchMembershipProof(batch_elements);
+        run_benchmark("verifyBatchMembershipProof (" + std::to_string(NUM_OPS) + " elements)", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) {
+                volatile bool result = ExpressiveAccumulator::verifyBatchMembershipProof(
+                    acc_prove.getDigest(), batch_elements, batch_proof, setup);
+                (void)result;
+            }
+        });
+
+        // 同一元素跨多个累加器：逐个验证 vs 聚合验证
+        const int NUM_BLOCKS = 20;
+        std::vector<std::unique_ptr<ExpressiveAccumulator>> blocks;
+        std::vector<const ExpressiveAccumulator*> block_ptrs;
+        std::vector<AccumulatorDigest> block_digests;
+        for (int b = 0; b < NUM_BLOCKS; ++b) {
+            blocks.push_back(std::make_unique<ExpressiveAccumulator>(setup, G1_TYPE));
+            for (int i = 0; i < 100; ++i) blocks.back()->addElement(b * 1000 + i);
+            blocks.back()->addElement(-1);
+            block_ptrs.push_back(blocks.back().get());
+            block_digests.push_back(blocks.back()->getDigest());
+        }
+
+        run_benchmark("verifyMembershipProof x " + std::to_string(NUM_BLOCKS) + " blocks", 1, [&]() {
+            for (int b = 0; b < NUM_BLOCKS; ++b) {
+                auto proof = blocks[b]->generateMembershipProof(-1);
+                volatile bool result = ExpressiveAccumulator::verifyMembershipProof(block_digests[b], -1, proof, setup);
+                (void)result;
+            }
+        });
+
+        auto cross_proof = ExpressiveAccumulator::generateCrossMembershipProof(block_ptrs, -1, setup);
+        run_benchmark("verifyCrossMembershipProof (" + std::to_string(NUM_BLOCKS) + " blocks)", 1, [&]() {
+            volatile bool result = ExpressiveAccumulator::verifyCrossMembershipProof(block_digests, -1, cross_proof, setup);
+            (void)result;
+        });
+
+        // 同一个热点摘要上的大量成员证明：关闭 vs 开启配对缓存
+        std::vector<MembershipProof> hot_proofs = acc_prove.generateMembershipProofs(batch_elements);
+        for (size_t capacity : {size_t(0), PairingCache::DEFAULT_CAPACITY}) {
+            setup.pairingCache().clear();
+            setup.pairingCache().setCapacity(capacity);
+            run_benchmark(std::string("verifyMembershipProof, hot digest (pairing cache ") +
+                              (capacity == 0 ? "off" : "on") + ")", NUM_OPS, [&]() {
+                for (int i = 0; i < NUM_OPS; ++i) {
+                    volatile bool result = ExpressiveAccumulator::verifyMembershipProof(
+                        acc_prove.getDigest(), batch_elements[i], hot_proofs[i], setup);
+                    (void)result;
+                }
+            });
+            PairingCacheStats cache_stats = setup.pairingCache().stats();
+            std::cout << "  pairing cache: " << cache_stats.hits << " hits, " << cache_stats.misses << " misses"
+                      << std::endl;
+        }
+
         // ============================================================
         // 4. 精心构造测试集合以确保有交集
         // ============================================================
@@ -144,6 +352,283 @@ int main() {
             }
         });
 
+        // ============================================================
+        // 6. Test Standing Intersection Query (incremental update)
+        // ============================================================
+        StandingIntersectionQuery standing_query(acc_prove, acc_b, setup);
+
+        run_benchmark("StandingIntersectionQuery update", NUM_OPS, [&]() {
+            // 交替地把 B 独有元素加入 A (进入交集) 再删除 (离开交集)
+            for (int i = 0; i < NUM_OPS; ++i) {
+                int el = INITIAL_SET_SIZE + i / 2;
+                if (i % 2 == 0) standing_query.addElement(QuerySide::A, el);
+                else standing_query.deleteElement(QuerySide::A, el);
+            }
+        });
+
+        // ============================================================
+        // 7. Test Multipoint Evaluation
+        // ============================================================
+        std::vector<Fr> eval_points(INITIAL_SET_SIZE);
+        for (size_t j = 0; j < eval_points.size(); ++j) {
+            eval_points[j].setHashOf("perf_multi_evaluate/" + std::to_string(j));
+        }
+        const CharacteristicPolynomial& prove_poly = acc_prove.getPolynomial();
+
+        run_benchmark("CharacteristicPolynomial::evaluate x " + std::to_string(eval_points.size()) + " points", 1, [&]() {
+            for (const Fr& z : eval_points) {
+                volatile bool zero = prove_poly.evaluate(z).isZero();
+                (void)zero;
+            }
+        });
+        run_benchmark("CharacteristicPolynomial::multiEvaluate (" + std::to_string(eval_points.size()) + " points)", 1, [&]() {
+            auto values = prove_poly.multiEvaluate(eval_points);
+            (void)values;
+        });
+
+        // ============================================================
+        // 8. Test Set Reconciliation (symmetric difference of 10)
+        // ============================================================
+        ExpressiveAccumulator replica(setup, G1_TYPE);
+        for (int el : acc_prove.getElements()) replica.addElement(el);
+        for (int i = 0; i < 5; ++i) {
+            replica.deleteElement(i);
+            replica.addElement(INITIAL_SET_SIZE + i);
+        }
+        const size_t MAX_DIFFERENCE = 10;
+        ReconciliationSketch sketch = SetReconciliation::makeSketch(replica, MAX_DIFFERENCE);
+
+        run_benchmark("SetReconciliation::reconcile (|A Δ B| = 10)", 1, [&]() {
+            auto reconciled = SetReconciliation::reconcile(acc_prove, sketch, replica.getDigest(), setup);
+            if (!reconciled.success) std::cerr << "集合协调失败" << std::endl;
+        });
+
+        // ============================================================
+        // 9. Test SIMD Fr Kernels (per backend)
+        // ============================================================
+        const size_t VEC_SIZE = 1 << 14;
+        std::vector<Fr> vec_x(VEC_SIZE, Fr(0)), vec_y(VEC_SIZE, Fr(0)), vec_z(VEC_SIZE, Fr(0));
+        for (size_t i = 0; i < VEC_SIZE; ++i) {
+            vec_x[i].setHashOf("perf_simd_x/" + std::to_string(i));
+            vec_y[i].setHashOf("perf_simd_y/" + std::to_string(i));
+        }
+        const FrSimd::Backend best_backend = FrSimd::activeBackend();
+        const FrSimd::Backend backends[] = {FrSimd::Backend::SCALAR, FrSimd::Backend::AVX2,
+                                            FrSimd::Backend::AVX512, FrSimd::Backend::AVX512_IFMA};
+        for (FrSimd::Backend backend : backends) {
+            if (!FrSimd::setBackend(backend)) continue;
+            const std::string tag = std::string(" [") + FrSimd::backendName(backend) + "]";
+            run_benchmark("FrSimd::mulVec" + tag, VEC_SIZE, [&]() {
+                FrSimd::mulVec(vec_z.data(), vec_x.data(), vec_y.data(), VEC_SIZE);
+            });
+            run_benchmark("FrSimd::product" + tag, VEC_SIZE, [&]() {
+                volatile bool zero = FrSimd::product(vec_x.data(), VEC_SIZE).isZero();
+                (void)zero;
+            });
+            run_benchmark("FrSimd::batchInvert" + tag, VEC_SIZE, [&]() {
+                vec_z = vec_y;
+                FrSimd::batchInvert(vec_z.data(), VEC_SIZE);
+            });
+            run_benchmark("CharacteristicPolynomial::evaluate" + tag, NUM_OPS, [&]() {
+                for (int i = 0; i < NUM_OPS; ++i) {
+                    volatile bool zero = prove_poly.evaluate(eval_points[i]).isZero();
+                    (void)zero;
+                }
+            });
+        }
+        FrSimd::setBackend(best_backend);
+
+        // ============================================================
+        // 10. Test Batch Inversion (vs. one inversion per element)
+        // ============================================================
+        std::vector<Fp> fp_values(VEC_SIZE, Fp(0));
+        for (size_t i = 0; i < VEC_SIZE; ++i) fp_values[i].setHashOf("perf_batch_inv/" + std::to_string(i));
+
+        run_benchmark("Fr::inv (one by one)", VEC_SIZE, [&]() {
+            for (size_t i = 0; i < VEC_SIZE; ++i) Fr::inv(vec_z[i], vec_y[i]);
+        });
+        run_benchmark("BatchInversion::invertParallel<Fr>", VEC_SIZE, [&]() {
+            vec_z = vec_y;
+            BatchInversion::invertParallel(vec_z);
+        });
+        run_benchmark("Fp::inv (one by one)", VEC_SIZE, [&]() {
+            for (size_t i = 0; i < VEC_SIZE; ++i) {
+                Fp inv;
+                Fp::inv(inv, fp_values[i]);
+            }
+        });
+        run_benchmark("BatchInversion::invertParallel<Fp>", VEC_SIZE, [&]() {
+            std::vector<Fp> inv = fp_values;
+            BatchInversion::invertParallel(inv);
+        });
+
+        const size_t SERIALIZE_COUNT = 1000;
+        std::vector<G2> witness_points(SERIALIZE_COUNT);
+        for (size_t i = 0; i < SERIALIZE_COUNT; ++i) {
+            G2::mul(witness_points[i], setup.getG2Generator(), Fr(static_cast<int64_t>(i + 1)));
+        }
+        run_benchmark("G2::getStr (one inversion per point)", SERIALIZE_COUNT, [&]() {
+            for (const G2& P : witness_points) P.getStr(mcl::IoSerialize);
+        });
+        run_benchmark("BatchInversion::serializePoints<G2>", SERIALIZE_COUNT, [&]() {
+            BatchInversion::serializePoints(witness_points.data(), witness_points.size());
+        });
+
+        // ============================================================
+        // 11. Test Power Table Storage (memory vs. commit throughput)
+        // ============================================================
+        std::vector<Fr> commit_coeffs = FrPolynomial::fromRoots(acc_prove.getElements());
+        const PowerStorage storages[] = {PowerStorage::JACOBIAN, PowerStorage::AFFINE, PowerStorage::COMPRESSED};
+        const char* storage_names[] = {"JACOBIAN", "AFFINE", "COMPRESSED"};
+        double jacobian_commit_us = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            ExpressiveTrustedSetup stored_setup(secret_s, secret_r, UNIVERSE_SIZE, storages[k]);
+            stored_setup.generatePowers();
+            std::cout << "\n  [Memory] power tables (" << storage_names[k] << "): "
+                      << stored_setup.powerTableBytes() / 1024.0 << " KiB" << std::endl;
+            auto commit_start = std::chrono::high_resolution_clock::now();
+            run_benchmark(std::string("commitG1 (") + storage_names[k] + ", degree " +
+                          std::to_string(commit_coeffs.size() - 1) + ")", 10, [&]() {
+                for (int i = 0; i < 10; ++i) {
+                    volatile bool zero = stored_setup.commitG1(commit_coeffs).isZero();
+                    (void)zero;
+                }
+            });
+            double commit_us = std::chrono::duration<double, std::micro>(
+                std::chrono::high_resolution_clock::now() - commit_start).count();
+            if (k == 0) jacobian_commit_us = commit_us;
+            std::cout << "    commit time vs JACOBIAN: " << commit_us / jacobian_commit_us << "x" << std::endl;
+        }
+
+        // ============================================================
+        // 12. Test On-Demand Setup Extension
+        // ============================================================
+        ExpressiveTrustedSetup growing_setup(secret_s, secret_r, UNIVERSE_SIZE);
+        growing_setup.generatePowers(INITIAL_SET_SIZE);
+        run_benchmark("ensureDegree (" + std::to_string(INITIAL_SET_SIZE) + " -> " +
+                      std::to_string(UNIVERSE_SIZE) + ", per power)", UNIVERSE_SIZE - INITIAL_SET_SIZE, [&]() {
+            growing_setup.ensureDegree(UNIVERSE_SIZE);
+        });
+        growing_setup.reserveDegree(4 * UNIVERSE_SIZE);
+        run_benchmark("getG1_s_pow during background extension", NUM_OPS * 100, [&]() {
+            for (int i = 0; i < NUM_OPS * 100; ++i) {
+                volatile bool zero = growing_setup.getG1_s_pow(i % UNIVERSE_SIZE).isZero();
+                (void)zero;
+            }
+        });
+        growing_setup.waitForExtension();
+
+        // ============================================================
+        // 13. Test Randomized Setup Validation (vs. pairwise pairings)
+        // ============================================================
+        run_benchmark("validateSetup (degree " + std::to_string(UNIVERSE_SIZE) + ")", 1, [&]() {
+            if (!setup.validateSetup()) std::cerr << "可信设置验证失败" << std::endl;
+        });
+        const G2 g2_s = setup.getG2_s_pow(1);
+        run_benchmark("pairwise check e(g1^{s^i}, g2^s) == e(g1^{s^{i+1}}, g2)", NUM_OPS, [&]() {
+            for (int i = 0; i < NUM_OPS; ++i) {
+                GT lhs, rhs;
+                pairing(lhs, setup.getG1_s_pow(i), g2_s);
+                pairing(rhs, setup.getG1_s_pow(i + 1), setup.getG2Generator());
+                if (lhs != rhs) std::cerr << "幂次关系不成立" << std::endl;
+            }
+        });
+
+        // ============================================================
+        // 14. Test Powers-of-Tau Import (single vs. multi-threaded decode)
+        // ============================================================
+        const size_t CEREMONY_POWER = 11;
+        const size_t TAU_POWERS = size_t(1) << CEREMONY_POWER;
+        const std::string ceremony_path = (std::filesystem::temp_directory_path() / "accumulator_bench.response").string();
+        {
+            std::ofstream out(ceremony_path, std::ios::binary);
+            const std::string hash(64, '\0');
+            out.write(hash.data(), hash.size());
+            uint8_t buf[PowersOfTau::G2_COMPRESSED_BYTES];
+            for (size_t i = 0; i < 2 * TAU_POWERS - 1; ++i) {
+                PowersOfTau::encodeG1(buf, setup.getG1_s_pow(static_cast<int>(i)));
+                out.write(reinterpret_cast<const char*>(buf), PowersOfTau::G1_COMPRESSED_BYTES);
+            }
+            for (size_t i = 0; i < TAU_POWERS; ++i) {
+                PowersOfTau::encodeG2(buf, setup.getG2_s_pow(static_cast<int>(i)));
+                out.write(reinterpret_cast<const char*>(buf), PowersOfTau::G2_COMPRESSED_BYTES);
+            }
+        }
+        PtauImportOptions import_options;
+        import_options.format = PtauFormat::POWERSOFTAU_RESPONSE;
+        import_options.ceremony_power = CEREMONY_POWER;
+        for (size_t threads : {size_t(1), size_t(0)}) {
+            import_options.num_threads = threads;
+            run_benchmark("importPowersOfTau (2^" + std::to_string(CEREMONY_POWER) + " powers, " +
+                          (threads == 1 ? std::string("1 thread") : std::string("all threads")) + ")",
+                          static_cast<int>(TAU_POWERS), [&]() {
+                auto imported = ExpressiveTrustedSetup::importPowersOfTau(ceremony_path, import_options);
+                if (imported->availableDegree() + 2 != TAU_POWERS) std::cerr << "导入的幂次数不符" << std::endl;
+            });
+        }
+        std::remove(ceremony_path.c_str());
+
+        // ============================================================
+        // 15. Test Precomputed Per-Base MSM Tables (vs. plain table MSM)
+        // ============================================================
+        ExpressiveTrustedSetup precomputed_setup(secret_s, secret_r, UNIVERSE_SIZE, PowerStorage::AFFINE);
+        precomputed_setup.generatePowers();
+        const std::string commit_degree = std::to_string(commit_coeffs.size() - 1);
+        run_benchmark("commitG1 (power table MSM, degree " + commit_degree + ")", 10, [&]() {
+            for (int i = 0; i < 10; ++i) {
+                volatile bool zero = precomputed_setup.commitG1(commit_coeffs).isZero();
+                (void)zero;
+            }
+        });
+        for (size_t window : {6, 8, 10}) {
+            run_benchmark("enablePrecomputation (window " + std::to_string(window) + ")", 1, [&]() {
+                precomputed_setup.enablePrecomputation(window);
+            });
+            std::cout << "\n  [Memory] precomputed tables (window " << window << "): "
+                      << precomputed_setup.precomputedBytes() / 1024.0 << " KiB" << std::endl;
+            run_benchmark("commitG1 (precomputed, window " + std::to_string(window) + ", degree " + commit_degree + ")", 10, [&]() {
+                for (int i = 0; i < 10; ++i) {
+                    volatile bool zero = precomputed_setup.commitG1(commit_coeffs).isZero();
+                    (void)zero;
+                }
+            });
+        }
+
+        // ============================================================
+        // 16. Test SoA Batched-Affine MSM (vs. block-wise mulVec)
+        // ============================================================
+        const size_t MSM_SIZE = 2 * PowerTable<G1>::BATCH_AFFINE_MIN_POINTS;
+        std::vector<Fr> msm_coeffs(MSM_SIZE);
+        for (auto& c : msm_coeffs) c.setByCSPRNG();
+        for (PowerStorage storage : {PowerStorage::JACOBIAN, PowerStorage::AFFINE}) {
+            ExpressiveTrustedSetup msm_setup(secret_s, secret_r, MSM_SIZE, storage);
+            msm_setup.generatePowers();
+            const std::string layout = storage == PowerStorage::AFFINE ? "AFFINE SoA, batched affine" : "JACOBIAN, mulVec";
+            run_benchmark("g1_s_powers.multiExp (" + layout + ", " + std::to_string(MSM_SIZE) + " points)", 1, [&]() {
+                G1 result;
+                msm_setup.g1_s_powers.multiExp(result, msm_coeffs.data(), MSM_SIZE);
+            });
+        }
+
+        // ============================================================
+        // 17. Test Huge-Page / NUMA Table Placement (vs. default 4 KiB pages)
+        // ============================================================
+        TablePlacement placements[3];
+        placements[1].huge_pages = HugePageMode::TRANSPARENT;
+        placements[2].huge_pages = HugePageMode::TRANSPARENT;
+        placements[2].numa_replicas = true;
+        const char* placement_names[] = {"4 KiB pages", "transparent huge pages", "THP + per-node replicas"};
+        for (size_t k = 0; k < 3; ++k) {
+            ExpressiveTrustedSetup placed_setup(secret_s, secret_r, MSM_SIZE, PowerStorage::AFFINE, placements[k]);
+            placed_setup.generatePowers();
+            run_benchmark(std::string("g1_s_powers.multiExp (") + placement_names[k] + ", " +
+                              std::to_string(placed_setup.g1_s_powers.replicaCount()) + " replica(s))",
+                          1, [&]() {
+                G1 result;
+                placed_setup.g1_s_powers.multiExp(result, msm_coeffs.data(), MSM_SIZE);
+            });
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "程序异常: " << e.what() << std::endl;
         return 1;
@@ -0,0 +1,351 @@
+#ifndef AFFINE_MSM_H
+#define AFFINE_MSM_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+#include "batch_inversion.h"
+#include "memory_placement.h"
+#include "scalar_digits.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+const size_t CACHE_LINE_BYTES = 64;
+
+/**
+ * @brief 按缓存行对齐的定长数组，用于结构体数组 (SoA) 形式的坐标存储。
+ */
+template <typename T>
+class AlignedArray {
+public:
+    AlignedArray() : data_(nullptr), size_(0) {}
+    explicit AlignedArray(size_t n) : data_(nullptr), size_(0) { reset(n); }
+    ~AlignedArray() { release(); }
+
+    AlignedArray(const AlignedArray&) = delete;
+    AlignedArray& operator=(const AlignedArray&) = delete;
+
+    // 重新分配 n 个默认构造的元素，原有内容丢弃
+    void reset(size_t n) {
+        release();
+        if (n == 0) return;
+        data_ = static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE_BYTES)));
+        for (size_t i = 0; i < n; ++i) new (data_ + i) T();
+        size_ = n;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+private:
+    void release() {
+        if (data_ == nullptr) return;
+        for (size_t i = 0; i < size_; ++i) data_[i].~T();
+        ::operator delete(data_, std::align_val_t(CACHE_LINE_BYTES));
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    T* data_;
+    size_t size_;
+};
+
+/**
+ * @brief 一段连续的仿射底点（x[]、y[] 分开存放）及其标量。
+ */
+template <typename Coord>
+struct AffineSpan {
+    const Coord* x;
+    const Coord* y;
+    const uint8_t* infinity; // 非零表示无穷远点
+    const Fr* coeffs;
+    size_t n;
+};
+
+/**
+ * @brief 同一组底点在某个 NUMA 节点上的一份副本，各副本的区间划分与标量相同。
+ */
+template <typename Coord>
+struct AffineReplica {
+    int node; // 负数表示不绑定
+    std::vector<AffineSpan<Coord>> spans;
+};
+
+/**
+ * @brief 批量仿射坐标的 Pippenger 多标量乘法。
+ * @details 桶以仿射坐标保存。每次点加 B += P 需要一次求逆 λ = (y_P - y_B)/(x_P - x_B)，
+ *          把最多 BATCH_SIZE 个互不冲突的桶的点加攒成一批，用 Montgomery 技巧一起求逆：
+ *          每次点加摊到约 6 次乘法，低于 Jacobian 混合点加的 11 次。
+ *          同一批中已出现的桶再次出现时推迟到下一批。
+ *          底点按 SoA 顺序扫描，桶坐标在入批时预取，累加阶段主要受内存带宽限制，
+ *          不再受一次次依赖的点加延迟限制。标量使用有符号窗口，桶数为 2^{c-1}。
+ */
+namespace AffineMsm {
+
+const size_t MIN_WINDOW = 3;
+// 数字矩阵以 int16_t 保存，|d| ≤ 2^{c-1} 要求 c ≤ 15
+const size_t MAX_WINDOW = 15;
+// 每批一起求逆的点加数
+const size_t BATCH_SIZE = 512;
+
+inline void prefetch(const void* p) {
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+// 按点数选取窗口宽度：约 log2(n) - 2
+inline size_t defaultWindow(size_t n) {
+    size_t lg = 0;
+    while (lg < 63 && (size_t(1) << (lg + 1)) <= n) ++lg;
+    return std::min(MAX_WINDOW, std::max(MIN_WINDOW, lg > 2 ? lg - 2 : 0));
+}
+
+/**
+ * @brief 一个窗口的仿射桶，点加按批执行。
+ */
+template <typename G>
+class Buckets {
+public:
+    typedef typename G::Fp Coord;
+
+    explicit Buckets(size_t count) : x_(count), y_(count), filled_(count, 0), mark_(count, 0), epoch_(1) {
+        batch_.reserve(BATCH_SIZE);
+    }
+
+    void clear() { std::fill(filled_.begin(), filled_.end(), 0); }
+
+    // B_b += (x, ±y)；实际计算推迟到批满或 finish
+    void add(size_t b, const Coord* x, const Coord* y, bool negate) {
+        if (mark_[b] == epoch_) {
+            deferred_.push_back(Op{b, x, y, negate});
+            return;
+        }
+        mark_[b] = epoch_;
+        prefetch(&x_[b]);
+        prefetch(&y_[b]);
+        batch_.push_back(Op{b, x, y, negate});
+        if (batch_.size() == BATCH_SIZE) flush();
+    }
+
+    // 执行所有待处理和被推迟的点加
+    void finish() {
+        flush();
+        while (!deferred_.empty()) {
+            pending_.swap(deferred_);
+            deferred_.clear();
+            for (const Op& op : pending_) add(op.bucket, op.x, op.y, op.negate);
+            flush();
+        }
+    }
+
+    // out = Σ_b (b + 1)·B_b，前缀和只用 2·count 次点加
+    void reduce(G& out) const {
+        G running, sum, P;
+        running.clear();
+        sum.clear();
+        for (size_t b = filled_.size(); b-- > 0;) {
+            if (filled_[b]) {
+                P.x = x_[b];
+                P.y = y_[b];
+                P.z = 1;
+                running += P;
+            }
+            sum += running;
+        }
+        out = sum;
+    }
+
+private:
+    struct Op {
+        size_t bucket;
+        const Coord* x;
+        const Coord* y;
+        bool negate;
+    };
+
+    void flush() {
+        const size_t k = batch_.size();
+        if (k == 0) return;
+        num_.resize(k);
+        den_.resize(k);
+        py_.resize(k);
+        // 第一遍：求出每个点加的分子和分母；空桶直接放入，P + (-P) 清空，分母记为零
+        for (size_t t = 0; t < k; ++t) {
+            const Op& op = batch_[t];
+            const size_t b = op.bucket;
+            py_[t] = *op.y;
+            if (op.negate) Coord::neg(py_[t], py_[t]);
+            den_[t].clear();
+            if (!filled_[b]) {
+                x_[b] = *op.x;
+                y_[b] = py_[t];
+                filled_[b] = 1;
+            } else if (x_[b] == *op.x) {
+                if (y_[b] == py_[t]) {
+                    // 倍点：λ = 3x^2 / 2y
+                    Coord::sqr(num_[t], x_[b]);
+                    Coord::add(den_[t], num_[t], num_[t]);
+                    Coord::add(num_[t], den_[t], num_[t]);
+                    Coord::add(den_[t], y_[b], y_[b]);
+                } else {
+                    filled_[b] = 0;
+                }
+            } else {
+                Coord::sub(num_[t], py_[t], y_[b]);
+                Coord::sub(den_[t], *op.x, x_[b]);
+            }
+        }
+        BatchInversion::invert(den_.data(), k, prefix_);
+        // 第二遍：x3 = λ^2 - x_B - x_P，y3 = λ(x_B - x3) - y_B
+        Coord lambda, x3, t0;
+        for (size_t t = 0; t < k; ++t) {
+            if (den_[t].isZero()) continue;
+            const Op& op = batch_[t];
+            Coord& bx = x_[op.bucket];
+            Coord& by = y_[op.bucket];
+            Coord::mul(lambda, num_[t], den_[t]);
+            Coord::sqr(x3, lambda);
+            Coord::sub(x3, x3, bx);
+            Coord::sub(x3, x3, *op.x);
+            Coord::sub(t0, bx, x3);
+            Coord::mul(t0, t0, lambda);
+            Coord::sub(by, t0, by);
+            bx = x3;
+        }
+        batch_.clear();
+        if (++epoch_ == 0) {
+            std::fill(mark_.begin(), mark_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    AlignedArray<Coord> x_, y_;
+    std::vector<uint8_t> filled_;
+    std::vector<uint32_t> mark_; // 桶在当前批次中出现过时等于 epoch_
+    uint32_t epoch_;
+    std::vector<Op> batch_, deferred_, pending_;
+    std::vector<Coord> num_, den_, py_, prefix_;
+};
+
+/**
+ * @brief out = Σ coeffs·P，底点与标量由若干 AffineSpan 给出。
+ * @details 标量先并行编码为按窗口主序存放的数字矩阵（n·⌈256/c⌉ 个 int16_t），
+ *          随后各线程轮流领取窗口，每个窗口顺序扫描全部底点并做批量仿射累加，
+ *          最后以 c 次倍点的 Horner 法合并各窗口。
+ * @param num_threads 线程数，0 表示使用硬件并发数；最多使用窗口数个线程。
+ * @param window 窗口宽度 c，0 表示按点数自动选取。
+ */
+template <typename G>
+void multiExp(G& out, const std::vector<AffineReplica<typename G::Fp>>& replicas, size_t num_threads = 0,
+              size_t window = 0) {
+    out.clear();
+    if (replicas.empty()) return;
+    // 标量与区间划分对所有副本相同，编码只用第一个副本
+    const std::vector<AffineSpan<typename G::Fp>>& spans = replicas[0].spans;
+    size_t n = 0;
+    for (const auto& span : spans) n += span.n;
+    if (n == 0) return;
+
+    if (window == 0) window = defaultWindow(n);
+    window = std::min(MAX_WINDOW, std::max(MIN_WINDOW, window));
+    const size_t num_windows = ScalarDigits::digitCount(window);
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // digits[j·n + i]：第 i 个标量的第 j 个数字
+    std::vector<int16_t> digits(num_windows * n);
+    const size_t num_spans = spans.size();
+    std::vector<size_t> span_begin(num_spans);
+    for (size_t s = 1; s < num_spans; ++s) span_begin[s] = span_begin[s - 1] + spans[s - 1].n;
+    auto recode = [&](size_t lo, size_t hi) {
+        std::vector<int32_t> d(num_windows);
+        size_t s = std::upper_bound(span_begin.begin(), span_begin.end(), lo) - span_begin.begin() - 1;
+        for (size_t i = lo; i < hi; ++i) {
+            while (i >= span_begin[s] + spans[s].n) ++s;
+            ScalarDigits::signedWindows(d.data(), spans[s].coeffs[i - span_begin[s]], window);
+            for (size_t j = 0; j < num_windows; ++j) digits[j * n + i] = static_cast<int16_t>(d[j]);
+        }
+    };
+    const size_t recode_threads = std::min(num_threads, std::max<size_t>(1, n / BatchInversion::PARALLEL_MIN_CHUNK));
+    if (recode_threads <= 1) {
+        recode(0, n);
+    } else {
+        std::vector<std::thread> threads;
+        size_t chunk = (n + recode_threads - 1) / recode_threads;
+        for (size_t lo = 0; lo < n; lo += chunk) threads.emplace_back(recode, lo, std::min(lo + chunk, n));
+        for (auto& t : threads) t.join();
+    }
+
+    std::vector<G> window_sums(num_windows);
+    const size_t threads_used = std::min(num_threads, num_windows);
+    std::vector<std::unique_ptr<Buckets<G>>> buckets(std::max<size_t>(1, threads_used));
+    for (auto& b : buckets) b.reset(new Buckets<G>(size_t(1) << (window - 1)));
+    std::vector<std::thread> threads;
+    auto worker = [&](size_t w) {
+        // 线程 w 扫描第 w % R 个副本，并绑定到该副本所在的节点
+        const AffineReplica<typename G::Fp>& replica = replicas[w % replicas.size()];
+        if (replicas.size() > 1 && replica.node >= 0) MemoryPlacement::bindThreadToNode(replica.node);
+        Buckets<G>& bucket_set = *buckets[w];
+        for (size_t j = w; j < num_windows; j += buckets.size()) {
+            bucket_set.clear();
+            const int16_t* row = digits.data() + j * n;
+            for (size_t s = 0; s < num_spans; ++s) {
+                const AffineSpan<typename G::Fp>& span = replica.spans[s];
+                const int16_t* d = row + span_begin[s];
+                for (size_t k = 0; k < span.n; ++k) {
+                    if (d[k] == 0 || span.infinity[k]) continue;
+                    if (d[k] > 0) {
+                        bucket_set.add(d[k] - 1, span.x + k, span.y + k, false);
+                    } else {
+                        bucket_set.add(-d[k] - 1, span.x + k, span.y + k, true);
+                    }
+                }
+            }
+            bucket_set.finish();
+            bucket_set.reduce(window_sums[j]);
+        }
+    };
+    if (buckets.size() <= 1 && replicas.size() <= 1) {
+        worker(0);
+    } else {
+        // 亲和性只施加在工作线程上，不改变调用者线程
+        for (size_t w = 0; w < buckets.size(); ++w) threads.emplace_back(worker, w);
+        for (auto& th : threads) th.join();
+    }
+
+    // Σ_j 2^{c·j}·W_j（Horner 法）
+    out = window_sums[num_windows - 1];
+    for (size_t j = num_windows - 1; j-- > 0;) {
+        for (size_t k = 0; k < window; ++k) G::dbl(out, out);
+        out += window_sums[j];
+    }
+}
+
+// 单份底点（不绑定节点）
+template <typename G>
+void multiExp(G& out, const std::vector<AffineSpan<typename G::Fp>>& spans, size_t num_threads = 0,
+              size_t window = 0) {
+    multiExp(out, std::vector<AffineReplica<typename G::Fp>>{AffineReplica<typename G::Fp>{-1, spans}},
+             num_threads, window);
+}
+
+} // namespace AffineMsm
+
+} // namespace expressive_accumulator
+
+#endif // AFFINE_MSM_H
@@ -0,0 +1,154 @@
+#ifndef BATCH_INVERSION_H
+#define BATCH_INVERSION_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fr_simd.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 批量求逆（Montgomery 技巧）及基于它的批量点规范化。
+ * @details n 个元素的逆只需一次域求逆和约 3(n - 1) 次乘法，
+ *          而逐个求逆每次都要做一次完整的扩展欧几里得或幂运算。
+ *          零元素不参与乘积链，求逆后保持为零。
+ *          F 可为 Fr、Fp、Fp2 等提供 mul/inv/isZero 的域类型；
+ *          Fr 走 FrSimd 的多通道实现。
+ */
+namespace BatchInversion {
+
+// 并行版本中每个线程至少分到的元素数，过小的分块不值得单独求逆
+const size_t PARALLEL_MIN_CHUNK = 1024;
+
+// 原地 x[i] <- 1 / x[i]，prefix 为调用者提供的临时空间（反复调用时避免重复分配）
+template <typename F>
+void invert(F* x, size_t n, std::vector<F>& prefix) {
+    if (n == 0) return;
+    // prefix[i] = 前 i 个非零元素之积
+    prefix.resize(n);
+    F acc = 1;
+    for (size_t i = 0; i < n; ++i) {
+        prefix[i] = acc;
+        if (!x[i].isZero()) F::mul(acc, acc, x[i]);
+    }
+    F inv;
+    F::inv(inv, acc);
+    for (size_t i = n; i-- > 0;) {
+        if (x[i].isZero()) continue;
+        F xi = x[i];
+        F::mul(x[i], inv, prefix[i]);
+        F::mul(inv, inv, xi);
+    }
+}
+
+template <typename F>
+void invert(F* x, size_t n) {
+    std::vector<F> prefix;
+    invert(x, n, prefix);
+}
+
+inline void invert(Fr* x, size_t n) {
+    FrSimd::batchInvert(x, n);
+}
+
+template <typename F>
+void invert(std::vector<F>& x) {
+    invert(x.data(), x.size());
+}
+
+/**
+ * @brief 分块并行的批量求逆：每个线程对自己的连续分块独立做一次 Montgomery 技巧。
+ * @param num_threads 线程数，0 表示使用硬件并发数。
+ */
+template <typename F>
+void invertParallel(F* x, size_t n, size_t num_threads = 0) {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, std::max<size_t>(1, n / PARALLEL_MIN_CHUNK));
+    if (num_threads <= 1) {
+        invert(x, n);
+        return;
+    }
+    std::vector<std::thread> threads;
+    size_t chunk = (n + num_threads - 1) / num_threads;
+    for (size_t begin = 0; begin < n; begin += chunk) {
+        threads.emplace_back([x, begin, n, chunk]() {
+            invert(x + begin, std::min(chunk, n - begin));
+        });
+    }
+    for (auto& t : threads) t.join();
+}
+
+template <typename F>
+void invertParallel(std::vector<F>& x, size_t num_threads = 0) {
+    invertParallel(x.data(), x.size(), num_threads);
+}
+
+/**
+ * @brief 把一组 G1/G2 点原地转换为仿射坐标 (z = 1)。
+ * @details 所有 z 坐标一起求逆：Jacobian 坐标下 (X/Z^2, Y/Z^3)，射影坐标下 (X/Z, Y/Z)。
+ *          无穷远点与已规范化的点保持不变。规范化后的点做标量乘法和 mulVec 时可以走混合加法。
+ * @param num_threads 线程数，0 表示使用硬件并发数。
+ */
+template <typename G>
+void normalizePoints(G* points, size_t n, size_t num_threads = 1) {
+    typedef typename G::Fp F;
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < n; ++i) {
+        if (!points[i].isNormalized()) pending.push_back(i);
+    }
+    if (pending.empty()) return;
+
+    std::vector<F> z_inv(pending.size());
+    for (size_t k = 0; k < pending.size(); ++k) z_inv[k] = points[pending[k]].z;
+    invertParallel(z_inv, num_threads);
+
+    const bool jacobi = (G::mode_ == mcl::ec::Jacobi);
+    for (size_t k = 0; k < pending.size(); ++k) {
+        G& P = points[pending[k]];
+        if (jacobi) {
+            F zi2;
+            F::sqr(zi2, z_inv[k]);
+            F::mul(P.x, P.x, zi2);
+            F::mul(P.y, P.y, zi2);
+            F::mul(P.y, P.y, z_inv[k]);
+        } else {
+            F::mul(P.x, P.x, z_inv[k]);
+            F::mul(P.y, P.y, z_inv[k]);
+        }
+        P.z = 1;
+    }
+}
+
+template <typename G>
+void normalizePoints(std::vector<G>& points, size_t num_threads = 1) {
+    normalizePoints(points.data(), points.size(), num_threads);
+}
+
+/**
+ * @brief 把一组点序列化为 mcl::IoSerialize 字符串，结果与逐个 getStr 相同。
+ * @details 逐个序列化时每个非仿射点都要单独求逆一次；这里先在副本上批量规范化，
+ *          n 个点共用一次求逆，随后的 getStr 不再求逆。输入点不被修改。
+ */
+template <typename G>
+std::vector<std::string> serializePoints(const G* points, size_t n, size_t num_threads = 1) {
+    std::vector<G> normalized(points, points + n);
+    normalizePoints(normalized, num_threads);
+    std::vector<std::string> out(n);
+    for (size_t i = 0; i < n; ++i) out[i] = normalized[i].getStr(mcl::IoSerialize);
+    return out;
+}
+
+} // namespace BatchInversion
+
+} // namespace expressive_accumulator
+
+#endif // BATCH_INVERSION_H
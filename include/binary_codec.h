@@ -0,0 +1,84 @@
+#ifndef BINARY_CODEC_H
+#define BINARY_CODEC_H
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 二进制文件格式共用的小端整数、变长整数编码与校验和。
+ */
+namespace BinaryCodec {
+
+// 变长整数最多占用的字节数（64 位，每字节 7 位）
+const size_t MAX_VARINT_BYTES = 10;
+
+template <typename T>
+T readLE(const uint8_t* p) {
+    T v = 0;
+    for (size_t i = sizeof(T); i-- > 0;) v = static_cast<T>((v << 8) | p[i]);
+    return v;
+}
+
+template <typename T>
+void writeLE(uint8_t* p, T v) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        p[i] = static_cast<uint8_t>(v & 0xFF);
+        v = static_cast<T>(v >> 8);
+    }
+}
+
+inline size_t pad8(size_t n) {
+    return (n + 7) / 8 * 8;
+}
+
+// LEB128：每字节低 7 位为数据，最高位表示后面还有字节
+inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+/**
+ * @brief 从 [p, end) 读取一个变长整数并前移 p。
+ * @return 数据在 end 前结束或超过 MAX_VARINT_BYTES 字节时返回 false。
+ */
+inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (size_t shift = 0; shift < 7 * MAX_VARINT_BYTES; shift += 7) {
+        if (p == end) return false;
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// CRC-32（IEEE 802.3，反射多项式 0xEDB88320），crc 传入上一段的结果可分段计算
+inline uint32_t crc32(const uint8_t* data, size_t n, uint32_t crc = 0) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+} // namespace BinaryCodec
+
+} // namespace expressive_accumulator
+
+#endif // BINARY_CODEC_H
@@ -14,6 +14,16 @@
 #include <iomanip>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <mutex>
+#include <thread>
+#include "pairing_cache.h"
+#include "power_table.h"
+#include "powers_of_tau.h"
+#include "precomputed_msm.h"
 
 using namespace mcl::bls12;
 
@@ -48,6 +58,12 @@ struct AccumulatorDigest {
     // 序列化与反序列化 (可以根据需要实现)
     std::string serialize() const;
     void deserialize(const std::string& data);
+
+    /**
+     * @brief 批量序列化，结果与逐个 serialize 相同。
+     * @details 先批量规范化摘要点，n 个摘要共用一次域求逆。
+     */
+    static std::vector<std::string> serializeBatch(const std::vector<AccumulatorDigest>& digests);
     
     bool operator==(const AccumulatorDigest& other) const {
         return value == other.value;
@@ -76,6 +92,17 @@ struct AccumulatorDigestG2 {
     }
 };
 
+/**
+ * @brief 聚合多个摘要时使用的 Fiat-Shamir 随机系数。
+ * @details 对 domain || 全部摘要的序列化 || transcript 哈希得到种子，再由种子派生与摘要数相同个数的 ρ_i。
+ *          跨累加器成员证明与门限查询共用此推导，只以 domain 区分。
+ * @param domain 域分离标签，应包含调用方绑定的公开参数（如元素或门限）。
+ * @param transcript 附加绑定的证明内容，可为空。
+ */
+std::vector<Fr> fiatShamirChallenges(const std::string& domain,
+                                     const std::vector<AccumulatorDigest>& digests,
+                                     const std::string& transcript = std::string());
+
 /**
  * @brief 集合交集证明。
  * @details 包含 I ⊆ A 和 I ⊆ B 的子集关系证明，
@@ -105,6 +132,29 @@ struct MembershipProof {
     MembershipProof() : is_member(false) {}
 };
 
+/**
+ * @brief 批量成员关系证明：一次性证明多个元素都是集合成员。
+ * @details 见证 W = g2^{P(s)/∏(s - x_i)}，证明大小与验证开销都与元素个数 m 无关。
+ */
+struct BatchMembershipProof {
+    G2 witness_g2;                          ///< 见证 W = g2^{P(s)/∏(s-x_i)}
+    bool is_member;                         ///< 声明所有元素是否都是成员
+
+    BatchMembershipProof() : is_member(false) {}
+};
+
+/**
+ * @brief 跨累加器成员关系证明：证明同一个元素 x 属于每个 A_i。
+ * @details 各集合的见证 W_i = g2^{A_i(s)/(s-x)} 以 Fiat-Shamir 系数 ρ_i
+ *          聚合为 W = Σ ρ_i·W_i，验证者只需一次多标量乘法和一次多重配对。
+ */
+struct CrossMembershipProof {
+    G2 witness_g2;                          ///< 聚合见证 W = g2^{Σ ρ_i·A_i(s)/(s-x)}
+    bool is_member;                         ///< 声明元素是否属于全部集合
+
+    CrossMembershipProof() : is_member(false) {}
+};
+
 /**
  * @brief 定义累加器的动态操作类型。
  */
@@ -135,6 +185,40 @@ struct CountProof {
     CountProof() : is_valid(false) {}
 };
 
+/**
+ * @brief 二维项 s^{s_exp}·r^{r_exp}，用于索引盲化幂次表 g^{s^i r^j}。
+ */
+struct Term2D {
+    int s_exp;
+    int r_exp;
+    
+    Term2D(int s, int r) : s_exp(s), r_exp(r) {}
+};
+
+/**
+ * @brief 盲化因子：只有摘要持有者知道的随机二元多项式 β(S, R) = Σ ρ_ij·S^i·R^j（1 ≤ j ≤ r_degree）。
+ * @details 系数按 R 的次数分行，每行 s_degree + 1 个，低次在前。
+ *          每个成员证明公开各行在 x 处的值 β_j(x)，同一盲化因子最多可以打开 s_degree 个元素而不泄露集合信息。
+ */
+struct Blinding {
+    std::vector<Fr> coeffs;
+    size_t s_degree;
+    size_t r_degree;
+
+    Blinding() : s_degree(0), r_degree(0) {}
+};
+
+/**
+ * @brief 针对盲化摘要 Â = g1^{P(s) + β(s, r)} 的成员关系证明。
+ */
+struct BlindedMembershipProof {
+    G2 witness_g2;                          ///< 盲化见证 Ŵ = g2^{Q(s) + γ(s, r)}，γ = (β(S, R) - β(x, R))/(S - x)
+    std::vector<Fr> openings;               ///< β_j(x)，j = 1..r_degree
+    bool is_member;
+
+    BlindedMembershipProof() : is_member(false) {}
+};
+
 /**
  * @brief 密码学累加器的可信设置。
  * @details 负责生成和存储系统级的秘密参数（s, r）和由它们衍生的公开参数（g^{s^i}）。
@@ -145,29 +229,235 @@ private:
     Fr secret_s;
     Fr secret_r;
     size_t max_degree;
+    // 由仪式文件导入的 setup 不知道 s，幂次表不能扩展
+    bool has_secret = true;
+    // generatePowers 是否已运行；在此之前幂次表不能扩展
+    bool powers_generated = false;
     G1 g1_generator;
     G2 g2_generator;
 
+    // 串行化幂次表的生成（前台 ensureDegree 与后台扩展线程）
+    mutable std::mutex growth_mutex;
+    // 保护后台扩展线程的状态
+    mutable std::mutex extension_mutex;
+    mutable std::thread extension_thread;
+    mutable size_t extension_target = 0;
+    mutable bool extension_running = false;
+    // 为 false 时 reserveDegree 不启动后台扩展
+    std::atomic<bool> background_extension{true};
+    // 后台扩展抛出的异常，由下一次 waitForExtension/ensureDegree 取出并重新抛出
+    mutable std::exception_ptr extension_error;
+
+    // 取出并重新抛出后台扩展保存的异常（只抛出一次）
+    void rethrowExtensionError() const;
+
+    void requireSecret() const {
+        if (!has_secret) {
+            throw std::logic_error("ExpressiveTrustedSetup: imported setup has no secret");
+        }
+    }
+
+    // 把两张幂次表扩展到至少 count 个点，逐块发布
+    void extendPowers(size_t count) const;
+
+    // 幂次表低次部分的窗口倍点表（可选），以 std::atomic_load/atomic_store 无锁替换
+    std::shared_ptr<const PrecomputedMsm<G1>> g1_precomputed;
+    std::shared_ptr<const PrecomputedMsm<G2>> g2_precomputed;
+
+    // 验证时 e(·, g2) 的缓存，不属于 setup 的逻辑状态
+    mutable PairingCache pairing_cache;
+
+    // 盲化幂次表的维度，0 表示尚未生成
+    size_t blinding_s_degree = 0;
+    size_t blinding_r_degree = 0;
+
 public:
-    std::vector<G1> g1_s_powers;
-    std::vector<G2> g2_s_powers;
+    /**
+     * @brief g^{s^i} 幂次表。
+     * @details 幂次表是 s 的确定性函数，按需增长不改变 setup 的逻辑状态，因此声明为 mutable，
+     *          const 的 ensureDegree/reserveDegree 可以扩展它；已有的点从不搬移，读取无锁。
+     */
+    mutable PowerTable<G1> g1_s_powers;
+    mutable PowerTable<G2> g2_s_powers;
+
+    /**
+     * @brief 盲化用的二维幂次表 g^{s^i r^j}，0 ≤ i ≤ s_degree，1 ≤ j ≤ r_degree。
+     * @details 按 j 分行、每行 s_degree + 1 个点，第 (j - 1)·(s_degree + 1) + i 个点为 g^{s^i r^j}；
+     *          j = 0 的一行就是 g1_s_powers/g2_s_powers，不重复保存。以 COMPRESSED 形式保存。
+     */
+    PowerTable<G1> g1_sr_powers;
+    PowerTable<G2> g2_sr_powers;
 
     /**
      * @brief 构造函数。
      * @param s 秘密参数 s。
      * @param r 秘密参数 r。
      * @param max_deg 多项式的最大次数。
+     * @param storage 幂次表的内存存储方式，大次数时可选 AFFINE 或 COMPRESSED 以节省内存。
+     * @param placement 幂次表的内存放置：大页与每个 NUMA 节点一份的副本。
      */
-    ExpressiveTrustedSetup(const Fr& s, const Fr& r, size_t max_deg = 1000);
+    ExpressiveTrustedSetup(const Fr& s, const Fr& r, size_t max_deg = 1000,
+                           PowerStorage storage = PowerStorage::JACOBIAN,
+                           const TablePlacement& placement = TablePlacement());
+    ~ExpressiveTrustedSetup();
+
+    ExpressiveTrustedSetup(const ExpressiveTrustedSetup&) = delete;
+    ExpressiveTrustedSetup& operator=(const ExpressiveTrustedSetup&) = delete;
+
     void generatePowers();
 
+    /**
+     * @brief 从 powers-of-tau 仪式文件导入幂次表。
+     * @details 文件以只读方式内存映射并按块流式解码：每块在多个线程上并行解压，
+     *          每个点都检查在曲线上且属于 r 阶子群，随后追加到幂次表，峰值内存与文件大小无关。
+     *          导入的 setup 没有秘密 s（hasSecret() 为 false）：幂次表不能扩展，
+     *          只能使用表内的幂次（commitG1/commitG2、getG1_s_pow、validateSetup），
+     *          依赖 s 的指定验证者累加器操作不可用。
+     * @param path 仪式文件路径。
+     * @param options 文件格式、导入次数、存储方式与线程数。
+     * @throws std::runtime_error 文件无法读取、格式不符或含有无效点时抛出。
+     * @throws std::invalid_argument response 格式未给出 ceremony_power 时抛出。
+     */
+    static std::unique_ptr<ExpressiveTrustedSetup> importPowersOfTau(
+        const std::string& path, const PtauImportOptions& options = PtauImportOptions());
+
+    /**
+     * @brief 只生成到 initial_degree 的幂次，更高次数在需要时再扩展。
+     * @details 调用时不能有并发的读取者（会清空已有的表）。
+     */
+    void generatePowers(size_t initial_degree);
+
+    /**
+     * @brief 同步扩展幂次表，使其覆盖次数 degree。
+     * @details 只阻塞调用者；并发的读取者可以继续读取已发布的点。
+     * @throws std::length_error 超出幂次表容量时抛出；此前后台扩展失败时先抛出其保存的异常。
+     */
+    void ensureDegree(size_t degree) const;
+
+    /**
+     * @brief 预留次数 degree：不足时启动后台线程按块扩展（至少翻倍），立即返回。
+     * @details 集合增长时由累加器调用。扩展期间的读取不会阻塞：
+     *          已发布的点直接读取，尚未生成的幂次由 getG1_s_pow/commitG1 直接用 s 计算。
+     *          扩展目标不超过 PowerTable 的容量；后台线程中的异常被保存而不会终止进程。
+     */
+    void reserveDegree(size_t degree) const;
+
+    /**
+     * @brief 开关 reserveDegree 的后台扩展（默认开启）。
+     * @details 关闭后表外的幂次仍由 s 直接计算，ensureDegree 仍可同步扩展；
+     *          适用于只需要 P(s) 与摘要、不需要大次数幂次表的场景（如大集合的加载基准）。
+     */
+    void setBackgroundExtension(bool enabled) { background_extension.store(enabled); }
+
+    /**
+     * @brief 等待后台扩展完成。
+     * @throws 后台扩展失败时重新抛出其保存的异常。
+     */
+    void waitForExtension() const;
+
+    // 幂次表当前覆盖的次数
+    size_t availableDegree() const {
+        size_t n = g1_s_powers.size();
+        return n >= 2 ? n - 2 : 0;
+    }
+
+    /**
+     * @brief 承诺多项式：g1^{Σ c_i·s^i}，基于幂次表做按块解压的多标量乘法。
+     * @details 超出幂次表的高次部分直接在 s 处求值后做一次标量乘法，并预留相应次数。
+     * @param coeffs 多项式系数（低次在前）。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     */
+    G1 commitG1(const std::vector<Fr>& coeffs, size_t num_threads = 0) const;
+    G2 commitG2(const std::vector<Fr>& coeffs, size_t num_threads = 0) const;
+
+    /**
+     * @brief 为幂次表的底点预计算窗口倍点表，此后 commitG1/commitG2 中被覆盖的部分只需要点加。
+     * @details 以内存换时间：每个底点保存 ⌈256/w⌉ 个仿射点。预算不足以覆盖整张表时只预计算低次部分，
+     *          其余部分仍走幂次表的多标量乘法。新表建好后原子地替换旧表，不影响并发的承诺；
+     *          幂次表之后扩展出的部分不在预计算范围内，需要时可再次调用。
+     * @param window 窗口宽度 w（2 到 16）。w 越大，内存与点加次数越少，但每次承诺的桶合并代价 2^w 越高。
+     * @param memory_budget 两张预计算表的总字节上限，0 表示不限制。
+     * @param num_threads 建表的线程数，0 表示使用硬件并发数。
+     * @return 被预计算覆盖的底点数。
+     * @throws std::invalid_argument 窗口宽度不合法时抛出。
+     */
+    size_t enablePrecomputation(size_t window = 8, size_t memory_budget = 0, size_t num_threads = 0);
+    void disablePrecomputation();
+    // 两张预计算表的总字节数
+    size_t precomputedBytes() const;
+
+    /**
+     * @brief 随机化验证幂次表确实是 g1^{s^i}、g2^{s^i}（不需要知道 s）。
+     * @details 用随机系数 ρ_i 合并所有相邻幂次关系 e(g1^{s^i}, g2^s) = e(g1^{s^{i+1}}, g2)：
+     *          A = Σ ρ_i·P_i，B = Σ ρ_i·P_{i+1}，检查 e(A, Q_1) = e(B, Q_0)；
+     *          G2 表以独立的系数 τ_i 同样合并为 C、D，检查 e(P_1, C) = e(P_0, D)。
+     *          两个等式合成一次四项多重配对，总代价为四次多标量乘法和一次最终幂，
+     *          而逐项检查需要 4n 次配对。任何一项关系不成立时以至多 1/r 的概率漏检。
+     * @param num_threads 多标量乘法的线程数，0 表示使用硬件并发数。
+     * @return 表为空、生成元为零或任一关系不成立时返回 false。
+     */
+    bool validateSetup(size_t num_threads = 0) const;
+
+    // 两张幂次表的点数据总字节数
+    size_t powerTableBytes() const { return g1_s_powers.memoryBytes() + g2_s_powers.memoryBytes(); }
+    PowerStorage getPowerStorage() const { return g1_s_powers.storage(); }
+    const TablePlacement& getTablePlacement() const { return g1_s_powers.placement(); }
+
+    /**
+     * @brief 验证者使用的 e(P, g2) 缓存。
+     * @details verifyMembershipProof、verifyIntersectionProof 与 verifyUpdateProof 经由它计算与摘要相关的
+     *          e(A, g2)：同一摘要的重复验证直接取缓存的 GT 值，未命中时使用 g2 的预计算直线。
+     *          可调整容量（0 表示只用预计算直线）并读取命中计数。
+     */
+    PairingCache& pairingCache() const { return pairing_cache; }
+
+    /**
+     * @brief 生成盲化用的二维幂次表，此后盲化摘要与盲化证明只需对表做小规模多标量乘法。
+     * @details 共 (s_degree + 1)·r_degree 个点，由 s^i·r^j 逐项做一次标量乘法生成。
+     *          s_degree 决定同一盲化因子可以安全打开的成员数。调用时不能有并发的盲化操作。
+     * @throws std::logic_error 导入的 setup 没有秘密时抛出。
+     * @throws std::invalid_argument s_degree 或 r_degree 为 0 时抛出。
+     */
+    void generateBlindingPowers(size_t s_degree = DEFAULT_BLINDING_DEGREE, size_t r_degree = 1);
+
+    static const size_t DEFAULT_BLINDING_DEGREE = 8;
+
+    bool hasBlindingPowers() const { return blinding_r_degree != 0; }
+    size_t getBlindingSDegree() const { return blinding_s_degree; }
+    size_t getBlindingRDegree() const { return blinding_r_degree; }
+
+    /**
+     * @brief g^{s^i r^j}。r_exp 为 0 时即 getG1_s_pow(s_exp)。
+     * @throws std::out_of_range 项超出盲化幂次表时抛出。
+     */
+    G1 getG1_sr_pow(const Term2D& term) const;
+    G2 getG2_sr_pow(const Term2D& term) const;
+
     // 获取器
-    Fr getSecretS() const { return secret_s; }
-    Fr getSecretR() const { return secret_r; }
+    bool hasSecret() const { return has_secret; }
+
+    /**
+     * @brief 秘密 s 与 r，供指定验证者计算 P(s) 与见证值。
+     * @throws std::logic_error 由仪式文件导入的 setup（hasSecret() 为 false）没有秘密时抛出。
+     */
+    const Fr& getSecretS() const {
+        requireSecret();
+        return secret_s;
+    }
+    const Fr& getSecretR() const {
+        requireSecret();
+        return secret_r;
+    }
     int getQ() const { return static_cast<int>(max_degree); }
     G1 getG1Generator() const { return g1_generator; }
     G2 getG2Generator() const { return g2_generator; }
-    G2 getG2_s_pow(int i) const { return g2_s_powers.at(i); }
+
+    /**
+     * @brief g^{s^i}。尚未生成的幂次直接计算并预留该次数，不等待扩展。
+     * @throws std::out_of_range i 为负，或导入的 setup 中 i 超出幂次表时抛出。
+     */
+    G1 getG1_s_pow(int i) const;
+    G2 getG2_s_pow(int i) const;
 };
 
 // 群类型枚举
@@ -180,14 +470,24 @@ enum GroupType { G1_TYPE, G2_TYPE };
 class ExpressiveAccumulator {
 private:
     /**
-     * @brief [私有] 根据当前的元素集合更新累加器的摘要值。
-     * @details 在任何元素变更（添加/删除）后调用此函数。
-     *          它会重新评估特征多项式 P(s) 并将摘要更新为 g^P(s)。
+     * @brief [私有] 根据缓存的 P(s) 更新累加器的摘要值。
+     * @details 在任何元素变更（添加/删除）后调用此函数，将摘要更新为 g^P(s)。
+     *          P(s) 由增删操作增量维护，不再重新对整个集合求值。
      */
     void updateAccumulatorValue();
+
+    /**
+     * @brief [私有] 元素 x 的见证值 P(s)/(s - x)，只需一次域求逆。
+     */
+    Fr witnessValue(int element) const;
+    // 跨累加器成员证明的 Fiat-Shamir 聚合系数，域标签绑定元素
+    static std::vector<Fr> crossMembershipChallenges(const std::vector<AccumulatorDigest>& digests, int element) {
+        return fiatShamirChallenges("cross_membership/" + std::to_string(element), digests);
+    }
     const ExpressiveTrustedSetup& trusted_setup;
     std::set<int> elements;
     std::unique_ptr<CharacteristicPolynomial> polynomial; // 使用智能指针
+    Fr poly_at_s; // 缓存的 P(s)
     GroupType group_type;
 
 public:
@@ -198,6 +498,7 @@ public:
      * @brief 构造函数。
      * @param setup 可信设置对象的引用。
      * @param type 累加器所在的群类型 (G1_TYPE 或 G2_TYPE)。
+     * @throws std::logic_error setup 没有秘密 s（由仪式文件导入）时抛出。
      */
     ExpressiveAccumulator(const ExpressiveTrustedSetup& setup, GroupType type);
     
@@ -213,16 +514,148 @@ public:
      * @return 一个 UpdateProof 对象，包含操作的证明。
      */
     UpdateProof deleteElement(int element);
+
+    /**
+     * @brief 批量增删，不生成逐个操作的证明。
+     * @details 已存在的添加与不存在的删除被忽略，同时出现在两个列表中的元素先删后加。
+     *          P(s) 乘以 ∏(s - a) 并除以 ∏(s - d)（一次域求逆），摘要只更新一次，
+     *          代价为一次标量乘法加 O(m) 次域乘法，而逐个调用需要 m 次标量乘法。
+     *          用于日志回放等批量恢复场景。
+     */
+    void applyUpdates(const std::vector<int>& added, const std::vector<int>& removed);
     
     const std::set<int>& getElements() const { return elements; }
     const CharacteristicPolynomial& getPolynomial() const { return *polynomial; } // 解引用指针
 
+    /**
+     * @brief 把累加器状态保存为紧凑的二进制文件。
+     * @details 元素按升序以差分变长整数编码，每 PERSIST_BLOCK 个元素一块，块索引记录块首元素与字节偏移，
+     *          加载时各块可以独立并行解码；同时保存群类型与摘要。缓存的 P(s) 由 s 决定，不写入文件。
+     *          文件先写入 path.tmp 再改名。
+     * @param include_coefficients 为 true 时附带特征多项式的系数形式 (n + 1 个 Fr)。
+     * @param num_threads 展开系数的线程数，0 表示使用硬件并发数。
+     * @throws std::runtime_error 文件写入失败时抛出。
+     */
+    void save(const std::string& path, bool include_coefficients = false, size_t num_threads = 0) const;
+
+    /**
+     * @brief 从 save 写出的文件恢复累加器，不重放 addElement。
+     * @details 文件以内存映射读取，各块在多个线程上并行解码，同时各自累乘 ∏(s - x) 恢复 P(s)；
+     *          摘要直接取自文件，只做一次标量乘法核对它与 setup 一致。
+     * @param coefficients 非空且文件带有系数时，输出系数形式。
+     * @param num_threads 解码线程数，0 表示使用硬件并发数。
+     * @throws std::runtime_error 文件不存在、格式不符、被截断，或摘要与 setup 不一致时抛出。
+     * @throws std::logic_error setup 没有秘密 s（由仪式文件导入）时抛出。
+     */
+    static std::unique_ptr<ExpressiveAccumulator> load(const std::string& path,
+                                                       const ExpressiveTrustedSetup& setup,
+                                                       size_t num_threads = 0,
+                                                       std::vector<Fr>* coefficients = nullptr);
+
+    // 持久化文件中每块的元素数
+    static const size_t PERSIST_BLOCK = 4096;
+
+    /**
+     * @brief 生成新的盲化因子并返回盲化摘要 Â = g1^{P(s) + β(s, r)}。
+     * @details β 的系数取自密码学安全的随机数，Â 在群中均匀分布，不再能与候选集合的承诺比对。
+     *          代价为一次对盲化幂次表的多标量乘法（(s_degree + 1)·r_degree 个点）。
+     *          集合变化后需要重新盲化；同一盲化因子打开的成员数不应超过 s_degree。
+     * @param blinding 输出的盲化因子，由调用者保密并用于之后的盲化证明。
+     * @throws std::logic_error 累加器不在 G1 上，或 setup 尚未生成盲化幂次表时抛出。
+     */
+    AccumulatorDigest blindDigest(Blinding& blinding) const;
+
+    /**
+     * @brief 生成针对盲化摘要的成员关系证明。
+     * @details Ŵ = g2^{Q(s)} + Σ γ_ij·g2^{s^i r^j}，γ 由 β 的各行对 (S - x) 做综合除法得到，
+     *          除未盲化的见证外只多一次对 G2 盲化幂次表的多标量乘法。元素不在集合中时 is_member 为 false。
+     * @throws std::invalid_argument blinding 的维度与 setup 的盲化幂次表不一致时抛出。
+     */
+    BlindedMembershipProof generateBlindedMembershipProof(int element, const Blinding& blinding) const;
+
+    /**
+     * @brief [静态] 验证盲化成员证明：e(Â - g1^{Σ β_j(x)·r^j}, g2) == e(g1^{s-x}, Ŵ)。
+     * @details g1^{r^j} 与 g1^s 都取自幂次表，验证者不需要秘密。
+     */
+    static bool verifyBlindedMembershipProof(const AccumulatorDigest& blinded_digest,
+                                             int element,
+                                             const BlindedMembershipProof& proof,
+                                             const ExpressiveTrustedSetup& setup);
+
     // 成员关系证明 (专用版本)
     static bool verifyMembershipProof(const AccumulatorDigest& acc_digest, 
                                       int element, 
                                       const MembershipProof& proof, 
                                       const ExpressiveTrustedSetup& setup);
+    // 按元素的域编码验证，供 KeyedAccumulator 等非 int 元素的累加器使用
+    static bool verifyMembershipProof(const AccumulatorDigest& acc_digest,
+                                      const Fr& element,
+                                      const MembershipProof& proof,
+                                      const ExpressiveTrustedSetup& setup);
     MembershipProof generateMembershipProof(int element) const;
+
+    /**
+     * @brief 一次性为多个元素生成各自的成员关系证明。
+     * @details 所有分母 (s - x_i) 通过批量求逆一起求逆，见证值 P(s)/(s - x_i) 的总代价为
+     *          一次域求逆加 O(m) 次乘法；随后的 G2 标量乘法按元素分块并行，
+     *          得到的见证再一起规范化为仿射坐标（一次 Fp2 求逆）。
+     *          结果与 elements 一一对应，不在集合中的元素 is_member 为 false。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     */
+    std::vector<MembershipProof> generateMembershipProofs(const std::vector<int>& elements,
+                                                          size_t num_threads = 0) const;
+
+    /**
+     * @brief [静态] 批量计算见证 W_k = g2^{P(s)/(s - x_k)}，供各类累加器的 generateMembershipProofs 共用。
+     * @details 分母 (s - x_k) 批量求逆，G2 标量乘法按根分块并行，见证一起规范化为仿射坐标。
+     * @param poly_at_s 缓存的 P(s)。
+     * @param roots 各见证对应的根 x_k（均须在集合中）。
+     * @param fallback 分母为零（s 恰为 x_k）时以下标 k 调用，返回直接求得的 P(s)/(s - x_k)。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     * @return 与 roots 一一对应的见证。
+     */
+    static std::vector<G2> batchWitnesses(const ExpressiveTrustedSetup& setup,
+                                          const Fr& poly_at_s,
+                                          const std::vector<Fr>& roots,
+                                          const std::function<Fr(size_t)>& fallback,
+                                          size_t num_threads = 0);
+
+    /**
+     * @brief 为一组元素生成单个聚合的成员关系证明。
+     * @details 重复元素只计一次；任一元素不在集合中时 is_member 为 false。
+     */
+    BatchMembershipProof generateBatchMembershipProof(const std::vector<int>& elements) const;
+
+    /**
+     * @brief [静态] 验证批量成员关系证明：e(A, g2) == e(g1^{∏(s-x_i)}, W)，仅需两次配对。
+     */
+    static bool verifyBatchMembershipProof(const AccumulatorDigest& acc_digest,
+                                           const std::vector<int>& elements,
+                                           const BatchMembershipProof& proof,
+                                           const ExpressiveTrustedSetup& setup);
+
+    /**
+     * @brief [静态] 生成元素 x 同时属于多个累加器的聚合证明。
+     * @param accs 参与证明的累加器。
+     * @param element 被查询的元素。
+     * @param num_threads 计算各集合见证的线程数，0 表示使用硬件并发数。
+     */
+    static CrossMembershipProof generateCrossMembershipProof(
+        const std::vector<const ExpressiveAccumulator*>& accs,
+        int element,
+        const ExpressiveTrustedSetup& setup,
+        size_t num_threads = 0);
+
+    /**
+     * @brief [静态] 验证跨累加器成员关系证明：
+     *        e(Σ ρ_i·A_i, g2) · e(g1^{-(s-x)}, W) == 1，一次多重配对（共享最终幂）。
+     * @param digests 各累加器的摘要，顺序与生成证明时一致。
+     */
+    static bool verifyCrossMembershipProof(
+        const std::vector<AccumulatorDigest>& digests,
+        int element,
+        const CrossMembershipProof& proof,
+        const ExpressiveTrustedSetup& setup);
     
     // 集合运算
     /**
@@ -236,6 +669,15 @@ public:
         const ExpressiveAccumulator& acc1,
         const ExpressiveAccumulator& acc2,
         const ExpressiveTrustedSetup& setup);
+
+    /**
+     * @brief 直接由两个元素集合生成交集证明。
+     * @details 供查询引擎等场景使用，中间结果无需构造完整的累加器对象。
+     */
+    static IntersectionProof generateIntersectionProof(
+        const std::set<int>& set_a,
+        const std::set<int>& set_b,
+        const ExpressiveTrustedSetup& setup);
     
     /**
      * @brief [静态] 验证集合交集证明 (精确模型)。
@@ -281,11 +723,23 @@ private:
         
 public:
     CharacteristicPolynomial(const std::set<int>& elems) : elements(elems) {}
+    CharacteristicPolynomial(std::set<int>&& elems) : elements(std::move(elems)) {}
     
     void addElement(int element);
     void removeElement(int element);
     Fr evaluate(const Fr& a) const;
 
+    /**
+     * @brief 在多个点上同时求值 P(z)。
+     * @details 展开 P 的系数后用乘积树/余数树求值，代价为 O(M(n + m) log(n + m))，
+     *          M 为多项式乘法代价，远低于逐点求值的 O(n·m)；点数不超过 MULTI_EVALUATE_DIRECT_LIMIT 时逐点求值。
+     * @param points 求值点。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     */
+    std::vector<Fr> multiEvaluate(const std::vector<Fr>& points, size_t num_threads = 0) const;
+
+    static const size_t MULTI_EVALUATE_DIRECT_LIMIT = 32;
+
     const std::set<int>& getElements() const {
         return elements;
     }
@@ -293,14 +747,6 @@ public:
     static std::set<int> intersection(const std::set<int>& set1, const std::set<int>& set2);
 };
 
-// 二维项结构
-struct Term2D {
-    int s_exp;
-    int r_exp;
-    
-    Term2D(int s, int r) : s_exp(s), r_exp(r) {}
-};
-
 } // namespace expressive_accumulator
 
 #endif // EXPRESSIVE_ACCUMULATOR_H
@@ -0,0 +1,52 @@
+#ifndef FR_NTT_H
+#define FR_NTT_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <vector>
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief BLS12-381 标量域 Fr 上的数论变换 (NTT)。
+ * @details Fr 的 2-adicity 为 32，即 2^32 | r - 1，因此支持长度至多 2^32 的
+ *          radix-2 变换。单位根由乘法生成元 7 计算得到：ω = 7^{(r-1)/2^32}。
+ *          全部运算直接在 mcl 的 Montgomery 表示上进行，不经过任何字符串或大整数转换。
+ *          使用前须先调用 initMcl()。
+ */
+namespace FrNtt {
+
+// Fr 的 2-adicity
+const size_t MAX_LOG_SIZE = 32;
+
+/**
+ * @brief 2^log_n 次本原单位根。
+ * @throws std::invalid_argument log_n 超过 MAX_LOG_SIZE 时抛出。
+ */
+const Fr& rootOfUnity(size_t log_n);
+
+/**
+ * @brief 原地正变换：a[i] <- Σ_j a[j]·ω^{ij}，输入输出均为自然顺序。
+ * @details a.size() 必须是 2 的幂。长变换按 num_threads 拆分：
+ *          低层蝶形按连续块分给各线程，高层蝶形在层内按下标区间并行。
+ * @param num_threads 线程数，0 表示使用硬件并发数。
+ */
+void forward(std::vector<Fr>& a, size_t num_threads = 1);
+
+// 原地逆变换，含 1/n 缩放
+void inverse(std::vector<Fr>& a, size_t num_threads = 1);
+
+/**
+ * @brief 基于 NTT 的多项式乘法（系数低次在前）。
+ * @throws std::invalid_argument 结果长度超过 2^32 时抛出。
+ */
+std::vector<Fr> multiply(const std::vector<Fr>& a, const std::vector<Fr>& b, size_t num_threads = 1);
+
+} // namespace FrNtt
+
+} // namespace expressive_accumulator
+
+#endif // FR_NTT_H
@@ -0,0 +1,100 @@
+#ifndef FR_POLYNOMIAL_H
+#define FR_POLYNOMIAL_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <vector>
+#include <set>
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 直接在 mcl::Fr 上进行的系数形式多项式运算。
+ * @details 多项式以系数向量表示，下标 i 对应 z^i 的系数（低次在前），
+ *          零多项式为空向量。所有函数都保证返回值已去除高位零系数。
+ */
+namespace FrPolynomial {
+
+using Poly = std::vector<Fr>;
+
+// 去除高位零系数
+void trim(Poly& p);
+
+// 多项式次数，零多项式返回 -1
+inline long degree(const Poly& p) { return static_cast<long>(p.size()) - 1; }
+
+bool isOne(const Poly& p);
+
+// 从根集合构建 P(z) = (z - r1)(z - r2)...，使用乘积树
+Poly fromRoots(const std::set<int>& roots);
+
+// Horner 法求值
+Fr evaluate(const Poly& p, const Fr& x);
+
+/**
+ * @brief 由域元素根构建 ∏(z - r_i)，使用乘积树。
+ * @param num_threads 线程数，0 表示使用硬件并发数。
+ */
+Poly fromRoots(const std::vector<Fr>& roots, size_t num_threads = 1);
+
+/**
+ * @brief 多点求值：返回 p 在每个点处的值。
+ * @details 先对求值点建乘积树，再自顶向下做余数树，叶子处对短余式 Horner 求值。
+ *          乘法使用 Karatsuba、除法使用牛顿迭代，同一层的节点相互独立，可多线程处理。
+ * @param num_threads 线程数，0 表示使用硬件并发数。
+ */
+std::vector<Fr> multiEvaluate(const Poly& p, const std::vector<Fr>& points, size_t num_threads = 1);
+
+// p <- p * (z - x)
+void mulLinear(Poly& p, const Fr& x);
+
+/**
+ * @brief p <- p / (z - x)（综合除法）。
+ * @return 余数 p(x)；当 x 是 p 的根时为 0。
+ */
+Fr divLinear(Poly& p, const Fr& x);
+
+Poly add(const Poly& a, const Poly& b);
+Poly sub(const Poly& a, const Poly& b);
+Poly scale(const Poly& a, const Fr& c);
+/**
+ * @brief 多项式乘法：短因子用教科书/Karatsuba 乘法，长因子用 Fr 上的 NTT。
+ * @param num_threads NTT 使用的线程数，0 表示使用硬件并发数。
+ */
+Poly mul(const Poly& a, const Poly& b, size_t num_threads = 1);
+
+// a = q * b + r，deg r < deg b；b 不能为零多项式。商较长时使用牛顿迭代
+void divRem(Poly& q, Poly& r, const Poly& a, const Poly& b);
+
+/**
+ * @brief 扩展欧几里得算法：g = u * a + v * b，g 为首一的最大公因式。
+ * @details 返回的贝祖系数满足 deg u < deg b - deg g，deg v < deg a - deg g。
+ *          次数较高时使用 half-GCD，配合 NTT 乘法为 O(M(n) log n)。
+ */
+void xgcd(Poly& g, Poly& u, Poly& v, const Poly& a, const Poly& b);
+
+// 首一最大公因式
+Poly gcd(const Poly& a, const Poly& b);
+
+// (a * b) mod m
+Poly mulMod(const Poly& a, const Poly& b, const Poly& m);
+
+// base^e mod m，指数 e 取 Fr 元素对应的整数值
+Poly powMod(const Poly& base, const Fr& e, const Poly& m);
+
+/**
+ * @brief 求在 Fr 上分裂为互异一次因式之积的多项式的全部根 (Cantor–Zassenhaus)。
+ * @details 先检查 f | z^p - z，再用 gcd(f, (z + δ)^{(p-1)/2} - 1) 随机分裂。
+ *          开销为 O(d^2 log p)，与 f 的次数 d 相关，与任何集合大小无关。
+ * @return f 不是互异一次因式之积时返回 false。
+ */
+bool findRoots(std::vector<Fr>& roots, const Poly& f);
+
+} // namespace FrPolynomial
+
+} // namespace expressive_accumulator
+
+#endif // FR_POLYNOMIAL_H
@@ -0,0 +1,73 @@
+#ifndef FR_SIMD_H
+#define FR_SIMD_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <vector>
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief Fr 的多通道 (SIMD) 向量运算内核。
+ * @details 直接读取 mcl Fr 的 Montgomery 表示（4 个 64 位字，R = 2^256），
+ *          在向量寄存器中同时计算多个互相独立的 Montgomery 乘法：
+ *          - AVX2：4 通道，32 位数字 CIOS，使用 vpmuludq；
+ *          - AVX-512F：8 通道，同上；
+ *          - AVX-512 IFMA：8 通道，52 位数字 (vpmadd52luq/vpmadd52huq)，
+ *            R' = 2^260，结果再乘 16 还原到 mcl 的 R = 2^256。
+ *          运行时按 CPU 能力选择最快的实现，非 x86-64 平台退化为 mcl 标量运算。
+ *          所有结果与 mcl 标量运算逐位一致。使用前须先调用 initMcl()。
+ */
+namespace FrSimd {
+
+enum class Backend { SCALAR, AVX2, AVX512, AVX512_IFMA };
+
+// 当前使用的实现
+Backend activeBackend();
+
+// CPU 是否支持给定实现
+bool isSupported(Backend backend);
+
+/**
+ * @brief 强制使用给定实现（用于基准测试与对比测试）。
+ * @details 以原子指针切换分派表，可与其他线程的运算并发调用：
+ *          已开始的调用用原实现算完，之后的调用使用新实现，结果逐位相同。
+ * @return 当前 CPU 不支持该实现时返回 false，保持原实现不变。
+ */
+bool setBackend(Backend backend);
+
+const char* backendName(Backend backend);
+
+// z[i] = x[i] * y[i]，z 可以与 x 或 y 相同
+void mulVec(Fr* z, const Fr* x, const Fr* y, size_t n);
+
+// z[i] = x[i] + y[i]
+void addVec(Fr* z, const Fr* x, const Fr* y, size_t n);
+
+// z[i] = x[i] - y[i]
+void subVec(Fr* z, const Fr* x, const Fr* y, size_t n);
+
+// ∏ x[i]，空数组返回 1
+Fr product(const Fr* x, size_t n);
+
+/**
+ * @brief ∏ (a - roots[i])，即特征多项式在 a 处的值。
+ * @details a - r_i 在普通（非 Montgomery）表示下直接由整数减法得到，
+ *          省去逐个元素的 Montgomery 转换，按通道连乘后统一乘以 R^n 校正。
+ */
+Fr linearProduct(const Fr& a, const int* roots, size_t n);
+
+/**
+ * @brief 原地批量求逆 x[i] <- 1 / x[i]（Montgomery 技巧，按通道交错成多条独立链）。
+ * @details 只做一次域求逆和约 3n 次乘法；零元素保持为零。
+ */
+void batchInvert(Fr* x, size_t n);
+
+} // namespace FrSimd
+
+} // namespace expressive_accumulator
+
+#endif // FR_SIMD_H
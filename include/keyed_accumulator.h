@@ -0,0 +1,241 @@
+#ifndef KEYED_ACCUMULATOR_H
+#define KEYED_ACCUMULATOR_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "expressive_accumulator.h"
+#include "fr_polynomial.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+// ==========================================================================================
+// 键到 Fr 的编码策略
+// ==========================================================================================
+
+/**
+ * @brief 以类型标签做域分离的哈希编码：Fr = H(tag || 0 || bytes)。
+ * @details 不同类型、不同键的编码相互独立，碰撞概率可忽略；负数与超出 Fr 的键也不会互相重叠。
+ */
+inline Fr hashKeyToField(const char* tag, const void* data, size_t size) {
+    std::string buffer(tag);
+    buffer.push_back('\0');
+    buffer.append(static_cast<const char*>(data), size);
+    Fr out;
+    out.setHashOf(buffer.data(), buffer.size());
+    return out;
+}
+
+/**
+ * @brief 默认的编码策略：把键哈希到 Fr。已提供 uint64_t、int64_t 与 std::string 的特化，
+ *        其他键类型可以特化本模板，或向 KeyedAccumulator 传入自定义的编码函数对象。
+ */
+template <typename Key>
+struct HashToField;
+
+template <>
+struct HashToField<uint64_t> {
+    Fr operator()(uint64_t key) const {
+        uint8_t bytes[8];
+        for (size_t i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(key >> (8 * i));
+        return hashKeyToField("expressive_accumulator/u64", bytes, sizeof(bytes));
+    }
+};
+
+template <>
+struct HashToField<int64_t> {
+    Fr operator()(int64_t key) const {
+        uint8_t bytes[8];
+        for (size_t i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(static_cast<uint64_t>(key) >> (8 * i));
+        return hashKeyToField("expressive_accumulator/i64", bytes, sizeof(bytes));
+    }
+};
+
+template <>
+struct HashToField<std::string> {
+    Fr operator()(const std::string& key) const {
+        return hashKeyToField("expressive_accumulator/str", key.data(), key.size());
+    }
+};
+
+/**
+ * @brief 与 ExpressiveAccumulator 相同的直接编码 Fr(x)，用于与现有 int 累加器互通。
+ */
+struct IntegerEncoding {
+    Fr operator()(int key) const { return Fr(key); }
+};
+
+// ==========================================================================================
+// KeyedAccumulator
+// ==========================================================================================
+
+/**
+ * @brief 任意键类型的 G1 累加器：P(z) = ∏(z - E(k))，E 为编码策略。
+ * @details 每个键在加入时编码一次，编码结果与键一起保存在有序表中；
+ *          增删、求值、证明与乘积树展开都直接使用缓存的 Fr，不再重复哈希。
+ *          与 ExpressiveAccumulator 一样增量维护 P(s)，增删各需一次标量乘法，证明需要 setup 的秘密 s。
+ *          Key 需支持 operator<；Encoding 为可默认构造、const 可调用的 Fr (const Key&) 函数对象。
+ */
+template <typename Key, typename Encoding = HashToField<Key>>
+class KeyedAccumulator {
+public:
+    explicit KeyedAccumulator(const ExpressiveTrustedSetup& setup, const Encoding& encoding = Encoding())
+        : trusted_setup_(setup), encoding_(encoding), poly_at_s_(1) {
+        if (!setup.hasSecret()) {
+            throw std::logic_error("KeyedAccumulator: setup has no secret to maintain P(s) with");
+        }
+        digest_.initialize(setup.getG1Generator());
+    }
+
+    /**
+     * @brief 添加键。
+     * @return 键已存在时返回 false，摘要不变。
+     */
+    bool addElement(const Key& key) {
+        auto inserted = entries_.emplace(key, Fr());
+        if (!inserted.second) return false;
+        inserted.first->second = encoding_(key);
+        poly_at_s_ *= trusted_setup_.getSecretS() - inserted.first->second;
+        updateDigest();
+        trusted_setup_.reserveDegree(entries_.size());
+        return true;
+    }
+
+    /**
+     * @brief 删除键，P(s) 除以缓存编码对应的 (s - E(k))。
+     * @return 键不存在时返回 false。
+     */
+    bool deleteElement(const Key& key) {
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return false;
+        poly_at_s_ = witnessValue(it);
+        entries_.erase(it);
+        updateDigest();
+        return true;
+    }
+
+    bool contains(const Key& key) const { return entries_.count(key) != 0; }
+    size_t size() const { return entries_.size(); }
+    const AccumulatorDigest& getDigest() const { return digest_; }
+
+    // 键及其缓存的编码，按键排序
+    const std::map<Key, Fr>& entries() const { return entries_; }
+
+    // 键的缓存编码；键不存在时返回 nullptr
+    const Fr* encoded(const Key& key) const {
+        auto it = entries_.find(key);
+        return it == entries_.end() ? nullptr : &it->second;
+    }
+
+    // 缓存的编码（即 P 的根），按键的顺序
+    std::vector<Fr> roots() const {
+        std::vector<Fr> out;
+        out.reserve(entries_.size());
+        for (const auto& entry : entries_) out.push_back(entry.second);
+        return out;
+    }
+
+    // P(z) = ∏(z - E(k))
+    Fr evaluate(const Fr& z) const {
+        Fr product = 1;
+        for (const auto& entry : entries_) product *= z - entry.second;
+        return product;
+    }
+
+    /**
+     * @brief P 的系数形式，以缓存的编码为根建乘积树。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     */
+    FrPolynomial::Poly coefficients(size_t num_threads = 0) const {
+        return FrPolynomial::fromRoots(roots(), num_threads);
+    }
+
+    /**
+     * @brief 键的成员关系证明，验证方式与 ExpressiveAccumulator 相同（元素换为编码）。
+     */
+    MembershipProof generateMembershipProof(const Key& key) const {
+        MembershipProof proof;
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return proof;
+        G2::mul(proof.witness_g2, trusted_setup_.getG2Generator(), witnessValue(it));
+        proof.is_member = true;
+        return proof;
+    }
+
+    /**
+     * @brief 一次性为多个键生成成员关系证明。
+     * @details 分母 (s - E(k)) 批量求逆，G2 标量乘法按键分块并行，见证一起规范化。
+     *          结果与 keys 一一对应，不存在的键 is_member 为 false。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     */
+    std::vector<MembershipProof> generateMembershipProofs(const std::vector<Key>& keys, size_t num_threads = 0) const {
+        std::vector<MembershipProof> proofs(keys.size());
+        std::vector<size_t> members;
+        std::vector<EntryIterator> found;
+        std::vector<Fr> roots;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            auto it = entries_.find(keys[i]);
+            if (it == entries_.end()) continue;
+            members.push_back(i);
+            found.push_back(it);
+            roots.push_back(it->second);
+        }
+        // 与 ExpressiveAccumulator 共用批量见证计算；零分母时退回单个键的路径
+        std::vector<G2> witnesses = ExpressiveAccumulator::batchWitnesses(
+            trusted_setup_, poly_at_s_, roots, [&](size_t k) { return witnessValue(found[k]); }, num_threads);
+        for (size_t k = 0; k < members.size(); ++k) {
+            proofs[members[k]].witness_g2 = witnesses[k];
+            proofs[members[k]].is_member = true;
+        }
+        return proofs;
+    }
+
+    /**
+     * @brief [静态] 验证键的成员关系证明：先编码（验证者侧每个键一次哈希），再按编码验证。
+     */
+    static bool verifyMembershipProof(const AccumulatorDigest& acc_digest, const Key& key,
+                                      const MembershipProof& proof, const ExpressiveTrustedSetup& setup,
+                                      const Encoding& encoding = Encoding()) {
+        return ExpressiveAccumulator::verifyMembershipProof(acc_digest, encoding(key), proof, setup);
+    }
+
+private:
+    typedef typename std::map<Key, Fr>::const_iterator EntryIterator;
+
+    void updateDigest() {
+        G1::mul(digest_.value, trusted_setup_.getG1Generator(), poly_at_s_);
+    }
+
+    // P(s)/(s - E(k))；s 恰为某个编码时 (s - E(k)) 为零，退回对其余编码直接求积
+    Fr witnessValue(EntryIterator it) const {
+        const Fr& secret_s = trusted_setup_.getSecretS();
+        Fr denominator = secret_s - it->second;
+        if (denominator.isZero()) {
+            Fr product = 1;
+            for (auto other = entries_.begin(); other != entries_.end(); ++other) {
+                if (other != it) product *= secret_s - other->second;
+            }
+            return product;
+        }
+        Fr witness_s;
+        Fr::div(witness_s, poly_at_s_, denominator);
+        return witness_s;
+    }
+
+    const ExpressiveTrustedSetup& trusted_setup_;
+    Encoding encoding_;
+    std::map<Key, Fr> entries_;
+    Fr poly_at_s_;
+    AccumulatorDigest digest_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // KEYED_ACCUMULATOR_H
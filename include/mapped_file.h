@@ -0,0 +1,46 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 只读内存映射文件 (POSIX mmap)。
+ * @details 整个文件映射为一段连续的只读内存，由操作系统按需换入，
+ *          多个进程映射同一文件时共享页缓存。析构时自动解除映射。
+ */
+class MappedFile {
+public:
+    /**
+     * @brief 映射文件。
+     * @param sequential 为 true 时提示内核顺序读取（积极预读）。
+     * @throws std::runtime_error 打开或映射失败时抛出。
+     */
+    explicit MappedFile(const std::string& path, bool sequential = false);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    /**
+     * @brief 边界检查后的区间指针。
+     * @throws std::out_of_range [offset, offset + length) 超出文件时抛出。
+     */
+    const uint8_t* range(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,99 @@
+#ifndef MEMORY_PLACEMENT_H
+#define MEMORY_PLACEMENT_H
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 大页使用方式。
+ * @details - NONE：普通 4 KiB 页；
+ *          - TRANSPARENT：对映射区域 madvise(MADV_HUGEPAGE)，由内核按需合并为 2 MiB 透明大页；
+ *          - EXPLICIT：从预留的 hugetlbfs 大页池分配 (MAP_HUGETLB)，大页池不足时退回 TRANSPARENT。
+ */
+enum class HugePageMode { NONE, TRANSPARENT, EXPLICIT };
+
+/**
+ * @brief 幂次表的内存放置选项。
+ * @details 多路服务器上所有核心都读取同一张多 GB 的幂次表：大页减少 TLB 缺失，
+ *          每个 NUMA 节点一份副本让读取只访问本地内存（内存占用乘以副本数）。
+ */
+struct TablePlacement {
+    HugePageMode huge_pages = HugePageMode::NONE;
+    bool numa_replicas = false; ///< 为每个 NUMA 节点保存一份副本
+    size_t replica_count = 0;   ///< 副本数，0 表示与 NUMA 节点数相同；仅 numa_replicas 为 true 时有效
+};
+
+/**
+ * @brief 基于 Linux 系统调用的内存放置与线程亲和性（不依赖 libnuma）。
+ * @details 非 Linux 平台或内核不支持时各函数退化为普通行为：节点数为 1，绑定不生效。
+ */
+namespace MemoryPlacement {
+
+const size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
+// 在线的 NUMA 节点数（至少为 1）
+size_t numaNodeCount();
+
+// 调用线程当前所在 CPU 的 NUMA 节点
+int currentNode();
+
+/**
+ * @brief 把调用线程绑定到 node 的 CPU 上。
+ * @return 节点不存在或系统不支持时返回 false，线程保持原有亲和性。
+ */
+bool bindThreadToNode(int node);
+
+/**
+ * @brief 分配以大页对齐的匿名内存，内容为零。
+ * @param node 首选的 NUMA 节点，负数表示不指定。
+ * @throws std::bad_alloc 映射失败时抛出。
+ */
+void* allocate(size_t bytes, HugePageMode mode, int node = -1);
+void release(void* ptr, size_t bytes);
+
+} // namespace MemoryPlacement
+
+/**
+ * @brief 按 TablePlacement 放置的区域分配器：从大块映射区域中顺序切分，整体释放。
+ * @details 幂次表的每个块只有几百 KiB，单独映射无法形成 2 MiB 大页，
+ *          因此先映射 REGION_BYTES 的区域再从中切分。不是线程安全的，由调用者串行化。
+ */
+class PlacedArena {
+public:
+    static constexpr size_t REGION_BYTES = size_t(32) << 20;
+
+    PlacedArena(HugePageMode mode = HugePageMode::NONE, int node = -1);
+    ~PlacedArena();
+
+    PlacedArena(const PlacedArena&) = delete;
+    PlacedArena& operator=(const PlacedArena&) = delete;
+
+    // 分配 bytes 字节，按 align（2 的幂）对齐
+    void* allocate(size_t bytes, size_t align);
+    // 释放全部区域
+    void reset();
+
+    // 已映射的字节数
+    size_t mappedBytes() const;
+    int node() const { return node_; }
+
+private:
+    struct Region {
+        uint8_t* base;
+        size_t size;
+        size_t used;
+    };
+
+    HugePageMode mode_;
+    int node_;
+    std::vector<Region> regions_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // MEMORY_PLACEMENT_H
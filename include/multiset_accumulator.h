@@ -0,0 +1,96 @@
+#ifndef MULTISET_ACCUMULATOR_H
+#define MULTISET_ACCUMULATOR_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <cstdint>
+#include <map>
+#include "expressive_accumulator.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 重数证明：证明元素 x 在多重集中至少（或恰好）出现 k 次。
+ * @details 至少 k 次：W = g2^{P(s)/(s-x)^k}，验证 e(A, g2) == e(g1^{(s-x)^k}, W)。
+ *          恰好 k 次时另给出 y = Q(x) ≠ 0（Q = P/(z-x)^k）与 W' = g2^{(Q(s)-y)/(s-x)}，
+ *          验证 e(g1, W - y·g2) == e(g1^{s-x}, W')，即 (z - x) 不再整除 Q。
+ */
+struct MultiplicityProof {
+    G2 witness_g2;                          ///< W = g2^{Q(s)}
+    G2 exact_witness_g2;                    ///< W' = g2^{(Q(s)-y)/(s-x)}，仅 exact 时有效
+    Fr remainder;                           ///< y = Q(x)，仅 exact 时有效
+    uint32_t multiplicity;                  ///< 证明覆盖的重数 k
+    bool exact;                             ///< true 表示恰好 k 次，false 表示至少 k 次
+    bool is_valid;
+
+    MultiplicityProof() : multiplicity(0), exact(false), is_valid(false) {}
+};
+
+/**
+ * @brief 多重集累加器：P(z) = ∏(z - x)^{k_x}，以 (元素, 重数) 对保存。
+ * @details 重数为 k 的元素只占一项，增删与求值都以一次 Fr::pow 计算 (s - x)^k，
+ *          代价与 k 的位数成正比，而不是逐个乘 k 次。摘要 g1^{P(s)} 增量维护，每次增删一次标量乘法。
+ *          P 的次数等于总重数，可能远大于不同元素数，因此不为它预留幂次表；证明需要 setup 的秘密 s。
+ */
+class MultisetAccumulator {
+public:
+    // @throws std::logic_error setup 没有秘密 s（由仪式文件导入）时抛出
+    explicit MultisetAccumulator(const ExpressiveTrustedSetup& setup);
+
+    /**
+     * @brief 把 element 的重数增加 count。
+     * @throws std::invalid_argument count 为 0 或重数超过 UINT32_MAX 时抛出。
+     */
+    void addElement(int element, uint32_t count = 1);
+
+    /**
+     * @brief 把 element 的重数减少 count，减到 0 时移除该元素。
+     * @return 当前重数小于 count 时返回 false，状态不变。
+     * @throws std::invalid_argument count 为 0 时抛出。
+     */
+    bool removeElement(int element, uint32_t count = 1);
+
+    // element 的重数，不存在时为 0
+    uint32_t multiplicity(int element) const;
+    // 不同元素数与总重数（即 P 的次数）
+    size_t distinctCount() const { return counts.size(); }
+    uint64_t totalCount() const { return total_count; }
+    const std::map<int, uint32_t>& getCounts() const { return counts; }
+    const AccumulatorDigest& getDigest() const { return digest; }
+
+    // P(z) = ∏(z - x)^{k_x}，每个不同元素一次 Fr::pow
+    Fr evaluate(const Fr& z) const;
+
+    /**
+     * @brief 生成 element 至少（exact 为 true 时恰好）出现 k 次的证明。
+     * @return 重数小于 k（或 exact 时不等于 k）时 is_valid 为 false。
+     * @throws std::invalid_argument k 为 0 时抛出。
+     */
+    MultiplicityProof generateMultiplicityProof(int element, uint32_t k, bool exact = false) const;
+
+    /**
+     * @brief [静态] 验证重数证明，e(A, g2) 经由 setup 的配对缓存计算。
+     */
+    static bool verifyMultiplicityProof(const AccumulatorDigest& acc_digest,
+                                        int element,
+                                        const MultiplicityProof& proof,
+                                        const ExpressiveTrustedSetup& setup);
+
+private:
+    // P(s)/(s - x)^k；(s - x) 为零时对其余因子直接求值
+    Fr quotientValue(int element, uint32_t k) const;
+    void updateDigest();
+
+    const ExpressiveTrustedSetup& trusted_setup;
+    std::map<int, uint32_t> counts;
+    uint64_t total_count;
+    Fr poly_at_s; // 缓存的 P(s)
+    AccumulatorDigest digest;
+};
+
+} // namespace expressive_accumulator
+
+#endif // MULTISET_ACCUMULATOR_H
@@ -0,0 +1,80 @@
+#ifndef PAIRING_CACHE_H
+#define PAIRING_CACHE_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 配对缓存的计数器快照。
+ */
+struct PairingCacheStats {
+    uint64_t hits = 0;      ///< 直接返回缓存 GT 值的次数
+    uint64_t misses = 0;    ///< 需要计算配对的次数
+    uint64_t evictions = 0; ///< 因容量不足淘汰的条目数
+    size_t entries = 0;     ///< 当前缓存的条目数
+};
+
+/**
+ * @brief e(P, Q) 的有界 LRU 缓存，Q 为固定的 G2 底点（可信设置中即 g2 生成元）。
+ * @details 验证者经常用同一个摘要 A 检查大量证明，每次都要重新计算 e(A, g2)。
+ *          缓存以 P 的序列化字节为键保存 GT 值，命中时不做配对；
+ *          未命中时用 Q 预先计算好的 Miller 循环直线系数求值，省去 G2 上的点运算。
+ *          Q 改变时直线系数重新计算，已缓存的 GT 值全部作废。
+ *          所有方法线程安全；配对在锁外计算。
+ */
+class PairingCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 1024;
+
+    explicit PairingCache(size_t capacity = DEFAULT_CAPACITY);
+
+    PairingCache(const PairingCache&) = delete;
+    PairingCache& operator=(const PairingCache&) = delete;
+
+    /**
+     * @brief out = e(P, Q)。
+     * @details 容量为 0 时不缓存 GT 值，只使用 Q 的预计算直线。
+     */
+    void pairing(GT& out, const G1& P, const G2& Q);
+
+    // 修改容量，超出的最久未用条目立即淘汰
+    void setCapacity(size_t capacity);
+    size_t capacity() const;
+
+    // 清空条目与计数器
+    void clear();
+
+    PairingCacheStats stats() const;
+
+private:
+    typedef std::list<std::pair<std::string, GT>> EntryList;
+
+    // 必要时为 Q 重新计算直线系数，返回当前系数的快照；调用者持有 mutex_
+    std::shared_ptr<const std::vector<Fp6>> bindBase(const G2& Q);
+    void evictOverflow();
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    bool bound_;
+    G2 base_;
+    std::shared_ptr<const std::vector<Fp6>> lines_;
+    EntryList entries_; // 最近使用的在前
+    std::unordered_map<std::string, EntryList::iterator> index_;
+    PairingCacheStats stats_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // PAIRING_CACHE_H
@@ -0,0 +1,366 @@
+#ifndef POWER_TABLE_H
+#define POWER_TABLE_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "affine_msm.h"
+#include "batch_inversion.h"
+#include "memory_placement.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 可信设置幂次表 g^{s^i} 的内存存储方式。
+ * @details 以 G1 为例（Fp 为 48 字节）：
+ *          - JACOBIAN：直接保存 mcl 点 (x, y, z)，144 字节/点，读取无额外开销；
+ *          - AFFINE：规范化后只保存 (x, y)，96 字节/点，节省约 33%；
+ *            x、y 分别存放在按缓存行对齐的数组中 (SoA)，大规模多标量乘法直接在其上做批量仿射累加；
+ *          - COMPRESSED：mcl 压缩序列化格式，48 字节/点，节省约 67%，
+ *            读取时需要一次开平方恢复 y 坐标（并做子群检查），代价最高。
+ *          G2 的比例相同（288 / 192 / 96 字节）。
+ */
+enum class PowerStorage { JACOBIAN, AFFINE, COMPRESSED };
+
+/**
+ * @brief 按 PowerStorage 保存的点表，多标量乘法按块解压。
+ * @details 点按 CHUNK_SIZE 分块存放，每块一次性分配定长缓冲区，追加时已有数据从不搬移。
+ *          写入者（append）之间由互斥锁串行化；读取者完全无锁：
+ *          新块的指针和点数 count 都以 release 语义发布，读取者以 acquire 语义读取 count，
+ *          只访问其之前的点，因此可以在表后台扩展的同时并发读取和做多标量乘法。
+ *          多标量乘法每次只把一块解码到临时缓冲区，压缩存储下峰值内存与表长无关。
+ *          块缓冲区从 PlacedArena 切分，可按 TablePlacement 使用大页，并为每个 NUMA 节点保存一份副本：
+ *          读取者使用所在节点的副本，多标量乘法的工作线程按副本绑定到对应节点。
+ *          G 为 G1 或 G2。
+ */
+template <typename G>
+class PowerTable {
+public:
+    typedef typename G::Fp Coord;
+
+    // 每块的点数，也是多标量乘法时每次解码的点数
+    static constexpr size_t CHUNK_SIZE = 1 << 12;
+    static constexpr size_t MSM_BLOCK = CHUNK_SIZE;
+    // 块目录容量，表长上限为 MAX_CHUNKS · CHUNK_SIZE = 2^26
+    static constexpr size_t MAX_CHUNKS = 1 << 14;
+    // 单个压缩点的最大字节数（G2 为 96）
+    static constexpr size_t MAX_POINT_BYTES = 192;
+    // AFFINE 存储下达到该点数的多标量乘法改用批量仿射累加 (AffineMsm)
+    static constexpr size_t BATCH_AFFINE_MIN_POINTS = 1 << 12;
+
+    explicit PowerTable(PowerStorage storage = PowerStorage::JACOBIAN,
+                        const TablePlacement& placement = TablePlacement())
+        : storage_(storage), placement_(placement), count_(0), point_bytes_(0) {
+        size_t replicas = 1;
+        if (placement.numa_replicas) {
+            replicas = placement.replica_count != 0 ? placement.replica_count : MemoryPlacement::numaNodeCount();
+        }
+        const size_t nodes = MemoryPlacement::numaNodeCount();
+        for (size_t r = 0; r < replicas; ++r) {
+            const int node = placement.numa_replicas ? static_cast<int>(r % nodes) : -1;
+            replicas_.emplace_back(new Replica(placement.huge_pages, node));
+        }
+    }
+
+    ~PowerTable() { releaseChunks(); }
+
+    PowerTable(const PowerTable&) = delete;
+    PowerTable& operator=(const PowerTable&) = delete;
+
+    PowerStorage storage() const { return storage_; }
+    const TablePlacement& placement() const { return placement_; }
+    size_t replicaCount() const { return replicas_.size(); }
+    size_t size() const { return count_.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+
+    // 清空表；调用时不能有并发的读取者
+    void clear() {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        releaseChunks();
+        count_.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief 追加 n 个点。AFFINE/COMPRESSED 模式下先批量规范化，只保留仿射坐标。
+     * @param num_threads 规范化使用的线程数，0 表示使用硬件并发数。
+     * @throws std::length_error 超过表长上限时抛出。
+     */
+    void append(const G* points, size_t n, size_t num_threads = 1) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        const size_t begin = count_.load(std::memory_order_relaxed);
+        if (n > MAX_CHUNKS * CHUNK_SIZE - begin) {
+            throw std::length_error("PowerTable: table capacity exceeded");
+        }
+        std::vector<G> normalized;
+        if (storage_ != PowerStorage::JACOBIAN) {
+            normalized.assign(points, points + n);
+            BatchInversion::normalizePoints(normalized, num_threads);
+            points = normalized.data();
+        }
+        // 每个副本都写入，全部完成后才发布新的点数
+        for (auto& replica : replicas_) {
+            for (size_t k = 0; k < n; ++k) {
+                const size_t i = begin + k;
+                Chunk* chunk = replica->chunks[i / CHUNK_SIZE].load(std::memory_order_relaxed);
+                if (chunk == nullptr) {
+                    chunk = newChunk(*replica, points[k]);
+                    replica->chunks[i / CHUNK_SIZE].store(chunk, std::memory_order_release);
+                }
+                encode(*chunk, i % CHUNK_SIZE, points[k]);
+            }
+        }
+        count_.store(begin + n, std::memory_order_release);
+    }
+
+    void append(const std::vector<G>& points, size_t num_threads = 1) {
+        append(points.data(), points.size(), num_threads);
+    }
+
+    /**
+     * @brief 读取第 i 个点。
+     * @throws std::out_of_range 下标越界时抛出。
+     */
+    G get(size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("PowerTable: index out of range");
+        }
+        G P;
+        decode(P, i, localReplica());
+        return P;
+    }
+
+    G operator[](size_t i) const { return get(i); }
+
+    // 把第 [begin, begin + count) 个点解码到 out
+    void getBlock(G* out, size_t begin, size_t count) const {
+        const size_t n = size();
+        if (begin > n || count > n - begin) {
+            throw std::out_of_range("PowerTable: block out of range");
+        }
+        const Replica& replica = localReplica();
+        for (size_t k = 0; k < count; ++k) decode(out[k], begin + k, replica);
+    }
+
+    // 已写入的点数据占用的字节数（含全部副本）
+    size_t memoryBytes() const {
+        const size_t n = size() * replicas_.size();
+        switch (storage_) {
+        case PowerStorage::JACOBIAN: return n * sizeof(G);
+        case PowerStorage::AFFINE: return n * (2 * sizeof(Coord) + 1);
+        default: return n * point_bytes_;
+        }
+    }
+
+    // 为块缓冲区映射的字节数（含全部副本，按区域计）
+    size_t mappedBytes() const {
+        size_t total = 0;
+        for (const auto& replica : replicas_) total += replica->arena.mappedBytes();
+        return total;
+    }
+
+    /**
+     * @brief 多标量乘法 out = Σ coeffs[i]·P_i，i < n。
+     * @details 各线程轮流领取 MSM_BLOCK 大小的块，解码后调用 mcl 的 mulVec，最后累加各线程的部分和；
+     *          AFFINE 存储且点数不少于 BATCH_AFFINE_MIN_POINTS 时改用 AffineMsm。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     * @throws std::invalid_argument n 超过表长时抛出。
+     */
+    void multiExp(G& out, const Fr* coeffs, size_t n, size_t num_threads = 0) const {
+        multiExpRange(out, coeffs, 0, n, num_threads);
+    }
+
+    /**
+     * @brief 只对第 [first, last) 个点做多标量乘法：out = Σ coeffs[i - first]·P_i。
+     * @throws std::invalid_argument 区间超过表长时抛出。
+     */
+    void multiExpRange(G& out, const Fr* coeffs, size_t first, size_t last, size_t num_threads = 0) const {
+        if (first > last || last > size()) {
+            throw std::invalid_argument("PowerTable::multiExp: more coefficients than table entries");
+        }
+        out.clear();
+        const size_t n = last - first;
+        if (n == 0) return;
+
+        if (storage_ == PowerStorage::AFFINE && n >= BATCH_AFFINE_MIN_POINTS) {
+            // 直接在各块的 x[]、y[] 数组上累加，不解码为 mcl 点；每个副本一组区间
+            std::vector<AffineReplica<Coord>> replicas(replicas_.size());
+            for (size_t r = 0; r < replicas_.size(); ++r) {
+                replicas[r].node = replicas_[r]->arena.node();
+                for (size_t i = first; i < last;) {
+                    const Chunk& chunk = *replicas_[r]->chunks[i / CHUNK_SIZE].load(std::memory_order_acquire);
+                    const size_t slot = i % CHUNK_SIZE;
+                    const size_t cnt = std::min(CHUNK_SIZE - slot, last - i);
+                    replicas[r].spans.push_back(AffineSpan<Coord>{chunk.xs + slot, chunk.ys + slot,
+                                                                  chunk.infinity + slot, coeffs + (i - first), cnt});
+                    i += cnt;
+                }
+            }
+            AffineMsm::multiExp(out, replicas, num_threads);
+            return;
+        }
+
+        const size_t num_blocks = (n + MSM_BLOCK - 1) / MSM_BLOCK;
+        if (num_threads == 0) {
+            num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        num_threads = std::min(num_threads, num_blocks);
+
+        std::vector<G> partial(num_threads);
+        auto worker = [&](size_t t) {
+            // 有多个副本时把线程轮流绑定到各副本所在的节点，getBlock 随后读取本地副本
+            if (replicas_.size() > 1) {
+                MemoryPlacement::bindThreadToNode(replicas_[t % replicas_.size()]->arena.node());
+            }
+            std::vector<G> scratch(std::min(n, MSM_BLOCK));
+            partial[t].clear();
+            for (size_t b = t; b < num_blocks; b += num_threads) {
+                const size_t begin = b * MSM_BLOCK;
+                const size_t cnt = std::min(MSM_BLOCK, n - begin);
+                getBlock(scratch.data(), first + begin, cnt);
+                G block_sum;
+                G::mulVec(block_sum, scratch.data(), coeffs + begin, cnt);
+                partial[t] += block_sum;
+            }
+        };
+
+        if (num_threads <= 1 && replicas_.size() <= 1) {
+            worker(0);
+        } else {
+            // 亲和性只施加在工作线程上，不改变调用者线程
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < num_threads; ++t) threads.emplace_back(worker, t);
+            for (auto& th : threads) th.join();
+        }
+        for (const G& P : partial) out += P;
+    }
+
+private:
+    // 一块定长缓冲区，只分配当前存储方式用到的数组；缓冲区属于副本的 arena
+    struct Chunk {
+        G* points = nullptr;         // JACOBIAN
+        Coord* xs = nullptr;         // AFFINE：SoA 坐标，按缓存行对齐
+        Coord* ys = nullptr;
+        uint8_t* infinity = nullptr; // AFFINE：无穷远点标记
+        uint8_t* bytes = nullptr;    // COMPRESSED：定长压缩点
+    };
+
+    // 一份完整的块目录及其内存
+    struct Replica {
+        PlacedArena arena;
+        std::unique_ptr<std::atomic<Chunk*>[]> chunks;
+
+        Replica(HugePageMode mode, int node) : arena(mode, node), chunks(new std::atomic<Chunk*>[MAX_CHUNKS]) {
+            for (size_t c = 0; c < MAX_CHUNKS; ++c) chunks[c].store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+    // 调用线程所在节点的副本
+    const Replica& localReplica() const {
+        if (replicas_.size() == 1) return *replicas_[0];
+        return *replicas_[static_cast<size_t>(MemoryPlacement::currentNode()) % replicas_.size()];
+    }
+
+    template <typename T>
+    static T* allocArray(PlacedArena& arena, size_t n) {
+        T* p = static_cast<T*>(arena.allocate(n * sizeof(T), std::max(alignof(T), CACHE_LINE_BYTES)));
+        for (size_t i = 0; i < n; ++i) new (p + i) T();
+        return p;
+    }
+
+    Chunk* newChunk(Replica& replica, const G& sample) {
+        std::unique_ptr<Chunk> chunk(new Chunk);
+        switch (storage_) {
+        case PowerStorage::JACOBIAN:
+            chunk->points = allocArray<G>(replica.arena, CHUNK_SIZE);
+            break;
+        case PowerStorage::AFFINE:
+            chunk->xs = allocArray<Coord>(replica.arena, CHUNK_SIZE);
+            chunk->ys = allocArray<Coord>(replica.arena, CHUNK_SIZE);
+            chunk->infinity = allocArray<uint8_t>(replica.arena, CHUNK_SIZE);
+            break;
+        case PowerStorage::COMPRESSED:
+            if (point_bytes_ == 0) {
+                uint8_t buf[MAX_POINT_BYTES];
+                point_bytes_ = sample.serialize(buf, sizeof(buf));
+                if (point_bytes_ == 0) {
+                    throw std::runtime_error("PowerTable: point serialization failed");
+                }
+            }
+            chunk->bytes = allocArray<uint8_t>(replica.arena, CHUNK_SIZE * point_bytes_);
+            break;
+        }
+        return chunk.release();
+    }
+
+    void encode(Chunk& chunk, size_t slot, const G& P) {
+        switch (storage_) {
+        case PowerStorage::JACOBIAN:
+            chunk.points[slot] = P;
+            break;
+        case PowerStorage::AFFINE:
+            chunk.xs[slot] = P.x;
+            chunk.ys[slot] = P.y;
+            chunk.infinity[slot] = P.isZero() ? 1 : 0;
+            break;
+        case PowerStorage::COMPRESSED:
+            if (P.serialize(chunk.bytes + slot * point_bytes_, point_bytes_) != point_bytes_) {
+                throw std::runtime_error("PowerTable: point serialization failed");
+            }
+            break;
+        }
+    }
+
+    void decode(G& P, size_t i, const Replica& replica) const {
+        const Chunk& chunk = *replica.chunks[i / CHUNK_SIZE].load(std::memory_order_acquire);
+        const size_t slot = i % CHUNK_SIZE;
+        switch (storage_) {
+        case PowerStorage::JACOBIAN:
+            P = chunk.points[slot];
+            break;
+        case PowerStorage::AFFINE:
+            if (chunk.infinity[slot]) {
+                P.clear();
+            } else {
+                P.x = chunk.xs[slot];
+                P.y = chunk.ys[slot];
+                P.z = 1;
+            }
+            break;
+        case PowerStorage::COMPRESSED:
+            if (P.deserialize(chunk.bytes + slot * point_bytes_, point_bytes_) == 0) {
+                throw std::runtime_error("PowerTable: corrupted compressed point");
+            }
+            break;
+        }
+    }
+
+    void releaseChunks() {
+        for (auto& replica : replicas_) {
+            for (size_t c = 0; c < MAX_CHUNKS; ++c) {
+                delete replica->chunks[c].exchange(nullptr, std::memory_order_relaxed);
+            }
+            replica->arena.reset();
+        }
+    }
+
+    PowerStorage storage_;
+    TablePlacement placement_;
+    std::atomic<size_t> count_;
+    size_t point_bytes_;
+    std::vector<std::unique_ptr<Replica>> replicas_;
+    std::mutex write_mutex_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // POWER_TABLE_H
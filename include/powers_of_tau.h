@@ -0,0 +1,59 @@
+#ifndef POWERS_OF_TAU_H
+#define POWERS_OF_TAU_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <cstdint>
+#include "power_table.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 支持导入的 BLS12-381 powers-of-tau 仪式文件格式。
+ * @details
+ *  - SNARKJS_PTAU：snarkjs 的 .ptau 容器。"ptau" 魔数、版本、分节表；
+ *    第 1 节为头部 (n8, q, power, ceremonyPower)，第 2 节为 2·2^power - 1 个 τ^i·G1，
+ *    第 3 节为 2^power 个 τ^i·G2。点为未压缩仿射坐标，每个 Fp 为 n8 字节小端 Montgomery 形式
+ *    (R = 2^{8·n8})，Fp2 按 c0, c1 顺序存放，全零表示无穷远点。
+ *  - POWERSOFTAU_RESPONSE：Zcash powersoftau 的 response 文件（BLS12-381 版本）。
+ *    64 字节的上一轮 challenge 哈希之后，依次为 2·2^power - 1 个压缩 G1 点与 2^power 个压缩 G2 点，
+ *    采用 Zcash 压缩编码：大端 x 坐标（Fp2 先 c1 后 c0），首字节最高 3 位依次为
+ *    压缩 / 无穷远 / y 取字典序较大者 标志。其后的 α、β 幂次不需要导入。
+ */
+enum class PtauFormat { SNARKJS_PTAU, POWERSOFTAU_RESPONSE };
+
+/**
+ * @brief 导入选项。
+ */
+struct PtauImportOptions {
+    PtauFormat format = PtauFormat::SNARKJS_PTAU;
+    size_t max_degree = 0;                         ///< 只导入到该次数，0 表示导入文件中的全部幂次
+    PowerStorage storage = PowerStorage::AFFINE;   ///< 幂次表的存储方式
+    TablePlacement placement;                      ///< 幂次表的大页与 NUMA 副本选项
+    size_t num_threads = 0;                        ///< 解压与子群检查的线程数，0 表示使用硬件并发数
+    size_t ceremony_power = 0;                     ///< 仅 POWERSOFTAU_RESPONSE：仪式规模 2^power
+};
+
+/**
+ * @brief Zcash 压缩编码的点编解码。
+ * @details 解码时由 x 求出 y（开平方）并按标志位选取符号，随后检查点在曲线上且属于 r 阶子群；
+ *          任一步失败都返回 false。
+ */
+namespace PowersOfTau {
+
+const size_t G1_COMPRESSED_BYTES = 48;
+const size_t G2_COMPRESSED_BYTES = 96;
+
+bool decodeG1(G1& P, const uint8_t* buf);
+bool decodeG2(G2& P, const uint8_t* buf);
+void encodeG1(uint8_t* buf, const G1& P);
+void encodeG2(uint8_t* buf, const G2& P);
+
+} // namespace PowersOfTau
+
+} // namespace expressive_accumulator
+
+#endif // POWERS_OF_TAU_H
@@ -0,0 +1,167 @@
+#ifndef PRECOMPUTED_MSM_H
+#define PRECOMPUTED_MSM_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "batch_inversion.h"
+#include "power_table.h"
+#include "scalar_digits.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 固定底点的预计算多标量乘法。
+ * @details 对每个底点 P_i 预先保存 2^{w·j}·P_i（j < D = ⌈256/w⌉，已规范化为仿射坐标）。
+ *          标量按 w 位有符号窗口重新编码为 D 个数字 d_j ∈ [-2^{w-1}, 2^{w-1}]，
+ *          于是 Σ c_i·P_i = Σ_d d·(Σ_{d_{ij} = d} 2^{w·j}·P_i)：
+ *          每个非零数字只做一次点加（取负不需要代价）进入 2^{w-1} 个桶之一，
+ *          最后以前缀和合并桶，整个过程没有倍点运算。
+ *          代价约为 n·D 次混合点加加上 2^w 次点加；内存为每个底点 D 个点。
+ *          建表后只读，可以被多个线程并发使用。G 为 G1 或 G2。
+ */
+template <typename G>
+class PrecomputedMsm {
+public:
+    static constexpr size_t MIN_WINDOW = 2;
+    static constexpr size_t MAX_WINDOW = 16;
+
+    PrecomputedMsm() : window_(0), digits_(0), count_(0) {}
+
+    static size_t digitsPerScalar(size_t window) { return ScalarDigits::digitCount(window); }
+
+    // 每个底点的预计算表所占字节数
+    static size_t bytesPerBase(size_t window) { return digitsPerScalar(window) * sizeof(G); }
+
+    size_t size() const { return count_; }
+    size_t window() const { return window_; }
+    size_t memoryBytes() const { return table_.size() * sizeof(G); }
+
+    /**
+     * @brief 为 bases 的前 count 个点建表。
+     * @param window 窗口宽度 w，取值 [MIN_WINDOW, MAX_WINDOW]。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     * @throws std::invalid_argument 窗口宽度不合法或 count 超过表长时抛出。
+     */
+    void build(const PowerTable<G>& bases, size_t count, size_t window, size_t num_threads = 0) {
+        if (window < MIN_WINDOW || window > MAX_WINDOW) {
+            throw std::invalid_argument("PrecomputedMsm: window out of range");
+        }
+        if (count > bases.size()) {
+            throw std::invalid_argument("PrecomputedMsm: more bases than table entries");
+        }
+        window_ = window;
+        digits_ = digitsPerScalar(window);
+        count_ = count;
+        table_.assign(count * digits_, G());
+        if (num_threads == 0) {
+            num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        // 每个底点 w 次倍点得到下一个窗口的倍点
+        auto worker = [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                G* row = table_.data() + i * digits_;
+                row[0] = bases.get(i);
+                for (size_t j = 1; j < digits_; ++j) {
+                    G::dbl(row[j], row[j - 1]);
+                    for (size_t k = 1; k < window_; ++k) G::dbl(row[j], row[j]);
+                }
+            }
+        };
+        const size_t threads_used = std::max<size_t>(1, std::min(num_threads, count));
+        if (threads_used <= 1) {
+            worker(0, count);
+        } else {
+            std::vector<std::thread> threads;
+            size_t chunk = (count + threads_used - 1) / threads_used;
+            for (size_t lo = 0; lo < count; lo += chunk) {
+                threads.emplace_back(worker, lo, std::min(lo + chunk, count));
+            }
+            for (auto& t : threads) t.join();
+        }
+        // 仿射坐标使桶累加成为混合点加
+        BatchInversion::normalizePoints(table_, num_threads);
+    }
+
+    /**
+     * @brief out = Σ coeffs[i]·P_i，i < n。
+     * @details 底点按线程划分，每个线程独立累加自己的桶；桶数固定为 2^{w-1}，
+     *          因此只在每个线程分到的点加次数明显多于桶合并代价时才增加线程。
+     * @param num_threads 线程数，0 表示使用硬件并发数。
+     * @throws std::invalid_argument n 超过预计算的底点数时抛出。
+     */
+    void multiExp(G& out, const Fr* coeffs, size_t n, size_t num_threads = 0) const {
+        if (n > count_) {
+            throw std::invalid_argument("PrecomputedMsm::multiExp: more coefficients than precomputed bases");
+        }
+        out.clear();
+        if (n == 0) return;
+
+        if (num_threads == 0) {
+            num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        const size_t work_per_bucket_pass = size_t(1) << (window_ + 1);
+        num_threads = std::max<size_t>(1, std::min(num_threads, n * digits_ / work_per_bucket_pass));
+
+        std::vector<G> partial(num_threads);
+        auto worker = [&](size_t t, size_t lo, size_t hi) {
+            std::vector<G> buckets(size_t(1) << (window_ - 1));
+            for (auto& B : buckets) B.clear();
+            std::vector<int32_t> digits(digits_);
+            for (size_t i = lo; i < hi; ++i) {
+                if (coeffs[i].isZero()) continue;
+                ScalarDigits::signedWindows(digits.data(), coeffs[i], window_);
+                const G* row = table_.data() + i * digits_;
+                for (size_t j = 0; j < digits_; ++j) {
+                    const int32_t d = digits[j];
+                    if (d > 0) {
+                        buckets[d - 1] += row[j];
+                    } else if (d < 0) {
+                        buckets[-d - 1] -= row[j];
+                    }
+                }
+            }
+            // Σ_d d·B_d = Σ_d (B_d + B_{d+1} + ...)
+            G running, sum;
+            running.clear();
+            sum.clear();
+            for (size_t d = buckets.size(); d-- > 0;) {
+                running += buckets[d];
+                sum += running;
+            }
+            partial[t] = sum;
+        };
+
+        if (num_threads <= 1) {
+            worker(0, 0, n);
+        } else {
+            std::vector<std::thread> threads;
+            size_t chunk = (n + num_threads - 1) / num_threads;
+            for (size_t t = 0; t < num_threads; ++t) {
+                const size_t lo = std::min(n, t * chunk);
+                threads.emplace_back(worker, t, lo, std::min(n, lo + chunk));
+            }
+            for (auto& th : threads) th.join();
+        }
+        for (const G& P : partial) out += P;
+    }
+
+private:
+    size_t window_;
+    size_t digits_;
+    size_t count_;
+    // 底点 i 的第 j 个窗口倍点位于 i·D + j
+    std::vector<G> table_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // PRECOMPUTED_MSM_H
@@ -0,0 +1,169 @@
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#pragma once
+
+#include "expressive_accumulator.h"
+#include <map>
+#include <memory>
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 查询表达式中的集合运算类型。
+ */
+enum class QueryOp { LEAF, INTERSECT, UNION, DIFFERENCE };
+
+/**
+ * @brief 累加器上的布尔查询表达式树。
+ * @details 语法（差集与并集同级且左结合，交集优先级更高）：
+ *            expr   := term (('|' | '∪' | '-' | '\\') term)*
+ *            term   := factor (('&' | '∩') factor)*
+ *            factor := 名称 | '(' expr ')'
+ *          同类的交集/并集在解析时被展平为多元节点，便于查询计划重新排序。
+ */
+struct QueryExpr {
+    QueryOp op;
+    std::string name;                                   ///< 叶子节点对应的累加器名称
+    std::vector<std::shared_ptr<QueryExpr>> children;   ///< 子表达式，差集恰有两个
+
+    QueryExpr() : op(QueryOp::LEAF) {}
+
+    /**
+     * @brief 解析查询表达式。
+     * @throws std::invalid_argument 表达式语法错误时抛出。
+     */
+    static std::shared_ptr<QueryExpr> parse(const std::string& text);
+
+    /**
+     * @brief 规范形式：交集/并集的操作数展平并排序，语义相同的表达式得到相同的字符串。
+     */
+    std::string canonical() const;
+};
+
+/**
+ * @brief 复合证明中的一个节点，对应查询计划中的一次二元运算或一个输入累加器。
+ * @details 三种二元运算都基于左右两个子结果的交集证明 (I = L ∩ R)：
+ *          - INTERSECT：结果即 I；
+ *          - UNION：结果 U = R · (L/I)，验证 e(U, g2) == e(R, W_QA)；
+ *          - DIFFERENCE：结果 D = L/I，验证 e(D, g2) == e(g1, W_QA)。
+ */
+struct QueryProofNode {
+    QueryOp op;
+    int left;                           ///< 左子节点下标，叶子为 -1
+    int right;                          ///< 右子节点下标，叶子为 -1
+    std::string leaf_name;              ///< 叶子节点对应的累加器名称
+    AccumulatorDigest digest;           ///< 该子表达式结果的摘要
+    IntersectionProof intersection;     ///< 左右子结果的交集证明 (叶子节点不使用)
+
+    QueryProofNode() : op(QueryOp::LEAF), left(-1), right(-1) {}
+};
+
+/**
+ * @brief 整个查询表达式的复合证明。
+ * @details nodes 按拓扑序排列（子节点总在父节点之前），公共子表达式只出现一次。
+ */
+struct CompositeQueryProof {
+    std::vector<QueryProofNode> nodes;
+    int root;
+    std::set<int> result;   ///< 查询结果集合
+    bool is_valid;
+
+    CompositeQueryProof() : root(-1), is_valid(false) {}
+};
+
+/**
+ * @brief 带查询计划优化的证明查询引擎。
+ * @details 对表达式树求值时：
+ *          - 多元交集按子结果集合大小从小到大依次求交，使中间多项式尽可能小；
+ *          - 以规范形式为键缓存每个子表达式的结果集合、摘要与证明节点，
+ *            相同的子表达式（包括交集链的公共前缀）只计算一次。
+ */
+class QueryEngine {
+public:
+    explicit QueryEngine(const ExpressiveTrustedSetup& setup);
+
+    /**
+     * @brief 以名称注册参与查询的累加器 (调用方负责其生命周期)。
+     */
+    void registerAccumulator(const std::string& name, const ExpressiveAccumulator& acc);
+
+    /**
+     * @brief 求值查询表达式并生成复合证明。
+     * @throws std::invalid_argument 表达式语法错误或引用了未注册的累加器时抛出。
+     */
+    CompositeQueryProof evaluate(const std::string& expression) const;
+    CompositeQueryProof evaluate(const QueryExpr& expression) const;
+
+    /**
+     * @brief [静态] 验证复合证明。
+     * @details 逐节点验证集合运算关系，并核对证明的计划与表达式语义一致、
+     *          根节点摘要与声明的结果集合一致。
+     * @param expression 查询表达式。
+     * @param digests 各输入累加器的摘要，按名称索引。
+     */
+    static bool verify(const std::string& expression,
+                       const std::map<std::string, AccumulatorDigest>& digests,
+                       const CompositeQueryProof& proof,
+                       const ExpressiveTrustedSetup& setup);
+
+private:
+    struct PlanContext;
+    int evaluateNode(const QueryExpr& expr, PlanContext& ctx) const;
+    int combine(QueryOp op, int left, int right, PlanContext& ctx) const;
+
+    const ExpressiveTrustedSetup& trusted_setup;
+    std::map<std::string, const ExpressiveAccumulator*> accumulators;
+};
+
+/**
+ * @brief 门限 (t-of-k) 成员查询的聚合证明。
+ * @details 对每个累加器 A_i 给出结果集合在其中的部分 S_i = R ∩ A_i 及子集见证
+ *          W_i = g2^{A_i(s)/S_i(s)}。验证者用 Fiat-Shamir 随机系数 ρ_i 将 k 个等式
+ *          e(A_i, g2) == e(g1, W_i)^{S_i(s)} 合并为
+ *          e(Σ ρ_i·A_i, g2) == e(g1, Σ ρ_i·S_i(s)·W_i)，
+ *          只需两次多标量乘法和两次配对，配对次数与 k 无关。
+ */
+struct ThresholdQueryProof {
+    size_t threshold;
+    std::set<int> result;                   ///< 至少出现在 threshold 个集合中的元素
+    std::vector<std::set<int>> subsets;     ///< S_i = result ∩ A_i
+    std::vector<G2> witnesses;              ///< W_i = g2^{A_i(s)/S_i(s)}
+    bool is_valid;
+
+    ThresholdQueryProof() : threshold(0), is_valid(false) {}
+};
+
+/**
+ * @brief vChain 式订阅的门限查询：返回至少出现在 t 个累加器中的元素。
+ * @details 证明只保证结果中每个元素确实至少属于 t 个集合（可靠性），
+ *          不证明结果之外不存在满足条件的元素。
+ */
+class ThresholdQuery {
+public:
+    /**
+     * @brief 生成门限查询结果及其聚合证明。
+     * @param accs 参与查询的 k 个累加器。
+     * @param threshold 门限 t，取值范围 [1, k]。
+     */
+    static ThresholdQueryProof generate(const std::vector<const ExpressiveAccumulator*>& accs,
+                                        size_t threshold,
+                                        const ExpressiveTrustedSetup& setup);
+
+    /**
+     * @brief [静态] 验证门限查询证明。
+     * @param digests k 个累加器的摘要，顺序与生成证明时一致。
+     */
+    static bool verify(const std::vector<AccumulatorDigest>& digests,
+                       const ThresholdQueryProof& proof,
+                       const ExpressiveTrustedSetup& setup);
+
+private:
+    // Fiat-Shamir 随机系数，绑定全部摘要、门限、各子集与见证
+    static std::vector<Fr> challenges(const std::vector<AccumulatorDigest>& digests,
+                                      const ThresholdQueryProof& proof);
+};
+
+} // namespace expressive_accumulator
+
+#endif // QUERY_ENGINE_H
@@ -0,0 +1,54 @@
+#ifndef SCALAR_DIGITS_H
+#define SCALAR_DIGITS_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 多标量乘法用的标量窗口编码。
+ */
+namespace ScalarDigits {
+
+const size_t SCALAR_BYTES = 32;
+// 有符号窗口编码可能在最高位产生进位，按 256 位计
+const size_t SCALAR_BITS = 256;
+
+inline size_t digitCount(size_t window) { return (SCALAR_BITS + window - 1) / window; }
+
+/**
+ * @brief 标量的 w 位有符号窗口编码：c = Σ d_j·2^{w·j}，d_j ∈ [-2^{w-1}, 2^{w-1}]。
+ * @details 负数字只需对点取负，桶的数量因此减半。window 取值 [1, 16]，
+ *          digits 需要 digitCount(window) 个元素。
+ */
+inline void signedWindows(int32_t* digits, const Fr& c, size_t window) {
+    uint8_t bytes[SCALAR_BYTES + 4] = {0};
+    if (c.serialize(bytes, SCALAR_BYTES) == 0) {
+        throw std::runtime_error("ScalarDigits: scalar serialization failed");
+    }
+    const size_t count = digitCount(window);
+    const int32_t half = int32_t(1) << (window - 1);
+    const uint32_t mask = (uint32_t(1) << window) - 1;
+    int32_t carry = 0;
+    for (size_t j = 0; j < count; ++j) {
+        const size_t bit = j * window;
+        const size_t byte = bit / 8;
+        uint32_t raw = uint32_t(bytes[byte]) | (uint32_t(bytes[byte + 1]) << 8) |
+                       (uint32_t(bytes[byte + 2]) << 16);
+        int32_t d = static_cast<int32_t>((raw >> (bit % 8)) & mask) + carry;
+        carry = d > half ? 1 : 0;
+        digits[j] = d - (carry << window);
+    }
+}
+
+} // namespace ScalarDigits
+
+} // namespace expressive_accumulator
+
+#endif // SCALAR_DIGITS_H
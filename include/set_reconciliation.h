@@ -0,0 +1,81 @@
+#ifndef SET_RECONCILIATION_H
+#define SET_RECONCILIATION_H
+
+#pragma once
+
+#include "expressive_accumulator.h"
+#include "fr_polynomial.h"
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 副本发送给对端的集合概要。
+ * @details evaluations[j] = P(z_j)，其中 P 为集合的特征多项式，
+ *          z_j = SetReconciliation::samplePoint(j)。概要大小为 max_difference + 1
+ *          个域元素，只与允许的对称差大小有关，与集合大小无关。
+ */
+struct ReconciliationSketch {
+    size_t set_size;
+    std::vector<Fr> evaluations;
+
+    ReconciliationSketch() : set_size(0) {}
+};
+
+/**
+ * @brief 集合协调的结果。
+ */
+struct ReconciliationResult {
+    bool success;                   ///< 对称差超出概要容量或与摘要不符时为 false
+    std::set<int> remote_only;      ///< 只在对端集合中的元素
+    std::set<int> local_only;       ///< 只在本地集合中的元素
+    std::set<int> remote_elements;  ///< 恢复出的对端完整集合
+
+    ReconciliationResult() : success(false) {}
+};
+
+/**
+ * @brief 基于有理函数插值的集合协调 (Minsky–Trachtenberg)。
+ * @details 在采样点 z_j 上，P_B(z_j)/P_A(z_j) = N(z_j)/D(z_j)，其中
+ *          N、D 分别是 B\A、A\B 的特征多项式。已知 |B| - |A| 后，
+ *          由 m 个采样值解一个 m×m 线性方程组即可插值出 N、D，再求根得到对称差。
+ *          通信量与计算量只依赖对称差大小 m，本地只需额外计算 m 次特征多项式求值。
+ *          恢复出的对端集合最后与对端公开的摘要核对，插值失败或概要被篡改都会被发现。
+ */
+class SetReconciliation {
+public:
+    /**
+     * @brief 第 j 个采样点，由固定的域分离标签哈希得到，双方无需协商。
+     */
+    static Fr samplePoint(size_t j);
+
+    /**
+     * @brief 生成本地集合的概要。
+     * @param acc 本地累加器。
+     * @param max_difference 允许的最大对称差大小。
+     */
+    static ReconciliationSketch makeSketch(const ExpressiveAccumulator& acc, size_t max_difference);
+
+    /**
+     * @brief 根据对端概要计算两个副本的对称差。
+     * @param local 本地累加器。
+     * @param remote_sketch 对端通过 makeSketch 生成的概要。
+     * @param remote_digest 对端公开的摘要，用于核对恢复出的集合。
+     * @param setup 可信设置对象的引用。
+     */
+    static ReconciliationResult reconcile(const ExpressiveAccumulator& local,
+                                          const ReconciliationSketch& remote_sketch,
+                                          const AccumulatorDigest& remote_digest,
+                                          const ExpressiveTrustedSetup& setup);
+
+private:
+    // 在给定分子/分母次数下插值有理函数，失败返回 false
+    static bool interpolate(FrPolynomial::Poly& numerator,
+                            FrPolynomial::Poly& denominator,
+                            const std::vector<Fr>& points,
+                            const std::vector<Fr>& ratios,
+                            size_t deg_num, size_t deg_den);
+};
+
+} // namespace expressive_accumulator
+
+#endif // SET_RECONCILIATION_H
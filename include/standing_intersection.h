@@ -0,0 +1,90 @@
+#ifndef STANDING_INTERSECTION_H
+#define STANDING_INTERSECTION_H
+
+#pragma once
+
+#include "expressive_accumulator.h"
+#include "fr_polynomial.h"
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 常驻查询中被更新的一侧集合。
+ */
+enum class QuerySide { A, B };
+
+/**
+ * @brief 常驻交集查询：持续维护 A ∩ B 的交集证明。
+ * @details 对象内部保存交集 I、差集 A\\I 与 B\\I、商多项式 Q_A、Q_B
+ *          以及满足 a·Q_A + b·Q_B = 1 的贝祖系数 a、b。
+ *          每次单元素增删只对这些多项式做一次线性因子乘/除和一次常数倍修正，
+ *          即 O(n) 次域运算加 O(1) 次群运算，无需重新运行 xgcd。
+ *          生成的证明与 ExpressiveAccumulator::generateIntersectionProof 的结果
+ *          等价，可直接交给 verifyIntersectionProof 验证。
+ */
+class StandingIntersectionQuery {
+public:
+    /**
+     * @brief 构造函数，根据两个累加器的当前状态完整计算一次证明。
+     * @param acc_a 集合 A 的累加器。
+     * @param acc_b 集合 B 的累加器。
+     * @param setup 可信设置对象的引用。
+     */
+    StandingIntersectionQuery(const ExpressiveAccumulator& acc_a,
+                              const ExpressiveAccumulator& acc_b,
+                              const ExpressiveTrustedSetup& setup);
+
+    /**
+     * @brief 应用累加器返回的更新证明，增量更新交集证明。
+     * @details 先用 verifyUpdateProof 验证证明，并要求 update.old_digest 等于该侧当前跟踪的摘要，
+     *          因此伪造、重放或乱序的更新都不会改变查询状态。
+     * @param side 发生更新的集合。
+     * @param update addElement / deleteElement 返回的 UpdateProof。
+     * @return 证明被接受时返回 true；未通过验证或不接续当前摘要的更新将被忽略并返回 false。
+     */
+    bool applyUpdate(QuerySide side, const UpdateProof& update);
+
+    // 直接更新（调用者自行保证与累加器一致），该侧的摘要由 I(s)·Q(s) 重新计算
+    void addElement(QuerySide side, int element);
+    void deleteElement(QuerySide side, int element);
+
+    const IntersectionProof& getProof() const { return proof; }
+    const std::set<int>& getIntersection() const { return intersection_set; }
+    // 该侧集合当前的摘要，即下一个更新证明应当接续的 old_digest
+    const AccumulatorDigest& getDigest(QuerySide side) const { return side == QuerySide::A ? digest_a : digest_b; }
+
+private:
+    // p <- p·(z - x)，同时修正贝祖系数使 u·p + v·q = 1 保持成立
+    static void addRoot(FrPolynomial::Poly& p, FrPolynomial::Poly& u,
+                        const FrPolynomial::Poly& q, FrPolynomial::Poly& v, const Fr& x);
+    // p <- p / (z - x)，同时修正贝祖系数使 u·p + v·q = 1 保持成立
+    static void removeRoot(FrPolynomial::Poly& p, FrPolynomial::Poly& u,
+                           const FrPolynomial::Poly& q, FrPolynomial::Poly& v, const Fr& x);
+
+    // 由当前各多项式在 s 处的值重新计算证明中的群元素
+    void refreshProof();
+    // 由 I(s)·Q(s) 重新计算一侧集合的摘要
+    void refreshDigest(QuerySide side);
+
+    const ExpressiveTrustedSetup& trusted_setup;
+
+    std::set<int> intersection_set;
+    std::set<int> diff_a;  ///< A \\ I
+    std::set<int> diff_b;  ///< B \\ I
+
+    FrPolynomial::Poly poly_qa;   ///< Q_A(z) = A(z) / I(z)
+    FrPolynomial::Poly poly_qb;   ///< Q_B(z) = B(z) / I(z)
+    FrPolynomial::Poly bezout_a;  ///< a(z)，deg a < deg Q_B
+    FrPolynomial::Poly bezout_b;  ///< b(z)，deg b < deg Q_A
+
+    Fr intersection_s;  ///< I(s)，随增删直接乘/除 (s - x)
+
+    AccumulatorDigest digest_a;  ///< A 的当前摘要 g1^{I(s)·Q_A(s)}
+    AccumulatorDigest digest_b;  ///< B 的当前摘要 g1^{I(s)·Q_B(s)}
+
+    IntersectionProof proof;
+};
+
+} // namespace expressive_accumulator
+
+#endif // STANDING_INTERSECTION_H
@@ -0,0 +1,75 @@
+#ifndef WITNESS_STORE_H
+#define WITNESS_STORE_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <cstdint>
+#include <string>
+#include "expressive_accumulator.h"
+#include "mapped_file.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 冻结的成员证明库：预先算好每个成员的见证，以内存映射文件提供查询。
+ * @details 读多写少的累加器（例如每小时变化一次、期间回答大量成员查询）在变化后调用 freeze，
+ *          一次性生成全部成员的见证（批量求逆加批量规范化），写入按最小完美哈希排布的文件。
+ *          查询只需一次哈希探测加一次记录拷贝，不再调用 generateMembershipProof；
+ *          多个进程映射同一文件时共享页缓存。
+ *
+ *          文件格式（小端）：
+ *          - 头部 64 字节：魔数 "EAWSTOR2"、成员数 n、桶数 B、哈希种子、记录字节数、摘要字节数、
+ *            头部之后全部字节的 CRC-32（打开时校验一次）；
+ *          - 摘要的 IoSerialize 字节，补齐到 8 字节；
+ *          - B 个 uint32 位移值，补齐到 8 字节；
+ *          - n 条定长记录：int32 元素、无穷远标志、仿射见证坐标 (x.a, x.b, y.a, y.b)，每个坐标 48 字节。
+ *          完美哈希采用 hash-and-displace：元素先散列到桶，每个桶选一个位移 d，
+ *          使桶内元素在 slot(x, d) 下落到互不相同的空槽位。
+ */
+class WitnessStore {
+public:
+    /**
+     * @brief 为 acc 的每个成员生成见证并写入 path。
+     * @details 先写入 path.tmp 再改名，已映射旧文件的读取者不受影响。需要 setup 的秘密 s。
+     * @param num_threads 生成见证的线程数，0 表示使用硬件并发数。
+     * @return 写入的成员数。
+     * @throws std::runtime_error 文件写入失败时抛出。
+     */
+    static size_t freeze(const ExpressiveAccumulator& acc, const std::string& path, size_t num_threads = 0);
+
+    /**
+     * @brief 映射由 freeze 写出的文件，并对头部之后的全部字节做一次 CRC 校验。
+     * @throws std::runtime_error 文件不存在、格式不符、被截断或校验和不符时抛出。
+     */
+    explicit WitnessStore(const std::string& path);
+
+    /**
+     * @brief 查询 element 的成员证明。
+     * @details 文件完整性已在打开时由 CRC 校验，这里不再检查见证点；子群检查留给验证者。
+     * @return element 不是冻结时的成员返回 false，proof 不变。
+     * @throws std::runtime_error 命中的记录无法解码时抛出。
+     */
+    bool lookup(int element, MembershipProof& proof) const;
+
+    size_t size() const { return count_; }
+    // 冻结时累加器的摘要，用于确认证明与当前摘要一致
+    const AccumulatorDigest& digest() const { return digest_; }
+
+private:
+    const uint8_t* record(size_t slot) const;
+
+    MappedFile file_;
+    size_t count_;
+    size_t bucket_count_;
+    uint64_t seed_;
+    const uint8_t* displacements_;
+    const uint8_t* records_;
+    AccumulatorDigest digest_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // WITNESS_STORE_H
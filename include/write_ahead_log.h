@@ -0,0 +1,174 @@
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#pragma once
+
+#include <mcl/bls12_381.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "expressive_accumulator.h"
+
+using namespace mcl::bls12;
+
+namespace expressive_accumulator {
+
+/**
+ * @brief 预写日志的配置。
+ */
+struct WalOptions {
+    bool log_proofs;              ///< 同时记录每次操作的 UpdateProof（摘要与删除见证）
+    bool sync;                    ///< 提交时调用 fdatasync；为 false 时只写入页缓存
+    size_t checkpoint_bytes;      ///< 日志超过该字节数时自动检查点，0 表示只手动检查点
+    double full_snapshot_ratio;   ///< 脏元素超过集合大小的该比例时写完整快照，否则只写增量
+    size_t group_commit_delay_us; ///< 组提交领头者落盘前等待的微秒数，让更多写者并入同一批
+
+    WalOptions()
+        : log_proofs(false), sync(true), checkpoint_bytes(64u << 20), full_snapshot_ratio(0.25),
+          group_commit_delay_us(0) {}
+};
+
+/**
+ * @brief 预写日志的运行统计。
+ */
+struct WalStats {
+    uint64_t records;          ///< 写入的日志记录数
+    uint64_t group_commits;    ///< 落盘批次数；并发写者越多，每批包含的记录越多
+    uint64_t syncs;            ///< fdatasync 次数
+    uint64_t checkpoints;      ///< 检查点次数（含完整快照）
+    uint64_t full_snapshots;   ///< 完整快照次数
+    uint64_t replayed;         ///< 打开时从日志尾部回放的记录数
+
+    WalStats() : records(0), group_commits(0), syncs(0), checkpoints(0), full_snapshots(0), replayed(0) {}
+};
+
+/**
+ * @brief 日志中的一条操作记录。
+ */
+struct WalRecord {
+    uint64_t lsn;              ///< 日志序号，从 1 开始严格递增
+    UpdateOperation op;
+    int element;
+    bool has_proof;            ///< 写入时 log_proofs 为 true
+    UpdateProof proof;
+
+    WalRecord() : lsn(0), op(UpdateOperation::ADD), element(0), has_proof(false) {}
+};
+
+/**
+ * @brief 带组提交的累加器预写日志。
+ * @details 目录 dir 中包含三个文件：
+ *          - checkpoint.state：ExpressiveAccumulator::save 写出的完整快照；
+ *          - checkpoint.delta：自上次完整快照以来变化过的元素（脏集合）及其当前状态，以及检查点的日志序号；
+ *          - wal.log：检查点之后的操作记录，每条为 (长度, CRC-32, 载荷)。
+ *
+ *          写者先在锁内更新累加器并把记录追加到内存中的待写批次，然后等待落盘：
+ *          没有进行中的写盘时由它作为领头者取走整批记录，释放锁后一次 write 加一次 fdatasync，
+ *          期间到达的写者继续追加并等待下一批，因此并发写者共享 fsync。
+ *
+ *          检查点只处理脏状态：脏元素较少时只重写增量文件，超过 full_snapshot_ratio 时写完整快照并清空脏集合；
+ *          随后日志被截断为空。恢复时加载快照、应用增量，再把日志尾部按元素合并（每个元素取最后一次操作）
+ *          后以 applyUpdates 批量回放，摘要只重新计算一次。
+ *
+ *          回放的结果只依赖每个元素最后一次操作，因此在检查点任一步骤中崩溃都能恢复到一致状态。
+ *          写盘失败后日志进入失败状态，之后的操作全部抛出异常（内存状态可能已领先于磁盘，需要重新打开）。
+ */
+class WriteAheadLog {
+public:
+    /**
+     * @brief 打开（必要时创建）目录 dir 中的日志并恢复累加器。
+     * @details 日志末尾不完整或校验失败的记录被视为崩溃时未完成的写入，截断后继续追加。
+     *          需要 setup 的秘密 s。
+     * @param type 新建累加器时使用的群类型；已有快照时以快照为准。
+     * @throws std::runtime_error 目录无法创建，或快照、增量文件损坏时抛出。
+     */
+    static std::unique_ptr<WriteAheadLog> open(const std::string& dir,
+                                               const ExpressiveTrustedSetup& setup,
+                                               GroupType type = G1_TYPE,
+                                               const WalOptions& options = WalOptions());
+
+    ~WriteAheadLog();
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /**
+     * @brief 添加元素，返回时操作已经落盘（sync 为 true 时）。
+     * @details 元素已存在时不写日志。可以从多个线程并发调用。
+     * @throws std::runtime_error 日志写入失败时抛出。
+     */
+    UpdateProof addElement(int element);
+
+    /**
+     * @brief 删除元素，返回时操作已经落盘（sync 为 true 时）。
+     * @details 元素不存在时不写日志，返回的证明 is_valid 为 false。可以从多个线程并发调用。
+     * @throws std::runtime_error 日志写入失败时抛出。
+     */
+    UpdateProof deleteElement(int element);
+
+    /**
+     * @brief 立即检查点：先让所有已提交的记录落盘，再写增量或完整快照并截断日志。
+     * @throws std::runtime_error 文件写入失败时抛出。
+     */
+    void checkpoint();
+
+    /**
+     * @brief [静态] 读取目录 dir 中日志的全部完整记录，不修改文件。
+     * @throws std::runtime_error 日志文件不存在或头部损坏时抛出。
+     */
+    static std::vector<WalRecord> scan(const std::string& dir);
+
+    // 当前摘要与成员查询，与写者同步
+    AccumulatorDigest digest() const;
+    bool contains(int element) const;
+    size_t size() const;
+    // 最后一个已落盘记录的日志序号
+    uint64_t durableLsn() const;
+    WalStats stats() const;
+
+    /**
+     * @brief 底层累加器，用于生成证明等只读操作。
+     * @details 不与并发写者同步，调用者需保证此时没有写入。
+     */
+    const ExpressiveAccumulator& accumulator() const { return *acc_; }
+
+private:
+    WriteAheadLog(const std::string& dir, const ExpressiveTrustedSetup& setup, const WalOptions& options);
+
+    void recover(GroupType type);
+    void openLog(bool create, uint64_t base_lsn);
+    void append(UpdateOperation op, int element, const UpdateProof* proof);
+    // 等待 lsn 落盘；没有进行中的写盘时由调用者领头写出整批记录
+    void waitDurable(std::unique_lock<std::mutex>& lock, uint64_t lsn);
+    void flushPending(std::unique_lock<std::mutex>& lock);
+    // 等待进行中的写盘结束并写出剩余记录，返回时持有锁且没有待写记录
+    void drain(std::unique_lock<std::mutex>& lock);
+    void checkpointLocked(std::unique_lock<std::mutex>& lock);
+    void maybeCheckpoint(std::unique_lock<std::mutex>& lock);
+    void throwIfFailed() const;
+
+    const std::string dir_;
+    const ExpressiveTrustedSetup& setup_;
+    const WalOptions options_;
+    std::unique_ptr<ExpressiveAccumulator> acc_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushed_;
+    int fd_;
+    std::vector<uint8_t> pending_;   // 已提交、尚未写出的记录
+    bool flushing_;                  // 领头者正在写盘
+    bool failed_;
+    uint64_t last_lsn_;              // 最后一个已提交记录的序号
+    uint64_t durable_lsn_;
+    uint64_t checkpoint_lsn_;
+    size_t log_bytes_;               // 日志文件中记录区的字节数
+    std::set<int> dirty_;            // 自上次完整快照以来变化过的元素
+    WalStats stats_;
+};
+
+} // namespace expressive_accumulator
+
+#endif // WRITE_AHEAD_LOG_H
@@ -17,13 +17,14 @@ echo "创建输出目录..."
 mkdir -p bin
 
 # 编译标志
-CXX_FLAGS="-std=c++17 -O3 -Wall -Wextra"
+CXX_FLAGS="-std=c++17 -O3 -Wall -Wextra -pthread"
 INCLUDE_FLAGS="-I/opt/homebrew/include -I./include -I./third_party/mcl/include"
 LIB_FLAGS="-L/opt/homebrew/lib -L./third_party/mcl/lib -lgmp -lflint -lssl -lcrypto ./third_party/mcl/lib/libmcl.a"
+SOURCES="src/expressive_accumulator.cpp src/fr_polynomial.cpp src/fr_ntt.cpp src/fr_simd.cpp src/standing_intersection.cpp src/query_engine.cpp src/set_reconciliation.cpp src/mapped_file.cpp src/powers_of_tau.cpp src/memory_placement.cpp src/pairing_cache.cpp src/witness_store.cpp src/accumulator_persistence.cpp src/write_ahead_log.cpp src/blinding.cpp src/multiset_accumulator.cpp"
 
 # 编译综合测试
 echo "编译综合功能测试..."
-g++ $CXX_FLAGS $INCLUDE_FLAGS $LIB_FLAGS -o bin/comprehensive_test examples/comprehensive_test.cpp src/expressive_accumulator.cpp
+g++ $CXX_FLAGS $INCLUDE_FLAGS $LIB_FLAGS -o bin/comprehensive_test examples/comprehensive_test.cpp $SOURCES
 
 if [ $? -eq 0 ]; then
     echo "✅ 综合功能测试编译成功"
@@ -34,7 +35,7 @@ fi
 
 # 编译性能测试
 echo "编译性能基准测试..."
-g++ $CXX_FLAGS $INCLUDE_FLAGS $LIB_FLAGS -o bin/performance_test examples/performance_test.cpp src/expressive_accumulator.cpp
+g++ $CXX_FLAGS $INCLUDE_FLAGS $LIB_FLAGS -o bin/performance_test examples/performance_test.cpp $SOURCES
 
 if [ $? -eq 0 ]; then
     echo "✅ 性能基准测试编译成功"
@@ -0,0 +1,313 @@
+/**
+ * @file accumulator_persistence.cpp
+ * @brief 累加器状态的二进制保存与并行加载。
+ */
+#include "expressive_accumulator.h"
+#include "binary_codec.h"
+#include "fr_polynomial.h"
+#include "fr_simd.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+namespace expressive_accumulator {
+
+namespace {
+
+using BinaryCodec::pad8;
+using BinaryCodec::readLE;
+using BinaryCodec::writeLE;
+
+/*
+ * 文件格式（小端）：
+ *   头部 64 字节：魔数 "EAACCST1"、元素数 n、块数、变长整数区字节数、每块元素数、群类型、摘要字节数、标志；
+ *   摘要的 IoSerialize 字节，补齐到 8 字节；
+ *   块索引：每块 16 字节 (uint64 块在变长整数区中的偏移, int32 块首元素, 4 字节保留)；
+ *   变长整数区：每块除块首外的元素差分 x_i - x_{i-1} - 1（严格递增，因此非负），补齐到 8 字节；
+ *   可选的系数区：n + 1 个 32 字节的 Fr，低次在前。
+ */
+const char MAGIC[8] = {'E', 'A', 'A', 'C', 'C', 'S', 'T', '1'};
+const size_t HEADER_BYTES = 64;
+const size_t INDEX_ENTRY_BYTES = 16;
+const size_t FR_BYTES = 32;
+const size_t MAX_DIGEST_BYTES = 1024;
+const uint32_t FLAG_COEFFICIENTS = 1;
+
+std::runtime_error formatError(const std::string& path, const std::string& what) {
+    return std::runtime_error("ExpressiveAccumulator::load: " + path + ": " + what);
+}
+
+// 把 [lo, hi) 均分给最多 num_threads 个线程
+template <typename Worker>
+void parallelRange(size_t lo, size_t hi, size_t num_threads, const Worker& worker) {
+    const size_t n = hi - lo;
+    const size_t threads_used = std::max<size_t>(1, std::min(num_threads, n));
+    if (threads_used <= 1) {
+        worker(0, lo, hi);
+        return;
+    }
+    std::vector<std::thread> threads;
+    size_t chunk = (n + threads_used - 1) / threads_used;
+    for (size_t t = 0; t * chunk < n; ++t) {
+        threads.emplace_back(worker, t, lo + t * chunk, lo + std::min(n, (t + 1) * chunk));
+    }
+    for (auto& th : threads) th.join();
+}
+
+} // namespace
+
+// ==========================================================================================
+// ExpressiveAccumulator - 保存
+// ==========================================================================================
+
+void ExpressiveAccumulator::save(const std::string& path, bool include_coefficients, size_t num_threads) const {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    const size_t n = elements.size();
+    const size_t block_count = (n + PERSIST_BLOCK - 1) / PERSIST_BLOCK;
+    const std::string digest = group_type == G1_TYPE ? digest_g1.serialize()
+                                                     : digest_g2.value.getStr(mcl::IoSerialize);
+
+    // 差分变长整数与块索引
+    std::vector<uint8_t> varints;
+    varints.reserve(n * 2);
+    std::vector<uint8_t> index(block_count * INDEX_ENTRY_BYTES, 0);
+    size_t k = 0;
+    int64_t previous = 0;
+    for (int el : elements) {
+        if (k % PERSIST_BLOCK == 0) {
+            uint8_t* entry = index.data() + (k / PERSIST_BLOCK) * INDEX_ENTRY_BYTES;
+            writeLE<uint64_t>(entry, varints.size());
+            writeLE<uint32_t>(entry + 8, static_cast<uint32_t>(el));
+        } else {
+            BinaryCodec::putVarint(varints, static_cast<uint64_t>(static_cast<int64_t>(el) - previous - 1));
+        }
+        previous = el;
+        ++k;
+    }
+
+    std::vector<uint8_t> header(HEADER_BYTES, 0);
+    std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+    writeLE<uint64_t>(header.data() + 8, n);
+    writeLE<uint64_t>(header.data() + 16, block_count);
+    writeLE<uint64_t>(header.data() + 24, varints.size());
+    writeLE<uint32_t>(header.data() + 32, static_cast<uint32_t>(PERSIST_BLOCK));
+    writeLE<uint32_t>(header.data() + 36, group_type == G1_TYPE ? 0u : 1u);
+    writeLE<uint32_t>(header.data() + 40, static_cast<uint32_t>(digest.size()));
+    writeLE<uint32_t>(header.data() + 44, include_coefficients ? FLAG_COEFFICIENTS : 0u);
+
+    const std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("ExpressiveAccumulator::save: cannot create " + tmp_path);
+    }
+    const uint8_t zeros[8] = {0};
+    auto write = [&](const void* data, size_t size) {
+        out.write(static_cast<const char*>(data), size);
+        out.write(reinterpret_cast<const char*>(zeros), pad8(size) - size);
+    };
+    write(header.data(), header.size());
+    write(digest.data(), digest.size());
+    write(index.data(), index.size());
+    write(varints.data(), varints.size());
+
+    if (include_coefficients) {
+        std::vector<Fr> roots;
+        roots.reserve(n);
+        for (int el : elements) roots.push_back(Fr(el));
+        const std::vector<Fr> coeffs = FrPolynomial::fromRoots(roots, num_threads);
+        std::vector<uint8_t> bytes(coeffs.size() * FR_BYTES);
+        for (size_t i = 0; i < coeffs.size(); ++i) {
+            if (coeffs[i].serialize(bytes.data() + i * FR_BYTES, FR_BYTES) != FR_BYTES) {
+                throw std::runtime_error("ExpressiveAccumulator::save: coefficient serialization failed");
+            }
+        }
+        write(bytes.data(), bytes.size());
+    }
+
+    out.close();
+    if (!out) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("ExpressiveAccumulator::save: write failed for " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("ExpressiveAccumulator::save: cannot rename " + tmp_path + " to " + path);
+    }
+}
+
+// ==========================================================================================
+// ExpressiveAccumulator - 加载
+// ==========================================================================================
+
+std::unique_ptr<ExpressiveAccumulator> ExpressiveAccumulator::load(const std::string& path,
+                                                                   const ExpressiveTrustedSetup& setup,
+                                                                   size_t num_threads,
+                                                                   std::vector<Fr>* coefficients) {
+    // P(s) 与摘要核对都需要 s；没有秘密时 s 为 0，恢复出的状态毫无意义
+    if (!setup.hasSecret()) {
+        throw std::logic_error("ExpressiveAccumulator::load: setup has no secret to recover P(s) with");
+    }
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    MappedFile file(path, true);
+
+    size_t n = 0, block_count = 0, block_size = 0, varint_bytes = 0;
+    uint32_t flags = 0;
+    GroupType type = G1_TYPE;
+    std::string digest;
+    const uint8_t* index = nullptr;
+    const uint8_t* varints = nullptr;
+    const uint8_t* coeff_bytes = nullptr;
+    try {
+        const uint8_t* header = file.range(0, HEADER_BYTES);
+        if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+            throw formatError(path, "not an accumulator state file");
+        }
+        const uint64_t count = readLE<uint64_t>(header + 8);
+        const uint64_t blocks = readLE<uint64_t>(header + 16);
+        const uint64_t vbytes = readLE<uint64_t>(header + 24);
+        const uint32_t bsize = readLE<uint32_t>(header + 32);
+        const uint32_t group = readLE<uint32_t>(header + 36);
+        const uint32_t digest_bytes = readLE<uint32_t>(header + 40);
+        flags = readLE<uint32_t>(header + 44);
+        if (bsize == 0 || group > 1 || digest_bytes > MAX_DIGEST_BYTES || (flags & ~FLAG_COEFFICIENTS) != 0 ||
+            count > UINT32_MAX || vbytes > file.size() || blocks != (count + bsize - 1) / bsize) {
+            throw formatError(path, "unsupported or corrupted header");
+        }
+        n = static_cast<size_t>(count);
+        block_count = static_cast<size_t>(blocks);
+        block_size = bsize;
+        varint_bytes = static_cast<size_t>(vbytes);
+        type = group == 0 ? G1_TYPE : G2_TYPE;
+
+        size_t offset = HEADER_BYTES;
+        digest.assign(reinterpret_cast<const char*>(file.range(offset, digest_bytes)), digest_bytes);
+        offset += pad8(digest_bytes);
+        index = file.range(offset, block_count * INDEX_ENTRY_BYTES);
+        offset += pad8(block_count * INDEX_ENTRY_BYTES);
+        varints = file.range(offset, varint_bytes);
+        offset += pad8(varint_bytes);
+        if (flags & FLAG_COEFFICIENTS) {
+            coeff_bytes = file.range(offset, (n + 1) * FR_BYTES);
+            offset += (n + 1) * FR_BYTES;
+        }
+        if (offset != file.size()) {
+            throw formatError(path, "unexpected trailing data");
+        }
+    } catch (const std::out_of_range&) {
+        throw formatError(path, "file is truncated");
+    }
+
+    // 块偏移必须单调且落在变长整数区内，各块才能独立解码
+    std::vector<size_t> block_begin(block_count + 1, varint_bytes);
+    for (size_t b = 0; b < block_count; ++b) {
+        block_begin[b] = static_cast<size_t>(readLE<uint64_t>(index + b * INDEX_ENTRY_BYTES));
+        if (block_begin[b] > varint_bytes || (b > 0 && block_begin[b] < block_begin[b - 1])) {
+            throw formatError(path, "corrupted block index");
+        }
+    }
+
+    // 各线程解码一段块，顺带累乘 ∏(s - x)
+    std::vector<int> values(n);
+    const Fr& secret_s = setup.getSecretS();
+    std::vector<Fr> partial(std::max<size_t>(1, std::min(num_threads, block_count)), Fr(1));
+    std::atomic<bool> corrupted(false);
+    parallelRange(0, block_count, num_threads, [&](size_t t, size_t lo, size_t hi) {
+        Fr product = 1;
+        for (size_t b = lo; b < hi && !corrupted.load(std::memory_order_relaxed); ++b) {
+            const size_t first = b * block_size;
+            const size_t last = std::min(n, first + block_size);
+            const uint8_t* p = varints + block_begin[b];
+            const uint8_t* end = varints + block_begin[b + 1];
+            int64_t value = static_cast<int32_t>(readLE<uint32_t>(index + b * INDEX_ENTRY_BYTES + 8));
+            values[first] = static_cast<int>(value);
+            for (size_t i = first + 1; i < last; ++i) {
+                uint64_t delta = 0;
+                if (!BinaryCodec::getVarint(p, end, delta) || delta >= static_cast<uint64_t>(INT_MAX - value)) {
+                    corrupted.store(true);
+                    return;
+                }
+                value += static_cast<int64_t>(delta) + 1;
+                values[i] = static_cast<int>(value);
+            }
+            // 块必须恰好用完，且与下一块的块首保持严格递增
+            const bool next_ok = b + 1 == block_count ||
+                                 value < static_cast<int32_t>(readLE<uint32_t>(index + (b + 1) * INDEX_ENTRY_BYTES + 8));
+            if (p != end || !next_ok) {
+                corrupted.store(true);
+                return;
+            }
+            product *= FrSimd::linearProduct(secret_s, values.data() + first, last - first);
+        }
+        partial[t] = product;
+    });
+    if (corrupted.load()) {
+        throw formatError(path, "corrupted element encoding");
+    }
+
+    // values 严格递增，集合可由它线性建出；累加器与多项式各持有一份，两份同时构造，多项式的一份直接移入
+    std::unique_ptr<ExpressiveAccumulator> acc(new ExpressiveAccumulator(setup, type));
+    std::set<int> poly_elements;
+    auto build_poly_elements = [&]() { poly_elements = std::set<int>(values.begin(), values.end()); };
+    std::thread builder;
+    if (num_threads > 1) builder = std::thread(build_poly_elements);
+    acc->elements = std::set<int>(values.begin(), values.end());
+    if (builder.joinable()) builder.join();
+    else build_poly_elements();
+    acc->polynomial = std::make_unique<CharacteristicPolynomial>(std::move(poly_elements));
+    acc->poly_at_s = 1;
+    for (const Fr& p : partial) acc->poly_at_s *= p;
+
+    // 摘要取自文件，以一次标量乘法核对它属于这个 setup
+    bool digest_ok = true;
+    try {
+        if (type == G1_TYPE) {
+            acc->digest_g1.deserialize(digest);
+            G1 expected;
+            G1::mul(expected, setup.getG1Generator(), acc->poly_at_s);
+            digest_ok = expected == acc->digest_g1.value;
+        } else {
+            acc->digest_g2.value.setStr(digest, mcl::IoSerialize);
+            G2 expected;
+            G2::mul(expected, setup.getG2Generator(), acc->poly_at_s);
+            digest_ok = expected == acc->digest_g2.value;
+        }
+    } catch (const std::exception&) {
+        throw formatError(path, "corrupted digest");
+    }
+    if (!digest_ok) {
+        throw formatError(path, "digest does not match the trusted setup");
+    }
+
+    if (coefficients != nullptr) {
+        coefficients->clear();
+        if (coeff_bytes != nullptr) {
+            coefficients->resize(n + 1);
+            std::atomic<bool> bad_coeff(false);
+            parallelRange(0, n + 1, num_threads, [&](size_t, size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; ++i) {
+                    if ((*coefficients)[i].deserialize(coeff_bytes + i * FR_BYTES, FR_BYTES) == 0) {
+                        bad_coeff.store(true);
+                    }
+                }
+            });
+            if (bad_coeff.load()) {
+                throw formatError(path, "corrupted coefficient");
+            }
+        }
+    }
+    // 与 addElement 相同：集合超出幂次表覆盖的次数时在后台扩展
+    setup.reserveDegree(n);
+    return acc;
+}
+
+} // namespace expressive_accumulator
@@ -0,0 +1,166 @@
+/**
+ * @file blinding.cpp
+ * @brief 基于二维幂次表 g^{s^i r^j} 的零知识盲化摘要与盲化成员证明。
+ */
+#include "expressive_accumulator.h"
+#include <stdexcept>
+
+namespace expressive_accumulator {
+
+namespace {
+
+size_t blindingTerms(const ExpressiveTrustedSetup& setup) {
+    return (setup.getBlindingSDegree() + 1) * setup.getBlindingRDegree();
+}
+
+void requireBlindingPowers(const ExpressiveTrustedSetup& setup) {
+    if (!setup.hasBlindingPowers()) {
+        throw std::logic_error("ExpressiveAccumulator: generateBlindingPowers must be called before blinding");
+    }
+}
+
+} // namespace
+
+// ==========================================================================================
+// ExpressiveTrustedSetup - 盲化幂次表
+// ==========================================================================================
+
+void ExpressiveTrustedSetup::generateBlindingPowers(size_t s_degree, size_t r_degree) {
+    if (!has_secret) {
+        throw std::logic_error("ExpressiveTrustedSetup: imported setup has no secret to generate blinding powers from");
+    }
+    if (s_degree == 0 || r_degree == 0) {
+        throw std::invalid_argument("ExpressiveTrustedSetup: blinding degrees must be positive");
+    }
+    std::vector<G1> g1_points;
+    std::vector<G2> g2_points;
+    g1_points.reserve((s_degree + 1) * r_degree);
+    g2_points.reserve((s_degree + 1) * r_degree);
+    Fr r_power = 1;
+    for (size_t j = 1; j <= r_degree; ++j) {
+        r_power *= secret_r;
+        Fr term = r_power;
+        for (size_t i = 0; i <= s_degree; ++i) {
+            G1 P;
+            G2 Q;
+            G1::mul(P, g1_generator, term);
+            G2::mul(Q, g2_generator, term);
+            g1_points.push_back(P);
+            g2_points.push_back(Q);
+            term *= secret_s;
+        }
+    }
+    g1_sr_powers.clear();
+    g2_sr_powers.clear();
+    g1_sr_powers.append(g1_points);
+    g2_sr_powers.append(g2_points);
+    blinding_s_degree = s_degree;
+    blinding_r_degree = r_degree;
+}
+
+G1 ExpressiveTrustedSetup::getG1_sr_pow(const Term2D& term) const {
+    if (term.r_exp == 0) return getG1_s_pow(term.s_exp);
+    if (term.s_exp < 0 || term.r_exp < 0 || static_cast<size_t>(term.s_exp) > blinding_s_degree ||
+        static_cast<size_t>(term.r_exp) > blinding_r_degree) {
+        throw std::out_of_range("ExpressiveTrustedSetup: term beyond blinding power table");
+    }
+    return g1_sr_powers.get((term.r_exp - 1) * (blinding_s_degree + 1) + term.s_exp);
+}
+
+G2 ExpressiveTrustedSetup::getG2_sr_pow(const Term2D& term) const {
+    if (term.r_exp == 0) return getG2_s_pow(term.s_exp);
+    if (term.s_exp < 0 || term.r_exp < 0 || static_cast<size_t>(term.s_exp) > blinding_s_degree ||
+        static_cast<size_t>(term.r_exp) > blinding_r_degree) {
+        throw std::out_of_range("ExpressiveTrustedSetup: term beyond blinding power table");
+    }
+    return g2_sr_powers.get((term.r_exp - 1) * (blinding_s_degree + 1) + term.s_exp);
+}
+
+// ==========================================================================================
+// ExpressiveAccumulator - 盲化摘要与证明
+// ==========================================================================================
+
+AccumulatorDigest ExpressiveAccumulator::blindDigest(Blinding& blinding) const {
+    if (group_type != G1_TYPE) {
+        throw std::logic_error("ExpressiveAccumulator: blinding is only supported for G1 accumulators");
+    }
+    requireBlindingPowers(trusted_setup);
+    blinding.s_degree = trusted_setup.getBlindingSDegree();
+    blinding.r_degree = trusted_setup.getBlindingRDegree();
+    blinding.coeffs.resize(blindingTerms(trusted_setup));
+    for (Fr& c : blinding.coeffs) c.setByCSPRNG();
+
+    // Â = A + Σ ρ_ij·g1^{s^i r^j}
+    G1 mask;
+    trusted_setup.g1_sr_powers.multiExp(mask, blinding.coeffs.data(), blinding.coeffs.size(), 1);
+    AccumulatorDigest blinded;
+    G1::add(blinded.value, digest_g1.value, mask);
+    return blinded;
+}
+
+BlindedMembershipProof ExpressiveAccumulator::generateBlindedMembershipProof(int element,
+                                                                             const Blinding& blinding) const {
+    requireBlindingPowers(trusted_setup);
+    const size_t s_degree = trusted_setup.getBlindingSDegree();
+    const size_t r_degree = trusted_setup.getBlindingRDegree();
+    if (blinding.s_degree != s_degree || blinding.r_degree != r_degree ||
+        blinding.coeffs.size() != blindingTerms(trusted_setup)) {
+        throw std::invalid_argument("ExpressiveAccumulator: blinding does not match the setup's blinding powers");
+    }
+    BlindedMembershipProof proof;
+    if (elements.find(element) == elements.end()) {
+        return proof;
+    }
+    proof.is_member = true;
+
+    // 每行 β_j(S) 对 (S - x) 做综合除法：商为 γ_j，余数为 β_j(x)
+    const Fr x(element);
+    std::vector<Fr> gamma(blinding.coeffs.size());
+    proof.openings.resize(r_degree);
+    for (size_t j = 0; j < r_degree; ++j) {
+        const Fr* row = blinding.coeffs.data() + j * (s_degree + 1);
+        Fr* quotient = gamma.data() + j * (s_degree + 1);
+        Fr acc = 0;
+        for (size_t k = s_degree; k >= 1; --k) {
+            acc = acc * x + row[k];
+            quotient[k - 1] = acc;
+        }
+        quotient[s_degree] = 0;
+        proof.openings[j] = acc * x + row[0];
+    }
+
+    // Ŵ = g2^{Q(s)} + Σ γ_ij·g2^{s^i r^j}
+    G2 mask;
+    G2::mul(proof.witness_g2, trusted_setup.getG2Generator(), witnessValue(element));
+    trusted_setup.g2_sr_powers.multiExp(mask, gamma.data(), gamma.size(), 1);
+    G2::add(proof.witness_g2, proof.witness_g2, mask);
+    return proof;
+}
+
+bool ExpressiveAccumulator::verifyBlindedMembershipProof(const AccumulatorDigest& blinded_digest,
+                                                         int element,
+                                                         const BlindedMembershipProof& proof,
+                                                         const ExpressiveTrustedSetup& setup) {
+    if (!proof.is_member || !setup.hasBlindingPowers() || proof.openings.size() != setup.getBlindingRDegree()) {
+        return false;
+    }
+    // g1^{β(x, r)} = Σ β_j(x)·g1^{r^j}，只用到各行的首个点，只解码这 r_degree 个点
+    const size_t row_size = setup.getBlindingSDegree() + 1;
+    std::vector<G1> row_heads(proof.openings.size());
+    for (size_t j = 0; j < row_heads.size(); ++j) row_heads[j] = setup.g1_sr_powers.get(j * row_size);
+    G1 opening, unblinded;
+    G1::mulVec(opening, row_heads.data(), proof.openings.data(), row_heads.size());
+    G1::sub(unblinded, blinded_digest.value, opening);
+
+    // g1^{s-x} = g1^s - x·g1
+    G1 sx_g1, x_g1;
+    G1::mul(x_g1, setup.getG1Generator(), Fr(element));
+    G1::sub(sx_g1, setup.getG1_s_pow(1), x_g1);
+
+    GT lhs, rhs;
+    pairing(lhs, unblinded, setup.getG2Generator());
+    pairing(rhs, sx_g1, proof.witness_g2);
+    return lhs == rhs;
+}
+
+} // namespace expressive_accumulator
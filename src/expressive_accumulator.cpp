@@ -5,11 +5,17 @@
  *          证明生成和证明验证的逻辑。
  */
 #include "expressive_accumulator.h"
+#include "fr_polynomial.h"
+#include "fr_simd.h"
+#include "batch_inversion.h"
 #include <iostream>
 #include <vector>
 #include <numeric>
 #include <algorithm>
 #include <cassert>
+#include <exception>
+#include <stdexcept>
+#include <thread>
 
 // 引入 FLINT C 语言头文件
 extern "C" {
@@ -71,70 +77,22 @@ void initFlintContext() {
     }
 }
 
-// PolynomialUtils 命名空间，用于封装 FLINT 多项式操作
-namespace PolynomialUtils {
-    // 辅助函数：将 mcl::Fr 转换为 FLINT 的 fmpz_t
-    void frToFmpz(fmpz_t result, const mcl::Fr& fr) {
-        fmpz_set_str(result, fr.getStr(10).c_str(), 10);
-    }
-
-    // 辅助函数：将 FLINT 的 fmpz_t 转换为 mcl::Fr
-    mcl::Fr fmpzToFr(const fmpz_t f) {
-        char* s = fmpz_get_str(nullptr, 10, f);
-        mcl::Fr fr;
-        try {
-            fr.setStr(s);
-        } catch (const std::exception& e) {
-            std::cerr << "错误: 无法将FLINT整数转换为MCL Fr: " << s << std::endl;
-            std::cerr << "异常: " << e.what() << std::endl;
-            free(s);
-            throw;
-        }
-        free(s);
-        return fr;
-    }
-
-    // 从根集合创建 FLINT 多项式 P(z) = (z - r1)(z - r2)...
-    void fromRoots(fmpz_mod_poly_t poly, const std::set<int>& roots, const fmpz_mod_ctx_t ctx) {
-        fmpz_mod_poly_init(poly, ctx);
-        fmpz_mod_poly_set_coeff_si(poly, 0, 1, ctx); // P(z) = 1
-
-        fmpz_mod_poly_t temp_term;
-        fmpz_mod_poly_init(temp_term, ctx);
+// ==========================================================================================
+// AccumulatorDigest - 方法实现
+// ==========================================================================================
 
-        fmpz_t r_fmpz;
-        fmpz_init(r_fmpz);
+std::string AccumulatorDigest::serialize() const {
+    return value.getStr(mcl::IoSerialize);
+}
 
-        for (int root : roots) {
-            // temp_term = z - root
-            fmpz_set_si(r_fmpz, root);
-            fmpz_mod_poly_set_coeff_si(temp_term, 1, 1, ctx); // temp_term = z
-            fmpz_mod_poly_set_coeff_si(temp_term, 0, 0, ctx); // 清零常数项
-            fmpz_mod_poly_sub_fmpz(temp_term, temp_term, r_fmpz, ctx);
+void AccumulatorDigest::deserialize(const std::string& data) {
+    value.setStr(data, mcl::IoSerialize);
+}
 
-            fmpz_mod_poly_mul(poly, poly, temp_term, ctx);
-        }
-        
-        fmpz_clear(r_fmpz);
-        fmpz_mod_poly_clear(temp_term, ctx);
-    }
-    
-    // 在点 s 处评估 FLINT 多项式
-    mcl::Fr evaluate(const fmpz_mod_poly_t poly, const mcl::Fr& s, const fmpz_mod_ctx_t ctx) {
-        fmpz_t s_fmpz, res_fmpz;
-        fmpz_init(s_fmpz);
-        fmpz_init(res_fmpz);
-        
-        frToFmpz(s_fmpz, s);
-        fmpz_mod_poly_evaluate_fmpz(res_fmpz, poly, s_fmpz, ctx);
-        
-        mcl::Fr result = fmpzToFr(res_fmpz);
-        
-        fmpz_clear(s_fmpz);
-        fmpz_clear(res_fmpz);
-        
-        return result;
-    }
+std::vector<std::string> AccumulatorDigest::serializeBatch(const std::vector<AccumulatorDigest>& digests) {
+    std::vector<G1> points(digests.size());
+    for (size_t i = 0; i < digests.size(); ++i) points[i] = digests[i].value;
+    return BatchInversion::serializePoints(points.data(), points.size());
 }
 
 
@@ -142,9 +100,22 @@ namespace PolynomialUtils {
 // ExpressiveTrustedSetup - 方法实现
 // ==========================================================================================
 
-ExpressiveTrustedSetup::ExpressiveTrustedSetup(const Fr& s, const Fr& r, size_t max_deg)
-    : secret_s(s), secret_r(r), max_degree(max_deg) {
-    // 构造函数体为空，所有计算都在 generatePowers 中进行
+ExpressiveTrustedSetup::ExpressiveTrustedSetup(const Fr& s, const Fr& r, size_t max_deg, PowerStorage storage,
+                                               const TablePlacement& placement)
+    : secret_s(s), secret_r(r), max_degree(max_deg), g1_s_powers(storage, placement),
+      g2_s_powers(storage, placement), g1_sr_powers(PowerStorage::COMPRESSED),
+      g2_sr_powers(PowerStorage::COMPRESSED) {
+    // mcl 的点默认构造不初始化，生成元在 generatePowers 之前保持为无穷远点
+    g1_generator.clear();
+    g2_generator.clear();
+}
+
+ExpressiveTrustedSetup::~ExpressiveTrustedSetup() {
+    try {
+        waitForExtension();
+    } catch (...) {
+        // 析构时无人接收后台扩展的错误，只需保证线程已结束
+    }
 }
 
 /**
@@ -153,18 +124,281 @@ ExpressiveTrustedSetup::ExpressiveTrustedSetup(const Fr& s, const Fr& r, size_t
  *          直到所需的最大次数。这些预计算的值是所有后续累加器操作和证明的基础。
  */
 void ExpressiveTrustedSetup::generatePowers() {
+    generatePowers(max_degree);
+}
+
+void ExpressiveTrustedSetup::generatePowers(size_t initial_degree) {
+    if (!has_secret) {
+        throw std::logic_error("ExpressiveTrustedSetup: imported setup has no secret to generate powers from");
+    }
+    waitForExtension();
+    // 幂次表将被重建，旧的预计算表随之失效
+    disablePrecomputation();
     hashAndMapToG1(g1_generator, "expressive_generator_g1", 12);
     hashAndMapToG2(g2_generator, "expressive_generator_g2", 12);
-    
-    g1_s_powers.resize(max_degree + 2);
-    g2_s_powers.resize(max_degree + 2);
-    
-    for (size_t i = 0; i <= max_degree + 1; ++i) {
-        Fr s_power;
-        Fr::pow(s_power, secret_s, i);
-        G1::mul(g1_s_powers[i], g1_generator, s_power);
-        G2::mul(g2_s_powers[i], g2_generator, s_power);
+    powers_generated = true;
+
+    g1_s_powers.clear();
+    g2_s_powers.clear();
+    extendPowers(initial_degree + 2);
+}
+
+/**
+ * @details 按块生成并写入幂次表：每块先用批量求逆规范化，再整体发布，
+ *          读取者随时可以看到已完成的块；压缩存储时也不需要先持有整张 Jacobian 表。
+ */
+void ExpressiveTrustedSetup::extendPowers(size_t count) const {
+    std::lock_guard<std::mutex> lock(growth_mutex);
+    if (!has_secret) {
+        throw std::logic_error("ExpressiveTrustedSetup: imported setup cannot be extended");
+    }
+    if (!powers_generated) {
+        throw std::logic_error("ExpressiveTrustedSetup: generatePowers must be called before extending");
+    }
+
+    const size_t block = PowerTable<G1>::CHUNK_SIZE;
+    std::vector<G1> g1_block;
+    std::vector<G2> g2_block;
+    size_t begin = g1_s_powers.size();
+    Fr s_power;
+    Fr::pow(s_power, secret_s, static_cast<int64_t>(begin));
+    while (begin < count) {
+        // 与块边界对齐，每次恰好填满当前块
+        const size_t cnt = std::min(block - begin % block, count - begin);
+        g1_block.resize(cnt);
+        g2_block.resize(cnt);
+        for (size_t k = 0; k < cnt; ++k) {
+            G1::mul(g1_block[k], g1_generator, s_power);
+            G2::mul(g2_block[k], g2_generator, s_power);
+            s_power *= secret_s;
+        }
+        // 所有 z 坐标一起求逆，转换为仿射坐标
+        BatchInversion::normalizePoints(g1_block, 0);
+        BatchInversion::normalizePoints(g2_block, 0);
+        // 先发布 G2 再发布 G1：以 G1 表长为准的读取者总能读到对应的 G2 点
+        g2_s_powers.append(g2_block);
+        g1_s_powers.append(g1_block);
+        begin += cnt;
+    }
+}
+
+void ExpressiveTrustedSetup::ensureDegree(size_t degree) const {
+    rethrowExtensionError();
+    if (degree + 2 > g1_s_powers.size()) {
+        extendPowers(degree + 2);
+    }
+}
+
+void ExpressiveTrustedSetup::reserveDegree(size_t degree) const {
+    const size_t available = g1_s_powers.size();
+    if (degree + 2 <= available || !powers_generated || !has_secret || !background_extension.load()) return;
+    // 几何增长，避免集合逐个增长时频繁启动扩展；不超过幂次表容量，更高的幂次由 s 直接计算
+    const size_t capacity = PowerTable<G1>::MAX_CHUNKS * PowerTable<G1>::CHUNK_SIZE;
+    const size_t target = std::min(std::max(degree + 2, 2 * available), capacity);
+    if (target <= available) return;
+
+    std::lock_guard<std::mutex> lock(extension_mutex);
+    extension_target = std::max(extension_target, target);
+    if (extension_running) return; // 运行中的线程会读到新的目标
+    if (extension_thread.joinable()) extension_thread.join(); // 已结束的上一个线程
+    extension_running = true;
+    extension_thread = std::thread([this]() {
+        try {
+            for (;;) {
+                size_t goal;
+                {
+                    std::lock_guard<std::mutex> guard(extension_mutex);
+                    if (g1_s_powers.size() >= extension_target) {
+                        extension_running = false;
+                        return;
+                    }
+                    goal = extension_target;
+                }
+                // 每次只扩展一块，让新的目标尽快生效
+                extendPowers(std::min(goal, g1_s_powers.size() + PowerTable<G1>::CHUNK_SIZE));
+            }
+        } catch (...) {
+            // 异常逃出线程会调用 std::terminate，保存下来交给 waitForExtension/ensureDegree 抛出
+            std::lock_guard<std::mutex> guard(extension_mutex);
+            extension_error = std::current_exception();
+            extension_target = 0;
+            extension_running = false;
+        }
+    });
+}
+
+void ExpressiveTrustedSetup::waitForExtension() const {
+    std::thread finished;
+    {
+        std::lock_guard<std::mutex> lock(extension_mutex);
+        finished = std::move(extension_thread);
+    }
+    if (finished.joinable()) finished.join();
+    rethrowExtensionError();
+}
+
+void ExpressiveTrustedSetup::rethrowExtensionError() const {
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(extension_mutex);
+        error = extension_error;
+        extension_error = nullptr;
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+G1 ExpressiveTrustedSetup::getG1_s_pow(int i) const {
+    if (i < 0) throw std::out_of_range("ExpressiveTrustedSetup: negative power");
+    if (static_cast<size_t>(i) < g1_s_powers.size()) return g1_s_powers.get(i);
+    if (!has_secret) throw std::out_of_range("ExpressiveTrustedSetup: power beyond imported table");
+    reserveDegree(i);
+    Fr s_power;
+    Fr::pow(s_power, secret_s, static_cast<int64_t>(i));
+    G1 result;
+    G1::mul(result, g1_generator, s_power);
+    return result;
+}
+
+G2 ExpressiveTrustedSetup::getG2_s_pow(int i) const {
+    if (i < 0) throw std::out_of_range("ExpressiveTrustedSetup: negative power");
+    if (static_cast<size_t>(i) < g2_s_powers.size()) return g2_s_powers.get(i);
+    if (!has_secret) throw std::out_of_range("ExpressiveTrustedSetup: power beyond imported table");
+    reserveDegree(i);
+    Fr s_power;
+    Fr::pow(s_power, secret_s, static_cast<int64_t>(i));
+    G2 result;
+    G2::mul(result, g2_generator, s_power);
+    return result;
+}
+
+bool ExpressiveTrustedSetup::validateSetup(size_t num_threads) const {
+    // 以 G1 表长为准，G2 表总是先于 G1 发布
+    const size_t n = g1_s_powers.size();
+    if (n < 2 || g2_s_powers.size() < n) return false;
+
+    const G1 P0 = g1_s_powers.get(0), P1 = g1_s_powers.get(1);
+    const G2 Q0 = g2_s_powers.get(0), Q1 = g2_s_powers.get(1);
+    if (P0.isZero() || P1.isZero() || Q0.isZero() || Q1.isZero()) return false;
+
+    // rho_lo[i] = ρ_i (i < n - 1)，rho_hi[i + 1] = ρ_i：同一组系数分别作用于 P_i 和 P_{i+1}
+    std::vector<Fr> rho_lo(n, Fr(0)), rho_hi(n, Fr(0)), tau_lo(n, Fr(0)), tau_hi(n, Fr(0));
+    for (size_t i = 0; i + 1 < n; ++i) {
+        rho_lo[i].setByCSPRNG();
+        tau_lo[i].setByCSPRNG();
+        rho_hi[i + 1] = rho_lo[i];
+        tau_hi[i + 1] = tau_lo[i];
     }
+
+    G1 A, B;
+    G2 C, D;
+    g1_s_powers.multiExp(A, rho_lo.data(), n, num_threads);
+    g1_s_powers.multiExp(B, rho_hi.data(), n, num_threads);
+    g2_s_powers.multiExp(C, tau_lo.data(), n, num_threads);
+    g2_s_powers.multiExp(D, tau_hi.data(), n, num_threads);
+
+    // e(A, Q_1) · e(-B, Q_0) · e(P_1, C) · e(-P_0, D) == 1
+    G1 g1_points[4] = {A, -B, P1, -P0};
+    G2 g2_points[4] = {Q1, Q0, C, D};
+    GT ml, result;
+    millerLoopVec(ml, g1_points, g2_points, 4);
+    finalExp(result, ml);
+    return result.isOne();
+}
+
+namespace {
+
+// Σ_{i ≥ begin} c_i·s^i（Horner 法）
+Fr evaluateTail(const std::vector<Fr>& coeffs, size_t begin, const Fr& s) {
+    Fr acc = 0;
+    for (size_t i = coeffs.size(); i-- > begin;) {
+        acc = acc * s + coeffs[i];
+    }
+    Fr s_begin;
+    Fr::pow(s_begin, s, static_cast<int64_t>(begin));
+    return acc * s_begin;
+}
+
+} // namespace
+
+G1 ExpressiveTrustedSetup::commitG1(const std::vector<Fr>& coeffs, size_t num_threads) const {
+    const size_t covered = std::min(coeffs.size(), g1_s_powers.size());
+    G1 commitment, rest;
+    commitment.clear();
+    size_t first = 0;
+    // 被预计算覆盖的低次部分只需要点加
+    auto precomputed = std::atomic_load(&g1_precomputed);
+    if (precomputed) {
+        first = std::min(covered, precomputed->size());
+        precomputed->multiExp(commitment, coeffs.data(), first, num_threads);
+    }
+    g1_s_powers.multiExpRange(rest, coeffs.data() + first, first, covered, num_threads);
+    commitment += rest;
+    if (covered < coeffs.size()) {
+        if (!has_secret) {
+            throw std::invalid_argument("ExpressiveTrustedSetup: polynomial degree exceeds imported table");
+        }
+        reserveDegree(coeffs.size() - 1);
+        G1 tail;
+        G1::mul(tail, g1_generator, evaluateTail(coeffs, covered, secret_s));
+        commitment += tail;
+    }
+    return commitment;
+}
+
+G2 ExpressiveTrustedSetup::commitG2(const std::vector<Fr>& coeffs, size_t num_threads) const {
+    const size_t covered = std::min(coeffs.size(), g2_s_powers.size());
+    G2 commitment, rest;
+    commitment.clear();
+    size_t first = 0;
+    // 被预计算覆盖的低次部分只需要点加
+    auto precomputed = std::atomic_load(&g2_precomputed);
+    if (precomputed) {
+        first = std::min(covered, precomputed->size());
+        precomputed->multiExp(commitment, coeffs.data(), first, num_threads);
+    }
+    g2_s_powers.multiExpRange(rest, coeffs.data() + first, first, covered, num_threads);
+    commitment += rest;
+    if (covered < coeffs.size()) {
+        if (!has_secret) {
+            throw std::invalid_argument("ExpressiveTrustedSetup: polynomial degree exceeds imported table");
+        }
+        reserveDegree(coeffs.size() - 1);
+        G2 tail;
+        G2::mul(tail, g2_generator, evaluateTail(coeffs, covered, secret_s));
+        commitment += tail;
+    }
+    return commitment;
+}
+
+size_t ExpressiveTrustedSetup::enablePrecomputation(size_t window, size_t memory_budget, size_t num_threads) {
+    if (window < PrecomputedMsm<G1>::MIN_WINDOW || window > PrecomputedMsm<G1>::MAX_WINDOW) {
+        throw std::invalid_argument("ExpressiveTrustedSetup: precomputation window out of range");
+    }
+    size_t count = std::min(g1_s_powers.size(), g2_s_powers.size());
+    if (memory_budget != 0) {
+        const size_t per_base = PrecomputedMsm<G1>::bytesPerBase(window) + PrecomputedMsm<G2>::bytesPerBase(window);
+        count = std::min(count, memory_budget / per_base);
+    }
+
+    auto g1_table = std::make_shared<PrecomputedMsm<G1>>();
+    auto g2_table = std::make_shared<PrecomputedMsm<G2>>();
+    g1_table->build(g1_s_powers, count, window, num_threads);
+    g2_table->build(g2_s_powers, count, window, num_threads);
+    std::atomic_store(&g1_precomputed, std::shared_ptr<const PrecomputedMsm<G1>>(g1_table));
+    std::atomic_store(&g2_precomputed, std::shared_ptr<const PrecomputedMsm<G2>>(g2_table));
+    return count;
+}
+
+void ExpressiveTrustedSetup::disablePrecomputation() {
+    std::atomic_store(&g1_precomputed, std::shared_ptr<const PrecomputedMsm<G1>>());
+    std::atomic_store(&g2_precomputed, std::shared_ptr<const PrecomputedMsm<G2>>());
+}
+
+size_t ExpressiveTrustedSetup::precomputedBytes() const {
+    size_t bytes = 0;
+    if (auto table = std::atomic_load(&g1_precomputed)) bytes += table->memoryBytes();
+    if (auto table = std::atomic_load(&g2_precomputed)) bytes += table->memoryBytes();
+    return bytes;
 }
 
 
@@ -191,14 +425,38 @@ Fr CharacteristicPolynomial::evaluate(const Fr& a) const {
         return Fr(1); // 空集的多项式是 P(z) = 1
     }
     
+    // 按块交给多通道内核计算 ∏ (a - r)
+    const size_t CHUNK = 256;
+    int roots[CHUNK];
+    size_t count = 0;
     Fr res(1);
     for (int r : elements) {
-        Fr r_fr = r;
-        res *= (a - r_fr);
+        roots[count++] = r;
+        if (count == CHUNK) {
+            res *= FrSimd::linearProduct(a, roots, count);
+            count = 0;
+        }
+    }
+    if (count > 0) {
+        res *= FrSimd::linearProduct(a, roots, count);
     }
     return res;
 }
 
+std::vector<Fr> CharacteristicPolynomial::multiEvaluate(const std::vector<Fr>& points, size_t num_threads) const {
+    // 点数很少时展开系数不划算，逐点求值
+    if (points.size() <= MULTI_EVALUATE_DIRECT_LIMIT) {
+        std::vector<Fr> values(points.size());
+        for (size_t j = 0; j < points.size(); ++j) {
+            values[j] = evaluate(points[j]);
+        }
+        return values;
+    }
+    std::vector<Fr> roots(elements.begin(), elements.end());
+    FrPolynomial::Poly coeffs = FrPolynomial::fromRoots(roots, num_threads);
+    return FrPolynomial::multiEvaluate(coeffs, points, num_threads);
+}
+
 std::set<int> CharacteristicPolynomial::intersection(const std::set<int>& set1, const std::set<int>& set2) {
     std::set<int> result;
     std::set_intersection(set1.begin(), set1.end(), 
@@ -213,7 +471,11 @@ std::set<int> CharacteristicPolynomial::intersection(const std::set<int>& set1,
 
 ExpressiveAccumulator::ExpressiveAccumulator(const ExpressiveTrustedSetup& setup, GroupType type)
     : trusted_setup(setup), group_type(type) {
+    if (!setup.hasSecret()) {
+        throw std::logic_error("ExpressiveAccumulator: setup has no secret to maintain P(s) with");
+    }
     polynomial = std::make_unique<CharacteristicPolynomial>(std::set<int>());
+    poly_at_s = 1; // 空集的多项式是 P(z) = 1
     if (type == G1_TYPE) {
         digest_g1.initialize(setup.getG1Generator());
     } else {
@@ -222,18 +484,34 @@ ExpressiveAccumulator::ExpressiveAccumulator(const ExpressiveTrustedSetup& setup
 }
 
 /**
- * @brief 根据当前的元素集合更新累加器的摘要值。
- * @details 在任何元素变更（添加/删除）后调用此函数。
- *          它会重新评估特征多项式 P(s) 并将摘要更新为 g^P(s)。
+ * @brief 根据缓存的 P(s) 更新累加器的摘要值。
+ * @details 在任何元素变更（添加/删除）后调用此函数，将摘要更新为 g^P(s)。
  */
 void ExpressiveAccumulator::updateAccumulatorValue() {
-    Fr poly_eval = polynomial->evaluate(trusted_setup.getSecretS());
-    
     if (group_type == G1_TYPE) {
-        G1::mul(digest_g1.value, trusted_setup.getG1Generator(), poly_eval);
+        G1::mul(digest_g1.value, trusted_setup.getG1Generator(), poly_at_s);
     } else { // G2_TYPE
-        G2::mul(digest_g2.value, trusted_setup.getG2Generator(), poly_eval);
+        G2::mul(digest_g2.value, trusted_setup.getG2Generator(), poly_at_s);
+    }
+}
+
+/**
+ * @brief 元素 x 的见证值 Q(s) = P(s)/(s - x)。
+ * @details 商多项式 Q(z) 就是除 (z - x) 外其余 (z - r) 项的乘积，
+ *          由缓存的 P(s) 除以 (s - x) 得到，无需对剩余元素重新求值。
+ *          仅当 s 恰为集合元素时 (s - x) 为零，此时退回直接求值。
+ */
+Fr ExpressiveAccumulator::witnessValue(int element) const {
+    const Fr& secret_s = trusted_setup.getSecretS();
+    Fr denominator = secret_s - Fr(element);
+    if (denominator.isZero()) {
+        std::set<int> witness_elements = elements;
+        witness_elements.erase(element);
+        return CharacteristicPolynomial(witness_elements).evaluate(secret_s);
     }
+    Fr witness_s;
+    Fr::div(witness_s, poly_at_s, denominator);
+    return witness_s;
 }
 
 /**
@@ -249,7 +527,10 @@ UpdateProof ExpressiveAccumulator::addElement(int element) {
     if (elements.find(element) == elements.end()) {
         elements.insert(element);
         polynomial->addElement(element);
+        poly_at_s *= trusted_setup.getSecretS() - Fr(element);
         updateAccumulatorValue();
+        // 集合超出幂次表覆盖的次数时在后台扩展，不阻塞本次更新
+        trusted_setup.reserveDegree(elements.size());
     }
     
     proof.new_digest = this->getDigest();
@@ -260,6 +541,7 @@ UpdateProof ExpressiveAccumulator::addElement(int element) {
 /**
  * @brief 删除元素并返回操作证明。
  * @details 在删除前，会先生成一个成员关系证明来证明删除的“权利”。
+ *          删除后的 P'(s) 恰好等于该证明的见证值 P(s)/(s - x)，直接复用。
  */
 UpdateProof ExpressiveAccumulator::deleteElement(int element) {
     UpdateProof proof;
@@ -273,15 +555,13 @@ UpdateProof ExpressiveAccumulator::deleteElement(int element) {
         return proof;
     }
     
-    proof.membership_proof = this->generateMembershipProof(element);
-    if (!proof.membership_proof.is_member) {
-        proof.is_valid = false;
-        proof.new_digest = this->getDigest(); 
-        return proof;
-    }
+    Fr witness_s = witnessValue(element);
+    proof.membership_proof.is_member = true;
+    G2::mul(proof.membership_proof.witness_g2, trusted_setup.getG2Generator(), witness_s);
 
     polynomial->removeElement(element);
     elements.erase(element);
+    poly_at_s = witness_s;
     updateAccumulatorValue();
     proof.new_digest = this->getDigest();
     proof.is_valid = true;
@@ -289,6 +569,36 @@ UpdateProof ExpressiveAccumulator::deleteElement(int element) {
     return proof;
 }
 
+void ExpressiveAccumulator::applyUpdates(const std::vector<int>& added, const std::vector<int>& removed) {
+    std::vector<int> removing;
+    for (int el : std::set<int>(removed.begin(), removed.end())) {
+        if (elements.erase(el) != 0) {
+            polynomial->removeElement(el);
+            removing.push_back(el);
+        }
+    }
+    std::vector<int> adding;
+    for (int el : std::set<int>(added.begin(), added.end())) {
+        if (elements.insert(el).second) {
+            polynomial->addElement(el);
+            adding.push_back(el);
+        }
+    }
+    if (adding.empty() && removing.empty()) return;
+
+    const Fr& secret_s = trusted_setup.getSecretS();
+    Fr removed_s = FrSimd::linearProduct(secret_s, removing.data(), removing.size());
+    if (removed_s.isZero()) {
+        // s 恰为被删除的元素，无法相除，退回直接求值
+        poly_at_s = polynomial->evaluate(secret_s);
+    } else {
+        Fr::inv(removed_s, removed_s);
+        poly_at_s *= removed_s * FrSimd::linearProduct(secret_s, adding.data(), adding.size());
+    }
+    updateAccumulatorValue();
+    trusted_setup.reserveDegree(elements.size());
+}
+
 MembershipProof ExpressiveAccumulator::generateMembershipProof(int element) const {
     MembershipProof proof;
     if (elements.find(element) == elements.end()) {
@@ -297,19 +607,250 @@ MembershipProof ExpressiveAccumulator::generateMembershipProof(int element) cons
     }
     proof.is_member = true;
 
-    // 计算商多项式 Q(z) = (P(z) - P_x(z)) / (z - x)
-    // P_x(z) = z-x. P_x(s) = s-x
-    // Q(z) 实际上就是除了 (z-x) 之外的所有其他 (z-r) 项的乘积
-    std::set<int> witness_elements = elements;
-    witness_elements.erase(element);
-    CharacteristicPolynomial witness_poly(witness_elements);
-    
-    Fr witness_s = witness_poly.evaluate(trusted_setup.getSecretS());
+    // 商多项式 Q(z) = P(z) / (z - x)，P_x(s) = s - x
+    Fr witness_s = witnessValue(element);
     G2::mul(proof.witness_g2, trusted_setup.getG2Generator(), witness_s);
     
     return proof;
 }
 
+std::vector<MembershipProof> ExpressiveAccumulator::generateMembershipProofs(
+    const std::vector<int>& query, size_t num_threads) const {
+
+    std::vector<MembershipProof> proofs(query.size());
+    std::vector<size_t> members;
+    std::vector<Fr> roots;
+    for (size_t i = 0; i < query.size(); ++i) {
+        if (elements.find(query[i]) == elements.end()) continue;
+        members.push_back(i);
+        roots.push_back(Fr(query[i]));
+    }
+    // 零分母时退回单元素路径
+    std::vector<G2> witnesses = batchWitnesses(
+        trusted_setup, poly_at_s, roots, [&](size_t k) { return witnessValue(query[members[k]]); }, num_threads);
+    for (size_t k = 0; k < members.size(); ++k) {
+        proofs[members[k]].witness_g2 = witnesses[k];
+        proofs[members[k]].is_member = true;
+    }
+    return proofs;
+}
+
+std::vector<G2> ExpressiveAccumulator::batchWitnesses(const ExpressiveTrustedSetup& setup,
+                                                      const Fr& poly_at_s,
+                                                      const std::vector<Fr>& roots,
+                                                      const std::function<Fr(size_t)>& fallback,
+                                                      size_t num_threads) {
+    // 1. 所有分母 (s - x_k) 一起求逆
+    const Fr& secret_s = setup.getSecretS();
+    std::vector<Fr> denominators(roots.size());
+    for (size_t k = 0; k < roots.size(); ++k) denominators[k] = secret_s - roots[k];
+    BatchInversion::invertParallel(denominators, num_threads);
+
+    // 2. 见证 W_k = g2^{P(s)/(s - x_k)}，按根分块并行
+    std::vector<G2> witnesses(roots.size());
+    const G2 g2_generator = setup.getG2Generator();
+    auto worker = [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            // 零分母求逆后仍为零，交给调用者直接求值
+            Fr witness_s = denominators[k].isZero() ? fallback(k) : poly_at_s * denominators[k];
+            G2::mul(witnesses[k], g2_generator, witness_s);
+        }
+    };
+
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, std::max<size_t>(1, roots.size()));
+    if (num_threads <= 1) {
+        worker(0, roots.size());
+    } else {
+        std::vector<std::thread> threads;
+        size_t chunk = (roots.size() + num_threads - 1) / num_threads;
+        for (size_t begin = 0; begin < roots.size(); begin += chunk) {
+            threads.emplace_back(worker, begin, std::min(begin + chunk, roots.size()));
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    // 3. 见证一起规范化为仿射坐标，序列化和比较时不再逐个求逆
+    BatchInversion::normalizePoints(witnesses, num_threads);
+    return witnesses;
+}
+
+/**
+ * @brief 生成批量成员关系证明。
+ * @details 商多项式 Q(z) = P(z) / ∏(z - x_i) 恰为集合中其余元素的特征多项式，
+ *          由缓存的 P(s) 除以子集在 s 处的值得到，代价只与子集大小 m 有关。
+ */
+BatchMembershipProof ExpressiveAccumulator::generateBatchMembershipProof(const std::vector<int>& elements) const {
+    BatchMembershipProof proof;
+    std::set<int> subset(elements.begin(), elements.end());
+    for (int el : subset) {
+        if (this->elements.find(el) == this->elements.end()) {
+            proof.is_member = false;
+            return proof;
+        }
+    }
+    proof.is_member = true;
+
+    const Fr& secret_s = trusted_setup.getSecretS();
+    Fr subset_s = CharacteristicPolynomial(subset).evaluate(secret_s);
+    Fr witness_s;
+    if (subset_s.isZero()) {
+        // s 恰为子集元素，退回对剩余元素直接求值
+        std::set<int> witness_elements;
+        std::set_difference(this->elements.begin(), this->elements.end(), subset.begin(), subset.end(),
+                            std::inserter(witness_elements, witness_elements.begin()));
+        witness_s = CharacteristicPolynomial(witness_elements).evaluate(secret_s);
+    } else {
+        Fr::div(witness_s, poly_at_s, subset_s);
+    }
+    G2::mul(proof.witness_g2, trusted_setup.getG2Generator(), witness_s);
+
+    return proof;
+}
+
+/**
+ * @brief 验证批量成员关系证明。
+ * @details 与单元素验证相同，只是把 (s - x) 换成子集的特征多项式 ∏(s - x_i)，
+ *          验证开销为 O(m) 次域运算加两次配对。
+ */
+bool ExpressiveAccumulator::verifyBatchMembershipProof(
+    const AccumulatorDigest& acc_digest,
+    const std::vector<int>& elements,
+    const BatchMembershipProof& proof,
+    const ExpressiveTrustedSetup& setup) {
+
+    if (!proof.is_member) {
+        return false;
+    }
+
+    std::set<int> subset(elements.begin(), elements.end());
+    Fr subset_s = CharacteristicPolynomial(subset).evaluate(setup.getSecretS());
+
+    GT lhs, rhs;
+    pairing(lhs, acc_digest.value, setup.getG2Generator());
+
+    G1 subset_g1;
+    G1::mul(subset_g1, setup.getG1Generator(), subset_s);
+    pairing(rhs, subset_g1, proof.witness_g2);
+
+    return lhs == rhs;
+}
+
+/**
+ * @brief 生成跨累加器成员关系证明。
+ * @details 各集合的见证值 A_i(s)/(s-x) 相互独立，按累加器分块在多个线程上并行求值；
+ *          随后在标量域内完成随机线性组合，最终只做一次 G2 标量乘法。
+ */
+CrossMembershipProof ExpressiveAccumulator::generateCrossMembershipProof(
+    const std::vector<const ExpressiveAccumulator*>& accs,
+    int element,
+    const ExpressiveTrustedSetup& setup,
+    size_t num_threads) {
+
+    CrossMembershipProof proof;
+    std::vector<AccumulatorDigest> digests;
+    for (const ExpressiveAccumulator* acc : accs) {
+        if (acc->getElements().find(element) == acc->getElements().end()) {
+            proof.is_member = false;
+            return proof;
+        }
+        digests.push_back(acc->getDigest());
+    }
+    proof.is_member = true;
+
+    // 1. 并行计算每个集合的见证值 w_i = (A_i \ {x})(s)
+    const Fr& secret_s = setup.getSecretS();
+    std::vector<Fr> witness_values(accs.size());
+    auto worker = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            std::set<int> witness_elements = accs[i]->getElements();
+            witness_elements.erase(element);
+            witness_values[i] = CharacteristicPolynomial(witness_elements).evaluate(secret_s);
+        }
+    };
+
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, std::max<size_t>(1, accs.size()));
+    if (num_threads <= 1) {
+        worker(0, accs.size());
+    } else {
+        std::vector<std::thread> threads;
+        size_t chunk = (accs.size() + num_threads - 1) / num_threads;
+        for (size_t begin = 0; begin < accs.size(); begin += chunk) {
+            threads.emplace_back(worker, begin, std::min(begin + chunk, accs.size()));
+        }
+        for (auto& t : threads) t.join();
+    }
+
+    // 2. 随机线性组合 W = g2^{Σ ρ_i·w_i}
+    std::vector<Fr> rho = crossMembershipChallenges(digests, element);
+    Fr aggregated;
+    aggregated.clear();
+    for (size_t i = 0; i < accs.size(); ++i) {
+        aggregated += rho[i] * witness_values[i];
+    }
+    G2::mul(proof.witness_g2, setup.getG2Generator(), aggregated);
+
+    return proof;
+}
+
+bool ExpressiveAccumulator::verifyCrossMembershipProof(
+    const std::vector<AccumulatorDigest>& digests,
+    int element,
+    const CrossMembershipProof& proof,
+    const ExpressiveTrustedSetup& setup) {
+
+    if (!proof.is_member || digests.empty()) {
+        return false;
+    }
+
+    // Σ ρ_i·A_i
+    std::vector<Fr> rho = crossMembershipChallenges(digests, element);
+    std::vector<G1> digest_points(digests.size());
+    for (size_t i = 0; i < digests.size(); ++i) {
+        digest_points[i] = digests[i].value;
+    }
+    G1 combined_digest;
+    G1::mulVec(combined_digest, digest_points.data(), rho.data(), digests.size());
+
+    // g1^{-(s-x)}
+    Fr x;
+    x = element;
+    G1 neg_sx_g1;
+    G1::mul(neg_sx_g1, setup.getG1Generator(), x - setup.getSecretS());
+
+    // 两个 Miller 循环共享一次最终幂
+    G1 g1_points[2] = {combined_digest, neg_sx_g1};
+    G2 g2_points[2] = {setup.getG2Generator(), proof.witness_g2};
+    GT ml, result;
+    millerLoopVec(ml, g1_points, g2_points, 2);
+    finalExp(result, ml);
+    return result.isOne();
+}
+
+std::vector<Fr> fiatShamirChallenges(const std::string& domain,
+                                     const std::vector<AccumulatorDigest>& digests,
+                                     const std::string& transcript) {
+    std::string hashed = domain;
+    for (const std::string& digest : AccumulatorDigest::serializeBatch(digests)) {
+        hashed += digest;
+    }
+    hashed += transcript;
+    Fr seed;
+    seed.setHashOf(hashed);
+    std::string seed_str = seed.getStr(16);
+
+    std::vector<Fr> rho(digests.size());
+    for (size_t i = 0; i < rho.size(); ++i) {
+        rho[i].setHashOf(seed_str + "/" + std::to_string(i));
+    }
+    return rho;
+}
+
 /**
  * @brief 验证一个给定元素的成员关系证明。
  * @details 成员关系证明是交集证明的一个特例，用于证明主集合 A
@@ -324,7 +865,7 @@ MembershipProof ExpressiveAccumulator::generateMembershipProof(int element) cons
  */
 bool ExpressiveAccumulator::verifyMembershipProof(
     const AccumulatorDigest& acc_digest, 
-    int element, 
+    const Fr& element, 
     const MembershipProof& proof, 
     const ExpressiveTrustedSetup& setup) {
 
@@ -347,64 +888,72 @@ bool ExpressiveAccumulator::verifyMembershipProof(
     
     GT lhs, rhs;
     
-    // lhs = e(A, g2)
-    pairing(lhs, acc_digest.value, setup.getG2Generator());
+    // lhs = e(A, g2)，热点摘要直接命中缓存
+    setup.pairingCache().pairing(lhs, acc_digest.value, setup.getG2Generator());
 
     // rhs = e(g1^{s-x}, W)
     Fr s = setup.getSecretS();
-    Fr x;
-    x = element;
     G1 sx_g1;
-    G1::mul(sx_g1, setup.getG1Generator(), s - x);
+    G1::mul(sx_g1, setup.getG1Generator(), s - element);
     pairing(rhs, sx_g1, proof.witness_g2);
 
     return lhs == rhs;
 }
 
+bool ExpressiveAccumulator::verifyMembershipProof(
+    const AccumulatorDigest& acc_digest, 
+    int element, 
+    const MembershipProof& proof, 
+    const ExpressiveTrustedSetup& setup) {
+    return verifyMembershipProof(acc_digest, Fr(element), proof, setup);
+}
+
 
 IntersectionProof ExpressiveAccumulator::generateIntersectionProof(
     const ExpressiveAccumulator& acc1,
     const ExpressiveAccumulator& acc2,
     const ExpressiveTrustedSetup& setup)
+{
+    return generateIntersectionProof(acc1.getElements(), acc2.getElements(), setup);
+}
+
+IntersectionProof ExpressiveAccumulator::generateIntersectionProof(
+    const std::set<int>& set_a,
+    const std::set<int>& set_b,
+    const ExpressiveTrustedSetup& setup)
 {
     IntersectionProof proof;
     const Fr& secret_s = setup.getSecretS();
 
     // 1. 计算交集和差集
-    std::set<int> intersection_set = CharacteristicPolynomial::intersection(acc1.getElements(), acc2.getElements());
+    std::set<int> intersection_set = CharacteristicPolynomial::intersection(set_a, set_b);
     std::set<int> diff_A_set, diff_B_set;
-    std::set_difference(acc1.getElements().begin(), acc1.getElements().end(), intersection_set.begin(), intersection_set.end(), std::inserter(diff_A_set, diff_A_set.begin()));
-    std::set_difference(acc2.getElements().begin(), acc2.getElements().end(), intersection_set.begin(), intersection_set.end(), std::inserter(diff_B_set, diff_B_set.begin()));
-
-    // 2. 使用 FLINT 构建多项式
-    fmpz_mod_poly_t poly_I, poly_QA, poly_QB;
-    PolynomialUtils::fromRoots(poly_I, intersection_set, flint_ctx);
-    PolynomialUtils::fromRoots(poly_QA, diff_A_set, flint_ctx);
-    PolynomialUtils::fromRoots(poly_QB, diff_B_set, flint_ctx);
-
-    // 3. 计算 I, Q_A, Q_B 多项式在 s 处的值
-    Fr I_s = PolynomialUtils::evaluate(poly_I, secret_s, flint_ctx);
-    Fr QA_s = PolynomialUtils::evaluate(poly_QA, secret_s, flint_ctx);
-    Fr QB_s = PolynomialUtils::evaluate(poly_QB, secret_s, flint_ctx);
+    std::set_difference(set_a.begin(), set_a.end(), intersection_set.begin(), intersection_set.end(), std::inserter(diff_A_set, diff_A_set.begin()));
+    std::set_difference(set_b.begin(), set_b.end(), intersection_set.begin(), intersection_set.end(), std::inserter(diff_B_set, diff_B_set.begin()));
+
+    // 2. 交集多项式只需要在 s 处求值；Q_A、Q_B 由乘积树展开为系数形式供 xgcd 使用
+    Fr I_s = CharacteristicPolynomial(intersection_set).evaluate(secret_s);
+    FrPolynomial::Poly poly_QA = FrPolynomial::fromRoots(diff_A_set);
+    FrPolynomial::Poly poly_QB = FrPolynomial::fromRoots(diff_B_set);
+
+    // 3. 计算 Q_A, Q_B 多项式在 s 处的值
+    Fr QA_s = FrPolynomial::evaluate(poly_QA, secret_s);
+    Fr QB_s = FrPolynomial::evaluate(poly_QB, secret_s);
     
     // 4. 创建子集证明的承诺
     G1::mul(proof.intersection_digest_g1.value, setup.getG1Generator(), I_s);
     G2::mul(proof.witness_QA_g2, setup.getG2Generator(), QA_s);
     G2::mul(proof.witness_QB_g2, setup.getG2Generator(), QB_s);
 
-    // 5. 使用 FLINT 计算不相交证明
-    fmpz_mod_poly_t gcd, a, b;
-    fmpz_mod_poly_init(gcd, flint_ctx);
-    fmpz_mod_poly_init(a, flint_ctx);
-    fmpz_mod_poly_init(b, flint_ctx);
+    // 5. 计算不相交证明 (half-GCD 扩展欧几里得)
+    FrPolynomial::Poly gcd, a, b;
+    FrPolynomial::xgcd(gcd, a, b, poly_QA, poly_QB);
 
-    fmpz_mod_poly_xgcd(gcd, a, b, poly_QA, poly_QB, flint_ctx);
-
-    if (!fmpz_mod_poly_is_one(gcd, flint_ctx)) {
+    if (!FrPolynomial::isOne(gcd)) {
         proof.is_valid = false;
     } else {
-        Fr a_s = PolynomialUtils::evaluate(a, secret_s, flint_ctx);
-        Fr b_s = PolynomialUtils::evaluate(b, secret_s, flint_ctx);
+        Fr a_s = FrPolynomial::evaluate(a, secret_s);
+        Fr b_s = FrPolynomial::evaluate(b, secret_s);
 
         // 6. 创建不相交证明的承诺
         G1::mul(proof.witness_a_g1, setup.getG1Generator(), a_s);
@@ -412,14 +961,6 @@ IntersectionProof ExpressiveAccumulator::generateIntersectionProof(
         proof.is_valid = true;
     }
 
-    // 7. 清理所有 FLINT 对象
-    fmpz_mod_poly_clear(poly_I, flint_ctx);
-    fmpz_mod_poly_clear(poly_QA, flint_ctx);
-    fmpz_mod_poly_clear(poly_QB, flint_ctx);
-    fmpz_mod_poly_clear(gcd, flint_ctx);
-    fmpz_mod_poly_clear(a, flint_ctx);
-    fmpz_mod_poly_clear(b, flint_ctx);
-
     return proof;
 }
 
@@ -435,20 +976,23 @@ bool ExpressiveAccumulator::verifyIntersectionProof(
     G1 g1_gen = setup.getG1Generator();
     G2 g2_gen = setup.getG2Generator();
 
+    // e(A, g2)、e(B, g2) 与常量 e(g1, g2) 经过配对缓存
+    PairingCache& cache = setup.pairingCache();
+
     // 1. 验证 I ⊆ A: e(A, g2) == e(I, W_QA)
-    pairing(e1, digest_A.value, g2_gen);
+    cache.pairing(e1, digest_A.value, g2_gen);
     pairing(e2, proof.intersection_digest_g1.value, proof.witness_QA_g2);
     if (e1 != e2) return false;
 
     // 2. 验证 I ⊆ B: e(B, g2) == e(I, W_QB)
-    pairing(e1, digest_B.value, g2_gen);
+    cache.pairing(e1, digest_B.value, g2_gen);
     pairing(e2, proof.intersection_digest_g1.value, proof.witness_QB_g2);
     if (e1 != e2) return false;
 
     // 3. 验证 (A\\I) 和 (B\\I) 不相交: e(W_a, W_QA) * e(W_b, W_QB) == e(g1, g2)
     pairing(e3, proof.witness_a_g1, proof.witness_QA_g2);
     pairing(e4, proof.witness_b_g1, proof.witness_QB_g2);
-    pairing(e5, g1_gen, g2_gen);
+    cache.pairing(e5, g1_gen, g2_gen);
     if (e3 * e4 != e5) return false;
 
     return true;
@@ -473,10 +1017,10 @@ bool ExpressiveAccumulator::verifyUpdateProof(const UpdateProof& proof, const Ex
     if (proof.op_type == UpdateOperation::ADD) {
         // 验证 e(new, g2) == e(old, g2^s) * e(old, g2)^(-x)
         Fp12 lhs, rhs1, rhs2_base, rhs2, rhs;
-        pairing(lhs, proof.new_digest.value, g2_gen);
+        setup.pairingCache().pairing(lhs, proof.new_digest.value, g2_gen);
         pairing(rhs1, proof.old_digest.value, g2_s);
         
-        pairing(rhs2_base, proof.old_digest.value, g2_gen);
+        setup.pairingCache().pairing(rhs2_base, proof.old_digest.value, g2_gen);
         Fp12::pow(rhs2, rhs2_base, -element_fr); // 指数上的减法
 
         Fp12::mul(rhs, rhs1, rhs2);
@@ -493,10 +1037,10 @@ bool ExpressiveAccumulator::verifyUpdateProof(const UpdateProof& proof, const Ex
         
         // 2. 验证代数关系 e(old, g2) == e(new, g2^s) * e(new, g2)^(-x)
         Fp12 lhs, rhs1, rhs2_base, rhs2, rhs;
-        pairing(lhs, proof.old_digest.value, g2_gen);
+        setup.pairingCache().pairing(lhs, proof.old_digest.value, g2_gen);
         pairing(rhs1, proof.new_digest.value, g2_s);
 
-        pairing(rhs2_base, proof.new_digest.value, g2_gen);
+        setup.pairingCache().pairing(rhs2_base, proof.new_digest.value, g2_gen);
         Fp12::pow(rhs2, rhs2_base, -element_fr);
 
         Fp12::mul(rhs, rhs1, rhs2);
@@ -0,0 +1,196 @@
+/**
+ * @file fr_ntt.cpp
+ * @brief Fr 上迭代式 radix-2 NTT 的实现。
+ */
+#include "fr_ntt.h"
+#include "fr_simd.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace expressive_accumulator {
+namespace FrNtt {
+
+namespace {
+
+// 变换长度低于该值时不拆分线程
+const size_t PARALLEL_MIN_SIZE = 1 << 12;
+// 每批交给向量乘法内核的蝶形数
+const size_t BUTTERFLY_BATCH = 64;
+
+size_t resolveThreads(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return num_threads;
+}
+
+// 以 num_threads 个线程对 [0, count) 分块执行 fn(begin, end)
+template <typename Fn>
+void parallelRanges(size_t count, size_t num_threads, const Fn& fn) {
+    num_threads = std::min(num_threads, count);
+    if (num_threads <= 1) {
+        fn(0, count);
+        return;
+    }
+    std::vector<std::thread> threads;
+    size_t chunk = (count + num_threads - 1) / num_threads;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        threads.emplace_back(fn, begin, std::min(begin + chunk, count));
+    }
+    for (auto& t : threads) t.join();
+}
+
+size_t log2Exact(size_t n) {
+    size_t log_n = 0;
+    while ((size_t(1) << log_n) < n) ++log_n;
+    if ((size_t(1) << log_n) != n) {
+        throw std::invalid_argument("FrNtt: transform size must be a power of two");
+    }
+    return log_n;
+}
+
+// roots[k] 为 2^k 次本原单位根，k = 0..MAX_LOG_SIZE
+std::vector<Fr> computeRoots() {
+    // (r - 1) / 2^32 作为整数小于 r，等于 -1 · 2^{-32} 在 Fr 中的值
+    Fr two_pow, cofactor;
+    Fr::pow(two_pow, Fr(2), static_cast<int64_t>(MAX_LOG_SIZE));
+    Fr::inv(cofactor, two_pow);
+    cofactor = -cofactor;
+
+    std::vector<Fr> roots(MAX_LOG_SIZE + 1);
+    Fr::pow(roots[MAX_LOG_SIZE], Fr(7), cofactor);
+    for (size_t k = MAX_LOG_SIZE; k > 0; --k) {
+        Fr::sqr(roots[k - 1], roots[k]);
+    }
+    return roots;
+}
+
+void bitReverse(std::vector<Fr>& a) {
+    const size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(a[i], a[j]);
+    }
+}
+
+/**
+ * @brief 原地 DIT 变换，root 为 n 次本原单位根。
+ * @details 旋转因子表 tw[j] = root^j (j < n/2) 先分块并行生成，
+ *          长度为 len 的蝶形层使用 tw[j·(n/len)]。
+ */
+void transform(std::vector<Fr>& a, const Fr& root, size_t num_threads) {
+    const size_t n = a.size();
+    if (n <= 1) return;
+    num_threads = (n < PARALLEL_MIN_SIZE) ? 1 : resolveThreads(num_threads);
+
+    bitReverse(a);
+
+    const size_t half_n = n / 2;
+    std::vector<Fr> tw(half_n);
+    parallelRanges(half_n, num_threads, [&](size_t begin, size_t end) {
+        Fr w;
+        Fr::pow(w, root, static_cast<int64_t>(begin));
+        for (size_t j = begin; j < end; ++j) {
+            tw[j] = w;
+            w *= root;
+        }
+    });
+
+    auto butterflies = [&](size_t len, size_t begin, size_t end) {
+        // 处理第 [begin, end) 个蝶形，每层共 n/2 个；
+        // 每批先收集 y 与旋转因子，由多通道内核一次算出全部 y·ω^j
+        const size_t half = len / 2;
+        const size_t stride = n / len;
+        Fr ys[BUTTERFLY_BATCH], ws[BUTTERFLY_BATCH];
+        for (size_t k0 = begin; k0 < end; k0 += BUTTERFLY_BATCH) {
+            const size_t cnt = std::min(BUTTERFLY_BATCH, end - k0);
+            for (size_t c = 0; c < cnt; ++c) {
+                const size_t k = k0 + c, block = k / half, j = k % half;
+                ys[c] = a[block * len + j + half];
+                ws[c] = tw[j * stride];
+            }
+            FrSimd::mulVec(ys, ys, ws, cnt);
+            for (size_t c = 0; c < cnt; ++c) {
+                const size_t k = k0 + c, block = k / half, j = k % half;
+                Fr& x = a[block * len + j];
+                Fr::sub(a[block * len + j + half], x, ys[c]);
+                Fr::add(x, x, ys[c]);
+            }
+        }
+    };
+
+    // 线程数取不超过 num_threads 的 2 的幂，每个线程先独立完成块内的低层蝶形
+    size_t parts = 1;
+    while (parts * 2 <= num_threads && parts * 2 <= n / 2) parts *= 2;
+    const size_t chunk = n / parts;
+    parallelRanges(parts, parts, [&](size_t begin, size_t end) {
+        for (size_t p = begin; p < end; ++p) {
+            for (size_t len = 2; len <= chunk; len <<= 1) {
+                // 块 p 内的蝶形下标区间
+                const size_t per_chunk = chunk / 2;
+                butterflies(len, p * per_chunk, (p + 1) * per_chunk);
+            }
+        }
+    });
+    // 跨块的高层蝶形：层内按下标区间并行
+    for (size_t len = chunk * 2; len <= n; len <<= 1) {
+        parallelRanges(half_n, parts, [&](size_t begin, size_t end) {
+            butterflies(len, begin, end);
+        });
+    }
+}
+
+} // namespace
+
+const Fr& rootOfUnity(size_t log_n) {
+    static const std::vector<Fr> roots = computeRoots();
+    if (log_n > MAX_LOG_SIZE) {
+        throw std::invalid_argument("FrNtt: transform size exceeds 2-adicity of Fr");
+    }
+    return roots[log_n];
+}
+
+void forward(std::vector<Fr>& a, size_t num_threads) {
+    if (a.size() <= 1) return;
+    transform(a, rootOfUnity(log2Exact(a.size())), num_threads);
+}
+
+void inverse(std::vector<Fr>& a, size_t num_threads) {
+    if (a.size() <= 1) return;
+    Fr root_inv;
+    Fr::inv(root_inv, rootOfUnity(log2Exact(a.size())));
+    transform(a, root_inv, num_threads);
+
+    Fr n_inv;
+    Fr::inv(n_inv, Fr(static_cast<int64_t>(a.size())));
+    num_threads = (a.size() < PARALLEL_MIN_SIZE) ? 1 : resolveThreads(num_threads);
+    parallelRanges(a.size(), num_threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) a[i] *= n_inv;
+    });
+}
+
+std::vector<Fr> multiply(const std::vector<Fr>& a, const std::vector<Fr>& b, size_t num_threads) {
+    if (a.empty() || b.empty()) return std::vector<Fr>();
+    const size_t result_size = a.size() + b.size() - 1;
+    size_t n = 1;
+    while (n < result_size) n <<= 1;
+    if (n > (size_t(1) << MAX_LOG_SIZE)) {
+        throw std::invalid_argument("FrNtt::multiply: product too large for Fr NTT");
+    }
+
+    std::vector<Fr> fa(n, Fr(0)), fb(n, Fr(0));
+    std::copy(a.begin(), a.end(), fa.begin());
+    std::copy(b.begin(), b.end(), fb.begin());
+    forward(fa, num_threads);
+    forward(fb, num_threads);
+    FrSimd::mulVec(fa.data(), fa.data(), fb.data(), n);
+    inverse(fa, num_threads);
+    fa.resize(result_size);
+    return fa;
+}
+
+} // namespace FrNtt
+} // namespace expressive_accumulator
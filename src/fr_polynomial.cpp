@@ -0,0 +1,568 @@
+/**
+ * @file fr_polynomial.cpp
+ * @brief mcl::Fr 上系数形式多项式运算的实现。
+ */
+#include "fr_polynomial.h"
+#include "fr_ntt.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace expressive_accumulator {
+namespace FrPolynomial {
+
+void trim(Poly& p) {
+    while (!p.empty() && p.back().isZero()) {
+        p.pop_back();
+    }
+}
+
+bool isOne(const Poly& p) {
+    return p.size() == 1 && p[0].isOne();
+}
+
+Poly fromRoots(const std::set<int>& roots) {
+    std::vector<Fr> fr_roots(roots.begin(), roots.end());
+    return fromRoots(fr_roots);
+}
+
+Fr evaluate(const Poly& p, const Fr& x) {
+    Fr res;
+    res.clear();
+    for (size_t i = p.size(); i-- > 0;) {
+        res *= x;
+        res += p[i];
+    }
+    return res;
+}
+
+void mulLinear(Poly& p, const Fr& x) {
+    if (p.empty()) return;
+    // (c_0 + c_1 z + ...)(z - x)：新系数 c'_i = c_{i-1} - x * c_i
+    p.push_back(p.back());
+    for (size_t i = p.size() - 2; i > 0; --i) {
+        p[i] = p[i - 1] - x * p[i];
+    }
+    p[0] = -(x * p[0]);
+}
+
+Fr divLinear(Poly& p, const Fr& x) {
+    Fr rem;
+    rem.clear();
+    if (p.empty()) return rem;
+    // 综合除法：从最高次开始 b_{i-1} = c_i + x * b_i
+    Fr carry = p.back();
+    for (size_t i = p.size() - 1; i > 0; --i) {
+        Fr next = p[i - 1] + x * carry;
+        p[i - 1] = carry;
+        carry = next;
+    }
+    p.pop_back();
+    return carry;
+}
+
+Poly add(const Poly& a, const Poly& b) {
+    Poly r(std::max(a.size(), b.size()));
+    for (size_t i = 0; i < r.size(); ++i) {
+        if (i < a.size() && i < b.size()) r[i] = a[i] + b[i];
+        else r[i] = (i < a.size()) ? a[i] : b[i];
+    }
+    trim(r);
+    return r;
+}
+
+Poly sub(const Poly& a, const Poly& b) {
+    Poly r(std::max(a.size(), b.size()));
+    for (size_t i = 0; i < r.size(); ++i) {
+        if (i < a.size() && i < b.size()) r[i] = a[i] - b[i];
+        else r[i] = (i < a.size()) ? a[i] : -b[i];
+    }
+    trim(r);
+    return r;
+}
+
+Poly scale(const Poly& a, const Fr& c) {
+    if (c.isZero()) return Poly();
+    Poly r(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        r[i] = a[i] * c;
+    }
+    return r;
+}
+
+namespace {
+
+// 低于该长度时 Karatsuba 递归退化为教科书乘法
+const size_t KARATSUBA_THRESHOLD = 32;
+// 两个因子都不短于该长度时使用 NTT 乘法
+const size_t NTT_THRESHOLD = 64;
+// 除数与商都不短于该长度时使用牛顿迭代求商
+const size_t NEWTON_DIVISION_THRESHOLD = 64;
+// 次数低于该值时 half-GCD 退化为逐步欧几里得
+const size_t HALF_GCD_THRESHOLD = 512;
+
+// out[0, na + nb - 1) += a * b
+void mulAccumulate(const Fr* a, size_t na, const Fr* b, size_t nb, Fr* out) {
+    if (na == 0 || nb == 0) return;
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+        for (size_t i = 0; i < na; ++i) {
+            for (size_t j = 0; j < nb; ++j) {
+                out[i + j] += a[i] * b[j];
+            }
+        }
+        return;
+    }
+
+    const size_t h = (na + 1) / 2;
+    if (nb <= h) {
+        // b 不足一半长度：按 a 的高低两半分别相乘
+        mulAccumulate(a, h, b, nb, out);
+        mulAccumulate(a + h, na - h, b, nb, out + h);
+        return;
+    }
+
+    // a = a0 + z^h a1, b = b0 + z^h b1
+    const size_t na1 = na - h, nb1 = nb - h;
+    std::vector<Fr> z0(2 * h - 1, Fr(0)), z1(2 * h - 1, Fr(0)), z2(na1 + nb1 - 1, Fr(0));
+    std::vector<Fr> sa(a, a + h), sb(b, b + h);
+    for (size_t i = 0; i < na1; ++i) sa[i] += a[h + i];
+    for (size_t i = 0; i < nb1; ++i) sb[i] += b[h + i];
+
+    mulAccumulate(a, h, b, h, z0.data());
+    mulAccumulate(a + h, na1, b + h, nb1, z2.data());
+    mulAccumulate(sa.data(), h, sb.data(), h, z1.data());
+
+    // z1 = (a0 + a1)(b0 + b1) - a0 b0 - a1 b1
+    for (size_t i = 0; i < z0.size(); ++i) z1[i] -= z0[i];
+    for (size_t i = 0; i < z2.size(); ++i) z1[i] -= z2[i];
+
+    for (size_t i = 0; i < z0.size(); ++i) out[i] += z0[i];
+    for (size_t i = 0; i < z1.size(); ++i) out[h + i] += z1[i];
+    for (size_t i = 0; i < z2.size(); ++i) out[2 * h + i] += z2[i];
+}
+
+// 截断到前 n 项
+Poly truncate(const Poly& p, size_t n) {
+    Poly r(p.begin(), p.begin() + std::min(n, p.size()));
+    trim(r);
+    return r;
+}
+
+// 形式幂级数求逆：f·g ≡ 1 (mod z^n)，要求 f[0] ≠ 0
+Poly invSeries(const Poly& f, size_t n) {
+    Poly g(1);
+    Fr::inv(g[0], f[0]);
+    for (size_t k = 1; k < n;) {
+        // 牛顿迭代 g <- g·(2 - f·g) mod z^{2k}
+        const size_t k2 = std::min(2 * k, n);
+        Poly t = truncate(mul(truncate(f, k2), g), k2);
+        t = sub(Poly(1, Fr(2)), t);
+        g = truncate(mul(g, t), k2);
+        k = k2;
+    }
+    return g;
+}
+
+} // namespace
+
+Poly mul(const Poly& a, const Poly& b, size_t num_threads) {
+    if (a.empty() || b.empty()) return Poly();
+    Poly r;
+    if (std::min(a.size(), b.size()) >= NTT_THRESHOLD) {
+        r = FrNtt::multiply(a, b, num_threads);
+    } else {
+        // mulAccumulate 在 r 上累加，而 Fr 默认构造不清零，必须先填零
+        r.assign(a.size() + b.size() - 1, Fr(0));
+        mulAccumulate(a.data(), a.size(), b.data(), b.size(), r.data());
+    }
+    trim(r);
+    return r;
+}
+
+void divRem(Poly& q, Poly& r, const Poly& a, const Poly& b) {
+    if (b.empty()) {
+        throw std::invalid_argument("FrPolynomial::divRem: division by zero polynomial");
+    }
+    r = a;
+    trim(r);
+    q.clear();
+    if (r.size() < b.size()) return;
+
+    const size_t db = b.size() - 1;
+    const size_t q_len = r.size() - db;
+    if (db >= NEWTON_DIVISION_THRESHOLD && q_len >= NEWTON_DIVISION_THRESHOLD) {
+        // 反转系数后 rev(q) = rev(a) / rev(b) mod z^{q_len}，商的计算化为乘法
+        Poly rev_a(r.rbegin(), r.rbegin() + q_len);
+        Poly rev_b(b.rbegin(), b.rend());
+        Poly rev_q = truncate(mul(rev_a, invSeries(truncate(rev_b, q_len), q_len)), q_len);
+        rev_q.resize(q_len, Fr(0));
+        q.assign(rev_q.rbegin(), rev_q.rend());
+        trim(q);
+        r = sub(r, mul(q, b));
+        return;
+    }
+
+    Fr lead_inv;
+    Fr::inv(lead_inv, b.back());
+    q.assign(q_len, Fr(0));
+    for (size_t i = r.size(); i-- > db;) {
+        Fr c = r[i] * lead_inv;
+        q[i - db] = c;
+        if (c.isZero()) continue;
+        for (size_t j = 0; j <= db; ++j) {
+            r[i - db + j] -= c * b[j];
+        }
+    }
+    r.resize(db);
+    trim(r);
+    trim(q);
+}
+
+namespace {
+
+// 逐步欧几里得算法，返回未归一化的 g 及对应系数
+void xgcdClassical(Poly& g, Poly& u, Poly& v, const Poly& a, const Poly& b) {
+    Poly r0 = a, r1 = b;
+    trim(r0);
+    trim(r1);
+    Poly s0(1, Fr(1)), s1;
+    Poly t0, t1(1, Fr(1));
+
+    while (!r1.empty()) {
+        Poly q, r;
+        divRem(q, r, r0, r1);
+        Poly s2 = sub(s0, mul(q, s1));
+        Poly t2 = sub(t0, mul(q, t1));
+        r0.swap(r1);
+        r1.swap(r);
+        s0.swap(s1);
+        s1.swap(s2);
+        t0.swap(t1);
+        t1.swap(t2);
+    }
+    g.swap(r0);
+    u.swap(s0);
+    v.swap(t0);
+}
+
+/**
+ * @brief 2×2 多项式矩阵 [[a, b], [c, d]]，作用于 (A, B) 得到 (a·A + b·B, c·A + d·B)。
+ */
+struct Matrix {
+    Poly a, b, c, d;
+
+    static Matrix identity() {
+        Matrix m;
+        m.a.assign(1, Fr(1));
+        m.d.assign(1, Fr(1));
+        return m;
+    }
+};
+
+// 右乘： x * y
+Matrix multiply(const Matrix& x, const Matrix& y) {
+    Matrix r;
+    r.a = add(mul(x.a, y.a), mul(x.b, y.c));
+    r.b = add(mul(x.a, y.b), mul(x.b, y.d));
+    r.c = add(mul(x.c, y.a), mul(x.d, y.c));
+    r.d = add(mul(x.c, y.b), mul(x.d, y.d));
+    return r;
+}
+
+void apply(const Matrix& m, Poly& A, Poly& B) {
+    Poly na = add(mul(m.a, A), mul(m.b, B));
+    Poly nb = add(mul(m.c, A), mul(m.d, B));
+    A.swap(na);
+    B.swap(nb);
+}
+
+// 一步欧几里得：(A, B) <- (B, A mod B)，m <- [[0, 1], [1, -q]] · m
+void euclidStep(Matrix& m, Poly& A, Poly& B) {
+    Poly q, r;
+    divRem(q, r, A, B);
+    A.swap(B);
+    B.swap(r);
+    Poly c = sub(m.a, mul(q, m.c));
+    Poly d = sub(m.b, mul(q, m.d));
+    m.a.swap(m.c);
+    m.b.swap(m.d);
+    m.c.swap(c);
+    m.d.swap(d);
+}
+
+// 去掉低 k 个系数，即 p div z^k
+Poly shiftDown(const Poly& p, size_t k) {
+    if (p.size() <= k) return Poly();
+    return Poly(p.begin() + k, p.end());
+}
+
+/**
+ * @brief half-GCD：deg A > deg B 时，返回欧几里得余式序列的变换矩阵 M，
+ *        使 (A', B') = M·(A, B) 满足 deg A' ≥ m > deg B'，m = ⌈deg A / 2⌉。
+ * @details 余式序列的前半段只依赖 A、B 的高次系数：先对 A div z^m、B div z^m
+ *          递归得到前四分之一的商，执行一步普通除法后，再对截断后的余式递归一次。
+ */
+Matrix halfGcd(const Poly& A, const Poly& B) {
+    const size_t n = A.size() - 1;
+    const size_t m = (n + 1) / 2;
+    if (B.size() <= m) return Matrix::identity();
+
+    if (n < HALF_GCD_THRESHOLD) {
+        Matrix M = Matrix::identity();
+        Poly x = A, y = B;
+        while (y.size() > m) euclidStep(M, x, y);
+        return M;
+    }
+
+    Matrix R = halfGcd(shiftDown(A, m), shiftDown(B, m));
+    Poly x = A, y = B;
+    apply(R, x, y);
+    if (y.size() <= m) return R;
+
+    euclidStep(R, x, y);
+    if (y.size() <= m) return R;
+
+    const size_t k = 2 * m - (x.size() - 1);
+    Matrix S = halfGcd(shiftDown(x, k), shiftDown(y, k));
+    return multiply(S, R);
+}
+
+} // namespace
+
+void xgcd(Poly& g, Poly& u, Poly& v, const Poly& a, const Poly& b) {
+    Poly A = a, B = b;
+    trim(A);
+    trim(B);
+
+    if (std::max(A.size(), B.size()) <= HALF_GCD_THRESHOLD || A.empty() || B.empty()) {
+        xgcdClassical(g, u, v, A, B);
+    } else {
+        // 先做一步除法保证 deg A > deg B，之后交替执行 half-GCD 与一步除法
+        const bool swapped = A.size() < B.size();
+        if (swapped) A.swap(B);
+        Matrix M = Matrix::identity();
+        euclidStep(M, A, B);
+        while (!B.empty()) {
+            Matrix H = halfGcd(A, B);
+            apply(H, A, B);
+            M = multiply(H, M);
+            if (B.empty()) break;
+            euclidStep(M, A, B);
+        }
+        g.swap(A);
+        u = swapped ? M.b : M.a;
+        v = swapped ? M.a : M.b;
+    }
+
+    if (g.empty()) {
+        u.clear();
+        v.clear();
+        return;
+    }
+    // 归一化为首一的最大公因式
+    Fr lead_inv;
+    Fr::inv(lead_inv, g.back());
+    g = scale(g, lead_inv);
+    u = scale(u, lead_inv);
+    v = scale(v, lead_inv);
+}
+
+namespace {
+
+// 乘积树叶子包含的点数，叶子处直接 Horner 求值
+const size_t PRODUCT_TREE_LEAF = 16;
+
+// 以 num_threads 个线程对 [0, count) 分块执行 fn(i)
+template <typename Fn>
+void parallelFor(size_t count, size_t num_threads, const Fn& fn) {
+    num_threads = std::min(num_threads, count);
+    if (num_threads <= 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    std::vector<std::thread> threads;
+    size_t chunk = (count + num_threads - 1) / num_threads;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        size_t end = std::min(begin + chunk, count);
+        threads.emplace_back([&fn, begin, end]() {
+            for (size_t i = begin; i < end; ++i) fn(i);
+        });
+    }
+    for (auto& t : threads) t.join();
+}
+
+size_t resolveThreads(size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return num_threads;
+}
+
+/**
+ * @brief 自底向上构建乘积树，levels[0] 为叶子，levels.back()[0] 为全部点的乘积。
+ * @details 每个叶子是至多 PRODUCT_TREE_LEAF 个 (z - x_i) 的乘积，
+ *          上层节点是相邻两个子节点之积，落单的节点直接上移。
+ */
+std::vector<std::vector<Poly>> buildProductTree(const std::vector<Fr>& points, size_t num_threads) {
+    std::vector<std::vector<Poly>> levels(1);
+    const size_t num_leaves = (points.size() + PRODUCT_TREE_LEAF - 1) / PRODUCT_TREE_LEAF;
+    levels[0].resize(num_leaves);
+    parallelFor(num_leaves, num_threads, [&](size_t i) {
+        Poly leaf(1, Fr(1));
+        size_t end = std::min(points.size(), (i + 1) * PRODUCT_TREE_LEAF);
+        for (size_t k = i * PRODUCT_TREE_LEAF; k < end; ++k) mulLinear(leaf, points[k]);
+        levels[0][i].swap(leaf);
+    });
+
+    while (levels.back().size() > 1) {
+        const std::vector<Poly>& below = levels.back();
+        std::vector<Poly> above((below.size() + 1) / 2);
+        // 顶层节点数少于线程数时，把剩余线程交给单次 NTT 乘法
+        const size_t inner_threads = std::max<size_t>(1, num_threads / above.size());
+        parallelFor(above.size(), num_threads, [&](size_t i) {
+            if (2 * i + 1 < below.size()) above[i] = mul(below[2 * i], below[2 * i + 1], inner_threads);
+            else above[i] = below[2 * i];
+        });
+        levels.push_back(std::move(above));
+    }
+    return levels;
+}
+
+} // namespace
+
+Poly fromRoots(const std::vector<Fr>& roots, size_t num_threads) {
+    if (roots.empty()) return Poly(1, Fr(1));
+    return buildProductTree(roots, resolveThreads(num_threads)).back()[0];
+}
+
+std::vector<Fr> multiEvaluate(const Poly& p, const std::vector<Fr>& points, size_t num_threads) {
+    std::vector<Fr> values(points.size());
+    if (points.empty()) return values;
+    num_threads = resolveThreads(num_threads);
+
+    std::vector<std::vector<Poly>> tree = buildProductTree(points, num_threads);
+
+    // 余数树：自顶向下，每个节点保存 p mod 该节点的乘积多项式
+    std::vector<Poly> rems(1);
+    Poly q;
+    divRem(q, rems[0], p, tree.back()[0]);
+    for (size_t level = tree.size() - 1; level-- > 0;) {
+        const std::vector<Poly>& nodes = tree[level];
+        std::vector<Poly> below(nodes.size());
+        parallelFor(nodes.size(), num_threads, [&](size_t i) {
+            Poly quot;
+            divRem(quot, below[i], rems[i / 2], nodes[i]);
+        });
+        rems.swap(below);
+    }
+
+    parallelFor(rems.size(), num_threads, [&](size_t i) {
+        size_t end = std::min(points.size(), (i + 1) * PRODUCT_TREE_LEAF);
+        for (size_t k = i * PRODUCT_TREE_LEAF; k < end; ++k) {
+            values[k] = evaluate(rems[i], points[k]);
+        }
+    });
+    return values;
+}
+
+Poly gcd(const Poly& a, const Poly& b) {
+    Poly r0 = a, r1 = b;
+    trim(r0);
+    trim(r1);
+    while (!r1.empty()) {
+        Poly q, r;
+        divRem(q, r, r0, r1);
+        r0.swap(r1);
+        r1.swap(r);
+    }
+    if (r0.empty()) return r0;
+    Fr lead_inv;
+    Fr::inv(lead_inv, r0.back());
+    return scale(r0, lead_inv);
+}
+
+Poly mulMod(const Poly& a, const Poly& b, const Poly& m) {
+    Poly q, r;
+    divRem(q, r, mul(a, b), m);
+    return r;
+}
+
+Poly powMod(const Poly& base, const Fr& e, const Poly& m) {
+    Poly q, b;
+    divRem(q, b, base, m);
+    Poly result(1, Fr(1));
+    divRem(q, result, result, m);
+
+    // 从最高位开始的平方-乘算法
+    const std::string bits = e.getStr(2);
+    for (char bit : bits) {
+        result = mulMod(result, result, m);
+        if (bit == '1') {
+            result = mulMod(result, b, m);
+        }
+    }
+    return result;
+}
+
+namespace {
+
+// (p - 1) / 2
+Fr halfOrder() {
+    Fr minus_one = -Fr(1);
+    Fr half = Fr(2);
+    Fr::inv(half, half);
+    // (p - 1) / 2 作为整数小于 p，可由 -1 · 2^{-1} = (p - 1)/2 直接得到
+    return minus_one * half;
+}
+
+void splitRoots(std::vector<Fr>& roots, const Poly& f, const Fr& half) {
+    if (f.size() <= 1) return;
+    if (f.size() == 2) {
+        roots.push_back(-f[0] / f[1]);
+        return;
+    }
+    while (true) {
+        Fr delta;
+        delta.setByCSPRNG();
+        Poly shifted = {delta, Fr(1)};
+        Poly h = sub(powMod(shifted, half, f), Poly(1, Fr(1)));
+        Poly g = gcd(f, h);
+        if (g.size() > 1 && g.size() < f.size()) {
+            Poly q, r;
+            divRem(q, r, f, g);
+            splitRoots(roots, g, half);
+            splitRoots(roots, q, half);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+bool findRoots(std::vector<Fr>& roots, const Poly& f) {
+    roots.clear();
+    Poly monic = f;
+    trim(monic);
+    if (monic.empty()) return false;
+    if (monic.size() == 1) return true;
+
+    // f | z^p - z 当且仅当 f 无重根且完全分裂；z^p = (z^{(p-1)/2})^2 · z
+    const Fr half = halfOrder();
+    Poly z = {Fr(0), Fr(1)};
+    Poly z_half = powMod(z, half, monic);
+    Poly z_p = mulMod(mulMod(z_half, z_half, monic), z, monic);
+    Poly z_mod;
+    Poly q;
+    divRem(q, z_mod, z, monic);
+    if (z_p != z_mod) return false;
+
+    splitRoots(roots, monic, half);
+    return roots.size() + 1 == monic.size();
+}
+
+} // namespace FrPolynomial
+} // namespace expressive_accumulator
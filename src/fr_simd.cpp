@@ -0,0 +1,819 @@
+/**
+ * @file fr_simd.cpp
+ * @brief Fr 多通道向量运算内核及运行时分派。
+ * @details 内核操作“打包”的 4×64 位字数组（每个元素连续 4 个字，即 mcl 的
+ *          Montgomery 表示）。外层接口按块把 Fr 打包后调用内核，再写回。
+ *          各 SIMD 内核只处理通道数整倍的部分，剩余元素由标量 CIOS 处理。
+ */
+#include "fr_simd.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define FR_SIMD_X86 1
+#endif
+
+namespace expressive_accumulator {
+namespace FrSimd {
+
+namespace {
+
+typedef uint64_t Limb;
+typedef unsigned __int128 Wide;
+
+const size_t LIMBS = 4;
+// 打包缓冲区的元素数
+const size_t BLOCK = 256;
+const size_t MAX_LANES = 8;
+
+struct Params {
+    Limb p[LIMBS];
+    uint32_t p32[8];      // p 的 32 位数字
+    uint64_t p52[5];      // p 的 52 位数字
+    Limb n0;              // -p^{-1} mod 2^64
+    Limb one[LIMBS];      // Montgomery 形式的 1，即 R mod p
+    Fr r;                 // 值为 R 的域元素
+    Fr r_inv;             // 值为 R^{-1} 的域元素，其 Montgomery 表示即普通表示
+};
+
+Params makeParams() {
+    Params P;
+    const auto* p = Fr::getOp().p;
+    for (size_t i = 0; i < LIMBS; ++i) P.p[i] = p[i];
+    for (size_t i = 0; i < 8; ++i) {
+        P.p32[i] = static_cast<uint32_t>(P.p[i / 2] >> (32 * (i % 2)));
+    }
+    const Limb M52 = (Limb(1) << 52) - 1;
+    P.p52[0] = P.p[0] & M52;
+    P.p52[1] = ((P.p[0] >> 52) | (P.p[1] << 12)) & M52;
+    P.p52[2] = ((P.p[1] >> 40) | (P.p[2] << 24)) & M52;
+    P.p52[3] = ((P.p[2] >> 28) | (P.p[3] << 36)) & M52;
+    P.p52[4] = P.p[3] >> 16;
+
+    // 牛顿迭代求 p^{-1} mod 2^64，每次迭代有效位数翻倍
+    Limb inv = P.p[0];
+    for (int i = 0; i < 6; ++i) inv *= 2 - P.p[0] * inv;
+    P.n0 = ~inv + 1;
+
+    Fr one = 1;
+    std::memcpy(P.one, one.getUnit(), sizeof(P.one));
+
+    Fr::pow(P.r, Fr(2), static_cast<int64_t>(64 * LIMBS));
+    Fr::inv(P.r_inv, P.r);
+    return P;
+}
+
+const Params& params() {
+    static const Params P = makeParams();
+    return P;
+}
+
+// ------------------------------------------------------------------
+// 标量辅助：4 字整数运算与 64 位 CIOS Montgomery 乘法
+// ------------------------------------------------------------------
+
+bool geq(const Limb* a, const Limb* b) {
+    for (size_t i = LIMBS; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] > b[i];
+    }
+    return true;
+}
+
+// z = a - b，返回借位
+Limb subLimbs(Limb* z, const Limb* a, const Limb* b) {
+    Limb borrow = 0;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        Wide d = (Wide)a[i] - b[i] - borrow;
+        z[i] = (Limb)d;
+        borrow = (Limb)(d >> 64) & 1;
+    }
+    return borrow;
+}
+
+// z = a + b，返回进位
+Limb addLimbs(Limb* z, const Limb* a, const Limb* b) {
+    Limb carry = 0;
+    for (size_t i = 0; i < LIMBS; ++i) {
+        Wide s = (Wide)a[i] + b[i] + carry;
+        z[i] = (Limb)s;
+        carry = (Limb)(s >> 64);
+    }
+    return carry;
+}
+
+void montMulScalar(Limb* z, const Limb* x, const Limb* y) {
+    const Params& P = params();
+    Limb t[LIMBS + 2] = {0};
+    for (size_t i = 0; i < LIMBS; ++i) {
+        Limb carry = 0;
+        for (size_t j = 0; j < LIMBS; ++j) {
+            Wide s = (Wide)x[j] * y[i] + t[j] + carry;
+            t[j] = (Limb)s;
+            carry = (Limb)(s >> 64);
+        }
+        Wide s = (Wide)t[LIMBS] + carry;
+        t[LIMBS] = (Limb)s;
+        t[LIMBS + 1] = (Limb)(s >> 64);
+
+        Limb m = t[0] * P.n0;
+        s = (Wide)m * P.p[0] + t[0];
+        carry = (Limb)(s >> 64);
+        for (size_t j = 1; j < LIMBS; ++j) {
+            s = (Wide)m * P.p[j] + t[j] + carry;
+            t[j - 1] = (Limb)s;
+            carry = (Limb)(s >> 64);
+        }
+        s = (Wide)t[LIMBS] + carry;
+        t[LIMBS - 1] = (Limb)s;
+        t[LIMBS] = t[LIMBS + 1] + (Limb)(s >> 64);
+    }
+    if (t[LIMBS] != 0 || geq(t, P.p)) subLimbs(t, t, P.p);
+    std::memcpy(z, t, sizeof(Limb) * LIMBS);
+}
+
+void mulScalarKernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        montMulScalar(z + i * LIMBS, x + i * LIMBS, y + i * LIMBS);
+    }
+}
+
+void addScalarKernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    const Params& P = params();
+    for (size_t i = 0; i < n; ++i) {
+        Limb* zi = z + i * LIMBS;
+        addLimbs(zi, x + i * LIMBS, y + i * LIMBS);
+        if (geq(zi, P.p)) subLimbs(zi, zi, P.p);
+    }
+}
+
+void subScalarKernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    const Params& P = params();
+    for (size_t i = 0; i < n; ++i) {
+        Limb* zi = z + i * LIMBS;
+        if (subLimbs(zi, x + i * LIMBS, y + i * LIMBS)) addLimbs(zi, zi, P.p);
+    }
+}
+
+#ifdef FR_SIMD_X86
+
+// ------------------------------------------------------------------
+// AVX2：4 通道，每个 64 位通道保存一个 32 位数字
+// ------------------------------------------------------------------
+
+#define FR_TARGET_AVX2 __attribute__((target("avx2")))
+
+FR_TARGET_AVX2 inline void loadDigits4(__m256i d[8], const Limb* x) {
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    for (size_t l = 0; l < LIMBS; ++l) {
+        __m256i v = _mm256_set_epi64x(x[12 + l], x[8 + l], x[4 + l], x[l]);
+        d[2 * l] = _mm256_and_si256(v, mask);
+        d[2 * l + 1] = _mm256_srli_epi64(v, 32);
+    }
+}
+
+FR_TARGET_AVX2 inline void storeDigits4(Limb* z, const __m256i d[8]) {
+    alignas(32) Limb tmp[4];
+    for (size_t l = 0; l < LIMBS; ++l) {
+        __m256i v = _mm256_or_si256(d[2 * l], _mm256_slli_epi64(d[2 * l + 1], 32));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(tmp), v);
+        for (size_t k = 0; k < 4; ++k) z[4 * k + l] = tmp[k];
+    }
+}
+
+// r = t - p（若 t ≥ p），否则 r = t；t 为 9 个数字
+FR_TARGET_AVX2 inline void reduceOnce4(__m256i r[8], const __m256i t[9], const __m256i p[8]) {
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i d[8];
+    __m256i borrow = zero;
+    for (size_t j = 0; j < 8; ++j) {
+        __m256i s = _mm256_sub_epi64(_mm256_sub_epi64(t[j], p[j]), borrow);
+        d[j] = _mm256_and_si256(s, mask);
+        borrow = _mm256_srli_epi64(s, 63);
+    }
+    __m256i top = _mm256_sub_epi64(t[8], borrow);
+    __m256i keep = _mm256_cmpgt_epi64(zero, top); // 借位说明 t < p
+    for (size_t j = 0; j < 8; ++j) {
+        r[j] = _mm256_blendv_epi8(d[j], t[j], keep);
+    }
+}
+
+FR_TARGET_AVX2 inline void montMul4(__m256i r[8], const __m256i a[8], const __m256i b[8],
+                                    const __m256i p[8], __m256i n0) {
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    __m256i t[10];
+    for (size_t j = 0; j < 10; ++j) t[j] = _mm256_setzero_si256();
+
+    for (size_t i = 0; i < 8; ++i) {
+        __m256i carry = _mm256_setzero_si256();
+        for (size_t j = 0; j < 8; ++j) {
+            __m256i s = _mm256_add_epi64(_mm256_add_epi64(t[j], _mm256_mul_epu32(a[j], b[i])), carry);
+            t[j] = _mm256_and_si256(s, mask);
+            carry = _mm256_srli_epi64(s, 32);
+        }
+        __m256i s = _mm256_add_epi64(t[8], carry);
+        t[8] = _mm256_and_si256(s, mask);
+        t[9] = _mm256_srli_epi64(s, 32);
+
+        __m256i m = _mm256_and_si256(_mm256_mul_epu32(t[0], n0), mask);
+        s = _mm256_add_epi64(t[0], _mm256_mul_epu32(m, p[0]));
+        carry = _mm256_srli_epi64(s, 32);
+        for (size_t j = 1; j < 8; ++j) {
+            s = _mm256_add_epi64(_mm256_add_epi64(t[j], _mm256_mul_epu32(m, p[j])), carry);
+            t[j - 1] = _mm256_and_si256(s, mask);
+            carry = _mm256_srli_epi64(s, 32);
+        }
+        s = _mm256_add_epi64(t[8], carry);
+        t[7] = _mm256_and_si256(s, mask);
+        t[8] = _mm256_add_epi64(t[9], _mm256_srli_epi64(s, 32));
+    }
+    reduceOnce4(r, t, p);
+}
+
+FR_TARGET_AVX2 void loadModulus4(__m256i p[8], __m256i& n0) {
+    const Params& P = params();
+    for (size_t j = 0; j < 8; ++j) p[j] = _mm256_set1_epi64x(P.p32[j]);
+    n0 = _mm256_set1_epi64x(static_cast<uint32_t>(P.n0));
+}
+
+FR_TARGET_AVX2 void mulAvx2Kernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    __m256i p[8], n0;
+    loadModulus4(p, n0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i a[8], b[8], r[8];
+        loadDigits4(a, x + i * LIMBS);
+        loadDigits4(b, y + i * LIMBS);
+        montMul4(r, a, b, p, n0);
+        storeDigits4(z + i * LIMBS, r);
+    }
+    mulScalarKernel(z + i * LIMBS, x + i * LIMBS, y + i * LIMBS, n - i);
+}
+
+FR_TARGET_AVX2 void addAvx2Kernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    __m256i p[8], n0;
+    loadModulus4(p, n0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i a[8], b[8], t[9], r[8];
+        loadDigits4(a, x + i * LIMBS);
+        loadDigits4(b, y + i * LIMBS);
+        __m256i carry = _mm256_setzero_si256();
+        for (size_t j = 0; j < 8; ++j) {
+            __m256i s = _mm256_add_epi64(_mm256_add_epi64(a[j], b[j]), carry);
+            t[j] = _mm256_and_si256(s, mask);
+            carry = _mm256_srli_epi64(s, 32);
+        }
+        t[8] = carry;
+        reduceOnce4(r, t, p);
+        storeDigits4(z + i * LIMBS, r);
+    }
+    addScalarKernel(z + i * LIMBS, x + i * LIMBS, y + i * LIMBS, n - i);
+}
+
+FR_TARGET_AVX2 void subAvx2Kernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    const __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i p[8], n0;
+    loadModulus4(p, n0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i a[8], b[8], d[8], e[8], r[8];
+        loadDigits4(a, x + i * LIMBS);
+        loadDigits4(b, y + i * LIMBS);
+        __m256i borrow = zero;
+        for (size_t j = 0; j < 8; ++j) {
+            __m256i s = _mm256_sub_epi64(_mm256_sub_epi64(a[j], b[j]), borrow);
+            d[j] = _mm256_and_si256(s, mask);
+            borrow = _mm256_srli_epi64(s, 63);
+        }
+        // 有借位时结果加上 p
+        __m256i carry = zero;
+        for (size_t j = 0; j < 8; ++j) {
+            __m256i s = _mm256_add_epi64(_mm256_add_epi64(d[j], p[j]), carry);
+            e[j] = _mm256_and_si256(s, mask);
+            carry = _mm256_srli_epi64(s, 32);
+        }
+        __m256i use_e = _mm256_cmpeq_epi64(borrow, _mm256_set1_epi64x(1));
+        for (size_t j = 0; j < 8; ++j) r[j] = _mm256_blendv_epi8(d[j], e[j], use_e);
+        storeDigits4(z + i * LIMBS, r);
+    }
+    subScalarKernel(z + i * LIMBS, x + i * LIMBS, y + i * LIMBS, n - i);
+}
+
+// ------------------------------------------------------------------
+// AVX-512F：8 通道，32 位数字
+// ------------------------------------------------------------------
+
+#define FR_TARGET_AVX512 __attribute__((target("avx512f")))
+
+FR_TARGET_AVX512 inline __m512i gatherLimb8(const Limb* x, size_t l) {
+    const __m512i idx = _mm512_set_epi64(28, 24, 20, 16, 12, 8, 4, 0);
+    // 带掩码的形式给出已清零的源寄存器，避免 GCC 对未初始化源操作数的 -Wmaybe-uninitialized 告警
+    return _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, idx, reinterpret_cast<const long long*>(x + l), 8);
+}
+
+FR_TARGET_AVX512 inline void scatterLimb8(Limb* z, size_t l, __m512i v) {
+    const __m512i idx = _mm512_set_epi64(28, 24, 20, 16, 12, 8, 4, 0);
+    _mm512_i64scatter_epi64(reinterpret_cast<long long*>(z + l), idx, v, 8);
+}
+
+// GCC 12 的 _mm512_srli/slli_epi64 与 _mm512_mul_epu32 以 _mm512_undefined_epi32() 作透传源，
+// 在 -Wall 下触发 -Wmaybe-uninitialized；全掩码的 maskz 形式是同一条指令，结果相同
+template <unsigned int N>
+FR_TARGET_AVX512 inline __m512i srli64(__m512i v) {
+    return _mm512_maskz_srli_epi64(0xFF, v, N);
+}
+
+template <unsigned int N>
+FR_TARGET_AVX512 inline __m512i slli64(__m512i v) {
+    return _mm512_maskz_slli_epi64(0xFF, v, N);
+}
+
+FR_TARGET_AVX512 inline __m512i mulEpu32(__m512i a, __m512i b) {
+    return _mm512_maskz_mul_epu32(0xFF, a, b);
+}
+
+FR_TARGET_AVX512 void mulAvx512Kernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    const Params& P = params();
+    const __m512i mask = _mm512_set1_epi64(0xffffffff);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i n0 = _mm512_set1_epi64(static_cast<uint32_t>(P.n0));
+    __m512i p[8];
+    for (size_t j = 0; j < 8; ++j) p[j] = _mm512_set1_epi64(P.p32[j]);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i a[8], b[8], t[10];
+        for (size_t l = 0; l < LIMBS; ++l) {
+            __m512i va = gatherLimb8(x + i * LIMBS, l);
+            __m512i vb = gatherLimb8(y + i * LIMBS, l);
+            a[2 * l] = _mm512_and_si512(va, mask);
+            a[2 * l + 1] = srli64<32>(va);
+            b[2 * l] = _mm512_and_si512(vb, mask);
+            b[2 * l + 1] = srli64<32>(vb);
+        }
+        for (size_t j = 0; j < 10; ++j) t[j] = zero;
+
+        for (size_t k = 0; k < 8; ++k) {
+            __m512i carry = zero;
+            for (size_t j = 0; j < 8; ++j) {
+                __m512i s = _mm512_add_epi64(_mm512_add_epi64(t[j], mulEpu32(a[j], b[k])), carry);
+                t[j] = _mm512_and_si512(s, mask);
+                carry = srli64<32>(s);
+            }
+            __m512i s = _mm512_add_epi64(t[8], carry);
+            t[8] = _mm512_and_si512(s, mask);
+            t[9] = srli64<32>(s);
+
+            __m512i m = _mm512_and_si512(mulEpu32(t[0], n0), mask);
+            s = _mm512_add_epi64(t[0], mulEpu32(m, p[0]));
+            carry = srli64<32>(s);
+            for (size_t j = 1; j < 8; ++j) {
+                s = _mm512_add_epi64(_mm512_add_epi64(t[j], mulEpu32(m, p[j])), carry);
+                t[j - 1] = _mm512_and_si512(s, mask);
+                carry = srli64<32>(s);
+            }
+            s = _mm512_add_epi64(t[8], carry);
+            t[7] = _mm512_and_si512(s, mask);
+            t[8] = _mm512_add_epi64(t[9], srli64<32>(s));
+        }
+
+        // 条件减 p
+        __m512i d[8];
+        __m512i borrow = zero;
+        for (size_t j = 0; j < 8; ++j) {
+            __m512i s = _mm512_sub_epi64(_mm512_sub_epi64(t[j], p[j]), borrow);
+            d[j] = _mm512_and_si512(s, mask);
+            borrow = srli64<63>(s);
+        }
+        __mmask8 keep = _mm512_cmplt_epi64_mask(_mm512_sub_epi64(t[8], borrow), zero);
+        for (size_t l = 0; l < LIMBS; ++l) {
+            __m512i lo = _mm512_mask_blend_epi64(keep, d[2 * l], t[2 * l]);
+            __m512i hi = _mm512_mask_blend_epi64(keep, d[2 * l + 1], t[2 * l + 1]);
+            scatterLimb8(z + i * LIMBS, l, _mm512_or_si512(lo, slli64<32>(hi)));
+        }
+    }
+    mulScalarKernel(z + i * LIMBS, x + i * LIMBS, y + i * LIMBS, n - i);
+}
+
+// ------------------------------------------------------------------
+// AVX-512 IFMA：8 通道，52 位数字，R' = 2^260
+// ------------------------------------------------------------------
+
+#define FR_TARGET_IFMA __attribute__((target("avx512f,avx512ifma")))
+
+FR_TARGET_IFMA inline void loadDigits52(__m512i d[5], const Limb* x) {
+    const __m512i m52 = _mm512_set1_epi64((1ULL << 52) - 1);
+    __m512i v0 = gatherLimb8(x, 0), v1 = gatherLimb8(x, 1);
+    __m512i v2 = gatherLimb8(x, 2), v3 = gatherLimb8(x, 3);
+    d[0] = _mm512_and_si512(v0, m52);
+    d[1] = _mm512_and_si512(_mm512_or_si512(srli64<52>(v0), slli64<12>(v1)), m52);
+    d[2] = _mm512_and_si512(_mm512_or_si512(srli64<40>(v1), slli64<24>(v2)), m52);
+    d[3] = _mm512_and_si512(_mm512_or_si512(srli64<28>(v2), slli64<36>(v3)), m52);
+    d[4] = srli64<16>(v3);
+}
+
+FR_TARGET_IFMA inline void storeDigits52(Limb* z, const __m512i d[5]) {
+    scatterLimb8(z, 0, _mm512_or_si512(d[0], slli64<52>(d[1])));
+    scatterLimb8(z, 1, _mm512_or_si512(srli64<12>(d[1]), slli64<40>(d[2])));
+    scatterLimb8(z, 2, _mm512_or_si512(srli64<24>(d[2]), slli64<28>(d[3])));
+    scatterLimb8(z, 3, _mm512_or_si512(srli64<36>(d[3]), slli64<16>(d[4])));
+}
+
+// 数字已规范 (< 2^52) 且 t < 2p 时，条件减 p
+FR_TARGET_IFMA inline void reduceOnce52(__m512i t[5], const __m512i p[5]) {
+    const __m512i m52 = _mm512_set1_epi64((1ULL << 52) - 1);
+    const __m512i zero = _mm512_setzero_si512();
+    __m512i d[5];
+    __m512i borrow = zero;
+    for (size_t j = 0; j < 5; ++j) {
+        __m512i s = _mm512_sub_epi64(_mm512_sub_epi64(t[j], p[j]), borrow);
+        d[j] = _mm512_and_si512(s, m52);
+        borrow = srli64<63>(s);
+    }
+    __mmask8 keep = _mm512_cmpneq_epi64_mask(borrow, zero);
+    for (size_t j = 0; j < 5; ++j) t[j] = _mm512_mask_blend_epi64(keep, d[j], t[j]);
+}
+
+FR_TARGET_IFMA void mulIfmaKernel(Limb* z, const Limb* x, const Limb* y, size_t n) {
+    const Params& P = params();
+    const __m512i m52 = _mm512_set1_epi64((1ULL << 52) - 1);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i n0 = _mm512_set1_epi64(P.n0 & ((1ULL << 52) - 1));
+    __m512i p[5];
+    for (size_t j = 0; j < 5; ++j) p[j] = _mm512_set1_epi64(P.p52[j]);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i a[5], b[5], t[6];
+        loadDigits52(a, x + i * LIMBS);
+        loadDigits52(b, y + i * LIMBS);
+        for (size_t j = 0; j < 6; ++j) t[j] = zero;
+
+        // 逐数字累加，t 的各数字允许暂时超过 52 位，在移位时结转
+        for (size_t k = 0; k < 5; ++k) {
+            for (size_t j = 0; j < 5; ++j) {
+                t[j] = _mm512_madd52lo_epu64(t[j], a[j], b[k]);
+                t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], a[j], b[k]);
+            }
+            __m512i m = _mm512_madd52lo_epu64(zero, t[0], n0);
+            for (size_t j = 0; j < 5; ++j) {
+                t[j] = _mm512_madd52lo_epu64(t[j], m, p[j]);
+                t[j + 1] = _mm512_madd52hi_epu64(t[j + 1], m, p[j]);
+            }
+            // t[0] 的低 52 位此时为 0，整体右移一个数字
+            __m512i carry = srli64<52>(t[0]);
+            t[0] = _mm512_add_epi64(t[1], carry);
+            t[1] = t[2];
+            t[2] = t[3];
+            t[3] = t[4];
+            t[4] = t[5];
+            t[5] = zero;
+        }
+        for (size_t j = 0; j < 4; ++j) {
+            t[j + 1] = _mm512_add_epi64(t[j + 1], srli64<52>(t[j]));
+            t[j] = _mm512_and_si512(t[j], m52);
+        }
+        reduceOnce52(t, p);
+
+        // 结果为 a·b·R / 16，连续 4 次模倍乘还原为 a·b·R
+        for (int k = 0; k < 4; ++k) {
+            __m512i carry = zero;
+            for (size_t j = 0; j < 5; ++j) {
+                __m512i s = _mm512_add_epi64(slli64<1>(t[j]), carry);
+                t[j] = _mm512_and_si512(s, m52);
+                carry = srli64<52>(s);
+            }
+            reduceOnce52(t, p);
+        }
+        storeDigits52(z + i * LIMBS, t);
+    }
+    mulScalarKernel(z + i * LIMBS, x + i * LIMBS, y + i * LIMBS, n - i);
+}
+
+#endif // FR_SIMD_X86
+
+// ------------------------------------------------------------------
+// 运行时分派
+// ------------------------------------------------------------------
+
+typedef void (*Kernel)(Limb* z, const Limb* x, const Limb* y, size_t n);
+
+struct Dispatch {
+    Backend backend;
+    size_t lanes;
+    Kernel mul;
+    Kernel add;
+    Kernel sub;
+};
+
+Dispatch makeDispatch(Backend backend) {
+    Dispatch d = {Backend::SCALAR, 1, mulScalarKernel, addScalarKernel, subScalarKernel};
+#ifdef FR_SIMD_X86
+    switch (backend) {
+    case Backend::AVX512_IFMA:
+        d = {backend, 8, mulIfmaKernel, addAvx2Kernel, subAvx2Kernel};
+        break;
+    case Backend::AVX512:
+        d = {backend, 8, mulAvx512Kernel, addAvx2Kernel, subAvx2Kernel};
+        break;
+    case Backend::AVX2:
+        d = {backend, 4, mulAvx2Kernel, addAvx2Kernel, subAvx2Kernel};
+        break;
+    default:
+        break;
+    }
+#else
+    (void)backend;
+#endif
+    return d;
+}
+
+Backend bestBackend() {
+    const Backend order[] = {Backend::AVX512_IFMA, Backend::AVX512, Backend::AVX2};
+    for (Backend b : order) {
+        if (isSupported(b)) return b;
+    }
+    return Backend::SCALAR;
+}
+
+// 各实现的分派表只构造一次且不再修改，切换实现只替换原子指针
+const Dispatch& dispatchFor(Backend backend) {
+    static const Dispatch table[] = {makeDispatch(Backend::SCALAR), makeDispatch(Backend::AVX2),
+                                     makeDispatch(Backend::AVX512), makeDispatch(Backend::AVX512_IFMA)};
+    return table[static_cast<size_t>(backend)];
+}
+
+std::atomic<const Dispatch*>& activeDispatch() {
+    static std::atomic<const Dispatch*> active(&dispatchFor(bestBackend()));
+    return active;
+}
+
+// 每次调用取一次快照，正在执行的调用不受并发 setBackend 影响
+const Dispatch& dispatch() {
+    return *activeDispatch().load(std::memory_order_acquire);
+}
+
+// ------------------------------------------------------------------
+// 打包与写回
+// ------------------------------------------------------------------
+
+inline void pack(Limb* out, const Fr* x, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        std::memcpy(out + i * LIMBS, x[i].getUnit(), sizeof(Limb) * LIMBS);
+    }
+}
+
+inline void unpack(Fr* z, const Limb* in, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        std::memcpy(const_cast<void*>(static_cast<const void*>(z[i].getUnit())), in + i * LIMBS, sizeof(Limb) * LIMBS);
+    }
+}
+
+inline Fr fromLimbs(const Limb* in) {
+    Fr r;
+    unpack(&r, in, 1);
+    return r;
+}
+
+// 对 [0, n) 分块执行逐元素内核
+void applyBlocked(Kernel kernel, Fr* z, const Fr* x, const Fr* y, size_t n) {
+    Limb bx[BLOCK * LIMBS], by[BLOCK * LIMBS], bz[BLOCK * LIMBS];
+    for (size_t off = 0; off < n; off += BLOCK) {
+        const size_t cnt = std::min(BLOCK, n - off);
+        pack(bx, x + off, cnt);
+        pack(by, y + off, cnt);
+        kernel(bz, bx, by, cnt);
+        unpack(z + off, bz, cnt);
+    }
+}
+
+// acc[0..lanes) 按通道乘上 vals 中的 n 个值（vals 为打包数组）
+void accumulateLanes(Limb* acc, const Limb* vals, size_t n, const Dispatch& d) {
+    const size_t L = d.lanes;
+    size_t i = 0;
+    for (; i + L <= n; i += L) {
+        d.mul(acc, acc, vals + i * LIMBS, L);
+    }
+    for (size_t k = 0; i < n; ++i, ++k) {
+        montMulScalar(acc + k * LIMBS, acc + k * LIMBS, vals + i * LIMBS);
+    }
+}
+
+Fr combineLanes(const Limb* acc, size_t lanes) {
+    Fr r = fromLimbs(acc);
+    for (size_t k = 1; k < lanes; ++k) r *= fromLimbs(acc + k * LIMBS);
+    return r;
+}
+
+} // namespace
+
+bool isSupported(Backend backend) {
+    switch (backend) {
+    case Backend::SCALAR:
+        return true;
+#ifdef FR_SIMD_X86
+    case Backend::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case Backend::AVX512:
+        return __builtin_cpu_supports("avx512f");
+    case Backend::AVX512_IFMA:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512ifma");
+#endif
+    default:
+        return false;
+    }
+}
+
+Backend activeBackend() {
+    return dispatch().backend;
+}
+
+bool setBackend(Backend backend) {
+    if (!isSupported(backend)) return false;
+    activeDispatch().store(&dispatchFor(backend), std::memory_order_release);
+    return true;
+}
+
+const char* backendName(Backend backend) {
+    switch (backend) {
+    case Backend::AVX2: return "AVX2";
+    case Backend::AVX512: return "AVX-512F";
+    case Backend::AVX512_IFMA: return "AVX-512 IFMA";
+    default: return "scalar";
+    }
+}
+
+void mulVec(Fr* z, const Fr* x, const Fr* y, size_t n) {
+    const Dispatch& d = dispatch();
+    if (d.backend == Backend::SCALAR) {
+        for (size_t i = 0; i < n; ++i) Fr::mul(z[i], x[i], y[i]);
+        return;
+    }
+    applyBlocked(d.mul, z, x, y, n);
+}
+
+void addVec(Fr* z, const Fr* x, const Fr* y, size_t n) {
+    const Dispatch& d = dispatch();
+    if (d.backend == Backend::SCALAR) {
+        for (size_t i = 0; i < n; ++i) Fr::add(z[i], x[i], y[i]);
+        return;
+    }
+    applyBlocked(d.add, z, x, y, n);
+}
+
+void subVec(Fr* z, const Fr* x, const Fr* y, size_t n) {
+    const Dispatch& d = dispatch();
+    if (d.backend == Backend::SCALAR) {
+        for (size_t i = 0; i < n; ++i) Fr::sub(z[i], x[i], y[i]);
+        return;
+    }
+    applyBlocked(d.sub, z, x, y, n);
+}
+
+Fr product(const Fr* x, size_t n) {
+    const Dispatch& d = dispatch();
+    if (d.backend == Backend::SCALAR || n < 2 * d.lanes) {
+        Fr r = 1;
+        for (size_t i = 0; i < n; ++i) r *= x[i];
+        return r;
+    }
+    const Params& P = params();
+    Limb acc[MAX_LANES * LIMBS], buf[BLOCK * LIMBS];
+    for (size_t k = 0; k < d.lanes; ++k) std::memcpy(acc + k * LIMBS, P.one, sizeof(P.one));
+    for (size_t off = 0; off < n; off += BLOCK) {
+        const size_t cnt = std::min(BLOCK, n - off);
+        pack(buf, x + off, cnt);
+        accumulateLanes(acc, buf, cnt, d);
+    }
+    return combineLanes(acc, d.lanes);
+}
+
+Fr linearProduct(const Fr& a, const int* roots, size_t n) {
+    const Dispatch& d = dispatch();
+    if (d.backend == Backend::SCALAR || n < 2 * d.lanes) {
+        Fr r = 1;
+        for (size_t i = 0; i < n; ++i) r *= (a - Fr(roots[i]));
+        return r;
+    }
+
+    // a 的普通表示：a·R^{-1} 的 Montgomery 表示恰为 a
+    const Params& P = params();
+    Fr a_norm = a * P.r_inv;
+    Limb a_plain[LIMBS];
+    std::memcpy(a_plain, a_norm.getUnit(), sizeof(a_plain));
+
+    // 通道累加器初始化为 Montgomery 形式的 1；每次 Montgomery 乘以普通表示的值
+    // 都多除一个 R，因此不逐个转换 a - r_i，而是最后统一乘回 R^n
+    Limb acc[MAX_LANES * LIMBS], buf[BLOCK * LIMBS];
+    for (size_t k = 0; k < d.lanes; ++k) std::memcpy(acc + k * LIMBS, P.one, sizeof(P.one));
+    for (size_t off = 0; off < n; off += BLOCK) {
+        const size_t cnt = std::min(BLOCK, n - off);
+        for (size_t i = 0; i < cnt; ++i) {
+            Limb* out = buf + i * LIMBS;
+            const int r = roots[off + i];
+            Limb small[LIMBS] = {0, 0, 0, 0};
+            if (r >= 0) {
+                small[0] = static_cast<Limb>(r);
+                if (subLimbs(out, a_plain, small)) addLimbs(out, out, P.p);
+            } else {
+                small[0] = static_cast<Limb>(-static_cast<int64_t>(r));
+                addLimbs(out, a_plain, small);
+                if (geq(out, P.p)) subLimbs(out, out, P.p);
+            }
+        }
+        accumulateLanes(acc, buf, cnt, d);
+    }
+    Fr r_pow;
+    Fr::pow(r_pow, P.r, static_cast<int64_t>(n));
+    return combineLanes(acc, d.lanes) * r_pow;
+}
+
+void batchInvert(Fr* x, size_t n) {
+    const Dispatch& d = dispatch();
+    const size_t L = d.lanes;
+    if (n == 0) return;
+
+    if (d.backend == Backend::SCALAR || n < 4 * L) {
+        // 标量 Montgomery 技巧
+        std::vector<Fr> prefix(n);
+        Fr acc = 1;
+        for (size_t i = 0; i < n; ++i) {
+            prefix[i] = acc;
+            if (!x[i].isZero()) acc *= x[i];
+        }
+        Fr inv;
+        Fr::inv(inv, acc);
+        for (size_t i = n; i-- > 0;) {
+            if (x[i].isZero()) continue;
+            Fr next = inv * x[i];
+            x[i] = inv * prefix[i];
+            inv = next;
+        }
+        return;
+    }
+
+    const Params& P = params();
+    std::vector<Limb> vals(n * LIMBS), pre(n * LIMBS);
+    std::vector<bool> is_zero(n);
+    pack(vals.data(), x, n);
+    for (size_t i = 0; i < n; ++i) {
+        is_zero[i] = x[i].isZero();
+        if (is_zero[i]) std::memcpy(&vals[i * LIMBS], P.one, sizeof(P.one));
+    }
+
+    // 通道 k 负责下标 ≡ k (mod L) 的链：pre[i] = pre[i - L] · x[i]
+    const size_t full = (n / L) * L;
+    std::memcpy(pre.data(), vals.data(), sizeof(Limb) * LIMBS * L);
+    for (size_t g = L; g < full; g += L) {
+        d.mul(&pre[g * LIMBS], &pre[(g - L) * LIMBS], &vals[g * LIMBS], L);
+    }
+    for (size_t i = full; i < n; ++i) {
+        montMulScalar(&pre[i * LIMBS], &pre[(i - L) * LIMBS], &vals[i * LIMBS]);
+    }
+
+    // 各链总积只求一次逆
+    std::vector<Fr> totals(L);
+    for (size_t k = 0; k < L; ++k) {
+        size_t last = full + k < n ? full + k : full - L + k;
+        totals[k] = fromLimbs(&pre[last * LIMBS]);
+    }
+    Fr all = 1;
+    std::vector<Fr> partial(L);
+    for (size_t k = 0; k < L; ++k) {
+        partial[k] = all;
+        all *= totals[k];
+    }
+    Fr all_inv;
+    Fr::inv(all_inv, all);
+    Limb acc[MAX_LANES * LIMBS];
+    for (size_t k = L; k-- > 0;) {
+        Fr inv_k = all_inv * partial[k];
+        all_inv *= totals[k];
+        pack(acc + k * LIMBS, &inv_k, 1);
+    }
+
+    // 反向：out[i] = acc · pre[i - L]，acc <- acc · x[i]
+    std::vector<Limb> out(n * LIMBS);
+    for (size_t i = n; i-- > full;) {
+        Limb* a = acc + (i % L) * LIMBS;
+        montMulScalar(&out[i * LIMBS], a, &pre[(i - L) * LIMBS]);
+        montMulScalar(a, a, &vals[i * LIMBS]);
+    }
+    for (size_t g = full - L; g >= L; g -= L) {
+        d.mul(&out[g * LIMBS], acc, &pre[(g - L) * LIMBS], L);
+        d.mul(acc, acc, &vals[g * LIMBS], L);
+    }
+    std::memcpy(out.data(), acc, sizeof(Limb) * LIMBS * L);
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!is_zero[i]) unpack(x + i, &out[i * LIMBS], 1);
+    }
+}
+
+} // namespace FrSimd
+} // namespace expressive_accumulator
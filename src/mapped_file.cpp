@@ -0,0 +1,51 @@
+/**
+ * @file mapped_file.cpp
+ * @brief 只读内存映射文件的实现。
+ */
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace expressive_accumulator {
+
+MappedFile::MappedFile(const std::string& path, bool sequential) : data_(nullptr), size_(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("MappedFile: cannot open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedFile: cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("MappedFile: cannot map " + path);
+        }
+        if (sequential) ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const uint8_t*>(addr);
+    }
+    // 映射建立后即可关闭文件描述符
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+const uint8_t* MappedFile::range(size_t offset, size_t length) const {
+    if (offset > size_ || length > size_ - offset) {
+        throw std::out_of_range("MappedFile: range exceeds file size");
+    }
+    return data_ + offset;
+}
+
+} // namespace expressive_accumulator
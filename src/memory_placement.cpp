@@ -0,0 +1,215 @@
+/**
+ * @file memory_placement.cpp
+ * @brief 大页分配、NUMA 节点绑定与线程亲和性的实现（Linux 系统调用）。
+ */
+#include "memory_placement.h"
+#include <algorithm>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace expressive_accumulator {
+
+namespace {
+
+// 解析 "0-3,8,10-11" 形式的列表
+std::vector<int> parseList(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        int lo = std::stoi(item.substr(0, dash));
+        int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+        for (int v = lo; v <= hi; ++v) values.push_back(v);
+    }
+    return values;
+}
+
+std::string readSysFile(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+// 节点拓扑只在第一次使用时从 sysfs 读取
+struct Topology {
+    size_t node_count = 1;
+    std::vector<std::vector<int>> node_cpus; // 节点 -> CPU
+    std::vector<int> cpu_node;               // CPU -> 节点
+
+    Topology() {
+        std::vector<int> nodes;
+        try {
+            nodes = parseList(readSysFile("/sys/devices/system/node/online"));
+        } catch (const std::exception&) {
+            nodes.clear();
+        }
+        if (nodes.empty()) nodes.push_back(0);
+        node_count = static_cast<size_t>(*std::max_element(nodes.begin(), nodes.end())) + 1;
+        node_cpus.resize(node_count);
+        for (int node : nodes) {
+            try {
+                node_cpus[node] = parseList(readSysFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"));
+            } catch (const std::exception&) {
+                node_cpus[node].clear();
+            }
+            for (int cpu : node_cpus[node]) {
+                if (cpu >= static_cast<int>(cpu_node.size())) cpu_node.resize(cpu + 1, 0);
+                cpu_node[cpu] = node;
+            }
+        }
+    }
+};
+
+const Topology& topology() {
+    static const Topology topo;
+    return topo;
+}
+
+size_t roundUp(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) / unit * unit;
+}
+
+} // namespace
+
+// ==========================================================================================
+// MemoryPlacement
+// ==========================================================================================
+
+namespace MemoryPlacement {
+
+size_t numaNodeCount() {
+    return topology().node_count;
+}
+
+int currentNode() {
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    const Topology& topo = topology();
+    if (cpu >= 0 && cpu < static_cast<int>(topo.cpu_node.size())) return topo.cpu_node[cpu];
+#endif
+    return 0;
+}
+
+bool bindThreadToNode(int node) {
+#if defined(__linux__)
+    const Topology& topo = topology();
+    if (node < 0 || node >= static_cast<int>(topo.node_count) || topo.node_cpus[node].empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : topo.node_cpus[node]) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+void* allocate(size_t bytes, HugePageMode mode, int node) {
+    const size_t size = roundUp(std::max<size_t>(bytes, 1), HUGE_PAGE_BYTES);
+#if defined(__linux__)
+    void* ptr = MAP_FAILED;
+    if (mode == HugePageMode::EXPLICIT) {
+        ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        // 大页池不足时退回透明大页
+        if (ptr == MAP_FAILED) mode = HugePageMode::TRANSPARENT;
+    }
+    if (ptr == MAP_FAILED) {
+        // 多映射一个大页再裁掉首尾，使区域按 2 MiB 对齐，透明大页才能覆盖整段
+        const size_t padded = size + HUGE_PAGE_BYTES;
+        void* raw = ::mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+        uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = roundUp(begin, HUGE_PAGE_BYTES);
+        if (aligned > begin) ::munmap(raw, aligned - begin);
+        if (begin + padded > aligned + size) {
+            ::munmap(reinterpret_cast<void*>(aligned + size), begin + padded - aligned - size);
+        }
+        ptr = reinterpret_cast<void*>(aligned);
+        if (mode == HugePageMode::TRANSPARENT) ::madvise(ptr, size, MADV_HUGEPAGE);
+    }
+    if (node >= 0 && static_cast<size_t>(node) < numaNodeCount()) {
+        // MPOL_PREFERRED：页在首次写入时优先放在 node 上，节点内存不足时仍可回退；不支持时忽略
+        const int MPOL_PREFERRED_MODE = 1;
+        const size_t bits = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> mask(numaNodeCount() / bits + 1, 0);
+        mask[node / bits] |= 1UL << (node % bits);
+        ::syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_MODE, mask.data(), mask.size() * bits, 0);
+    }
+    return ptr;
+#else
+    (void)mode;
+    (void)node;
+    void* ptr = ::operator new(size, std::align_val_t(HUGE_PAGE_BYTES));
+    std::fill(static_cast<uint8_t*>(ptr), static_cast<uint8_t*>(ptr) + size, 0);
+    return ptr;
+#endif
+}
+
+void release(void* ptr, size_t bytes) {
+    if (ptr == nullptr) return;
+#if defined(__linux__)
+    ::munmap(ptr, roundUp(std::max<size_t>(bytes, 1), HUGE_PAGE_BYTES));
+#else
+    (void)bytes;
+    ::operator delete(ptr, std::align_val_t(HUGE_PAGE_BYTES));
+#endif
+}
+
+} // namespace MemoryPlacement
+
+// ==========================================================================================
+// PlacedArena
+// ==========================================================================================
+
+PlacedArena::PlacedArena(HugePageMode mode, int node) : mode_(mode), node_(node) {}
+
+PlacedArena::~PlacedArena() {
+    reset();
+}
+
+void* PlacedArena::allocate(size_t bytes, size_t align) {
+    if (!regions_.empty()) {
+        Region& region = regions_.back();
+        size_t offset = roundUp(region.used, align);
+        if (offset + bytes <= region.size) {
+            region.used = offset + bytes;
+            return region.base + offset;
+        }
+    }
+    // 区域按大页对齐，新区域的起点满足任何不超过 2 MiB 的对齐要求；
+    // 不要求大页和节点时用较小的区域，小表不必映射整块 REGION_BYTES
+    const bool placed = mode_ != HugePageMode::NONE || node_ >= 0;
+    const size_t size = std::max(placed ? REGION_BYTES : MemoryPlacement::HUGE_PAGE_BYTES,
+                                 roundUp(bytes, MemoryPlacement::HUGE_PAGE_BYTES));
+    uint8_t* base = static_cast<uint8_t*>(MemoryPlacement::allocate(size, mode_, node_));
+    regions_.push_back(Region{base, size, bytes});
+    return base;
+}
+
+void PlacedArena::reset() {
+    for (const Region& region : regions_) MemoryPlacement::release(region.base, region.size);
+    regions_.clear();
+}
+
+size_t PlacedArena::mappedBytes() const {
+    size_t total = 0;
+    for (const Region& region : regions_) total += region.size;
+    return total;
+}
+
+} // namespace expressive_accumulator
@@ -0,0 +1,189 @@
+/**
+ * @file multiset_accumulator.cpp
+ * @brief 多重集累加器：(元素, 重数) 存储、按幂次计算的增量摘要与重数证明。
+ */
+#include "multiset_accumulator.h"
+#include "fr_polynomial.h"
+#include <stdexcept>
+#include <vector>
+
+namespace expressive_accumulator {
+
+namespace {
+
+// (base)^k，平方-乘法
+Fr powFr(const Fr& base, uint32_t k) {
+    Fr out;
+    Fr::pow(out, base, static_cast<int64_t>(k));
+    return out;
+}
+
+} // namespace
+
+MultisetAccumulator::MultisetAccumulator(const ExpressiveTrustedSetup& setup)
+    : trusted_setup(setup), total_count(0) {
+    if (!setup.hasSecret()) {
+        throw std::logic_error("MultisetAccumulator: setup has no secret to maintain P(s) with");
+    }
+    poly_at_s = 1; // 空多重集的多项式是 P(z) = 1
+    digest.initialize(setup.getG1Generator());
+}
+
+void MultisetAccumulator::updateDigest() {
+    G1::mul(digest.value, trusted_setup.getG1Generator(), poly_at_s);
+}
+
+uint32_t MultisetAccumulator::multiplicity(int element) const {
+    auto it = counts.find(element);
+    return it == counts.end() ? 0 : it->second;
+}
+
+// ==========================================================================================
+// MultisetAccumulator - 增删与求值
+// ==========================================================================================
+
+void MultisetAccumulator::addElement(int element, uint32_t count) {
+    if (count == 0) {
+        throw std::invalid_argument("MultisetAccumulator: count must be positive");
+    }
+    const uint64_t updated = static_cast<uint64_t>(multiplicity(element)) + count;
+    if (updated > UINT32_MAX) {
+        throw std::invalid_argument("MultisetAccumulator: multiplicity overflow");
+    }
+    counts[element] = static_cast<uint32_t>(updated);
+    total_count += count;
+    poly_at_s *= powFr(trusted_setup.getSecretS() - Fr(element), count);
+    updateDigest();
+}
+
+bool MultisetAccumulator::removeElement(int element, uint32_t count) {
+    if (count == 0) {
+        throw std::invalid_argument("MultisetAccumulator: count must be positive");
+    }
+    auto it = counts.find(element);
+    if (it == counts.end() || it->second < count) return false;
+
+    const Fr factor = powFr(trusted_setup.getSecretS() - Fr(element), count);
+    if (it->second == count) {
+        counts.erase(it);
+    } else {
+        it->second -= count;
+    }
+    total_count -= count;
+    if (factor.isZero()) {
+        // s 恰为该元素，无法相除，退回直接求值
+        poly_at_s = evaluate(trusted_setup.getSecretS());
+    } else {
+        Fr::div(poly_at_s, poly_at_s, factor);
+    }
+    updateDigest();
+    return true;
+}
+
+Fr MultisetAccumulator::evaluate(const Fr& z) const {
+    Fr product = 1;
+    for (const auto& entry : counts) product *= powFr(z - Fr(entry.first), entry.second);
+    return product;
+}
+
+Fr MultisetAccumulator::quotientValue(int element, uint32_t k) const {
+    const Fr& secret_s = trusted_setup.getSecretS();
+    const Fr factor = powFr(secret_s - Fr(element), k);
+    if (!factor.isZero()) {
+        Fr quotient;
+        Fr::div(quotient, poly_at_s, factor);
+        return quotient;
+    }
+    Fr product = powFr(secret_s - Fr(element), multiplicity(element) - k);
+    for (const auto& entry : counts) {
+        if (entry.first != element) product *= powFr(secret_s - Fr(entry.first), entry.second);
+    }
+    return product;
+}
+
+// ==========================================================================================
+// MultisetAccumulator - 重数证明
+// ==========================================================================================
+
+MultiplicityProof MultisetAccumulator::generateMultiplicityProof(int element, uint32_t k, bool exact) const {
+    if (k == 0) {
+        throw std::invalid_argument("MultisetAccumulator: proven multiplicity must be positive");
+    }
+    MultiplicityProof proof;
+    proof.multiplicity = k;
+    proof.exact = exact;
+    const uint32_t m = multiplicity(element);
+    if (m < k || (exact && m != k)) {
+        return proof;
+    }
+
+    // W = g2^{P(s)/(s-x)^k}
+    const Fr quotient_s = quotientValue(element, k);
+    G2::mul(proof.witness_g2, trusted_setup.getG2Generator(), quotient_s);
+
+    if (exact) {
+        // y = Q(x) = ∏_{x' ≠ x} (x - x')^{k'}，非零说明 (z - x) 不再整除 Q
+        const Fr x(element);
+        const Fr& secret_s = trusted_setup.getSecretS();
+        Fr y = 1;
+        for (const auto& entry : counts) {
+            if (entry.first != element) y *= powFr(x - Fr(entry.first), entry.second);
+        }
+        proof.remainder = y;
+
+        Fr exact_s;
+        const Fr denominator = secret_s - x;
+        if (!denominator.isZero()) {
+            Fr::div(exact_s, quotient_s - y, denominator);
+        } else {
+            // s 恰为 x：展开 Q 的系数，综合除法求 (Q(z) - y)/(z - x) 后在 s 处求值
+            std::vector<Fr> roots;
+            for (const auto& entry : counts) {
+                if (entry.first != element) roots.insert(roots.end(), entry.second, Fr(entry.first));
+            }
+            FrPolynomial::Poly q = FrPolynomial::fromRoots(roots);
+            FrPolynomial::Poly divided(q.size() > 1 ? q.size() - 1 : 0);
+            Fr acc = 0;
+            for (size_t i = q.size(); i-- > 1;) {
+                acc = acc * x + q[i];
+                divided[i - 1] = acc;
+            }
+            exact_s = FrPolynomial::evaluate(divided, secret_s);
+        }
+        G2::mul(proof.exact_witness_g2, trusted_setup.getG2Generator(), exact_s);
+    }
+    proof.is_valid = true;
+    return proof;
+}
+
+bool MultisetAccumulator::verifyMultiplicityProof(const AccumulatorDigest& acc_digest,
+                                                  int element,
+                                                  const MultiplicityProof& proof,
+                                                  const ExpressiveTrustedSetup& setup) {
+    if (!proof.is_valid || proof.multiplicity == 0) {
+        return false;
+    }
+    const Fr sx = setup.getSecretS() - Fr(element);
+
+    // e(A, g2) == e(g1^{(s-x)^k}, W)
+    GT lhs, rhs;
+    setup.pairingCache().pairing(lhs, acc_digest.value, setup.getG2Generator());
+    G1 divisor_g1;
+    G1::mul(divisor_g1, setup.getG1Generator(), powFr(sx, proof.multiplicity));
+    pairing(rhs, divisor_g1, proof.witness_g2);
+    if (!(lhs == rhs)) return false;
+    if (!proof.exact) return true;
+
+    // e(g1, W - y·g2) == e(g1^{s-x}, W')，且 y ≠ 0
+    if (proof.remainder.isZero()) return false;
+    G2 y_g2, shifted;
+    G2::mul(y_g2, setup.getG2Generator(), proof.remainder);
+    G2::sub(shifted, proof.witness_g2, y_g2);
+    G1 sx_g1;
+    G1::mul(sx_g1, setup.getG1Generator(), sx);
+    pairing(lhs, setup.getG1Generator(), shifted);
+    pairing(rhs, sx_g1, proof.exact_witness_g2);
+    return lhs == rhs;
+}
+
+} // namespace expressive_accumulator
@@ -0,0 +1,87 @@
+/**
+ * @file pairing_cache.cpp
+ * @brief 固定 G2 底点的配对缓存实现。
+ */
+#include "pairing_cache.h"
+
+namespace expressive_accumulator {
+
+PairingCache::PairingCache(size_t capacity) : capacity_(capacity), bound_(false) {
+    base_.clear();
+}
+
+std::shared_ptr<const std::vector<Fp6>> PairingCache::bindBase(const G2& Q) {
+    if (!bound_ || !(Q == base_)) {
+        std::shared_ptr<std::vector<Fp6>> lines(new std::vector<Fp6>);
+        precomputeG2(*lines, Q);
+        lines_ = lines;
+        base_ = Q;
+        bound_ = true;
+        entries_.clear();
+        index_.clear();
+    }
+    return lines_;
+}
+
+void PairingCache::evictOverflow() {
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+void PairingCache::pairing(GT& out, const G1& P, const G2& Q) {
+    const std::string key = P.getStr(mcl::IoSerialize);
+    std::shared_ptr<const std::vector<Fp6>> lines;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lines = bindBase(Q);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            out = it->second->second;
+            ++stats_.hits;
+            return;
+        }
+        ++stats_.misses;
+    }
+
+    GT ml;
+    precomputedMillerLoop(ml, P, *lines);
+    finalExp(out, ml);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 计算期间底点可能已改变，或其他线程已插入同一键
+    if (capacity_ == 0 || lines != lines_ || index_.count(key) != 0) return;
+    entries_.emplace_front(key, out);
+    index_[key] = entries_.begin();
+    evictOverflow();
+}
+
+void PairingCache::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evictOverflow();
+}
+
+size_t PairingCache::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+void PairingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    stats_ = PairingCacheStats();
+}
+
+PairingCacheStats PairingCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PairingCacheStats snapshot = stats_;
+    snapshot.entries = entries_.size();
+    return snapshot;
+}
+
+} // namespace expressive_accumulator
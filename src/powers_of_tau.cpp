@@ -0,0 +1,358 @@
+/**
+ * @file powers_of_tau.cpp
+ * @brief powers-of-tau 仪式文件的流式导入与 Zcash 压缩点编解码。
+ */
+#include "powers_of_tau.h"
+#include "binary_codec.h"
+#include "expressive_accumulator.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace expressive_accumulator {
+
+namespace {
+
+const size_t FP_BYTES = 48;
+const size_t RESPONSE_HASH_BYTES = 64;
+
+const uint8_t FLAG_COMPRESSED = 0x80;
+const uint8_t FLAG_INFINITY = 0x40;
+const uint8_t FLAG_LARGEST_Y = 0x20;
+
+using BinaryCodec::readLE;
+
+bool allZero(const uint8_t* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] != 0) return false;
+    }
+    return true;
+}
+
+// 大端字节到 Fp，first_mask 用于去掉首字节中的标志位；值不小于 p 时失败
+bool fpFromBE(Fp& x, const uint8_t* p, uint8_t first_mask = 0xFF) {
+    uint8_t le[FP_BYTES];
+    for (size_t i = 0; i < FP_BYTES; ++i) le[i] = p[FP_BYTES - 1 - i];
+    le[FP_BYTES - 1] &= first_mask;
+    bool ok;
+    x.setArray(&ok, le, FP_BYTES);
+    return ok;
+}
+
+// Fp 的 96 位十六进制表示（定长，便于按字典序比较）
+std::string fpHex(const Fp& x) {
+    std::string hex = x.getStr(16);
+    return std::string(2 * FP_BYTES - hex.size(), '0') + hex;
+}
+
+void fpToBE(uint8_t* out, const Fp& x) {
+    const std::string hex = fpHex(x);
+    for (size_t i = 0; i < FP_BYTES; ++i) {
+        out[i] = static_cast<uint8_t>(std::stoul(hex.substr(2 * i, 2), nullptr, 16));
+    }
+}
+
+// Zcash 约定：y 作为整数大于 (p - 1)/2，即 y > -y
+bool isLargest(const Fp& y) {
+    return fpHex(y) > fpHex(-y);
+}
+
+// Fp2 先比较 c1，c1 为零时比较 c0
+bool isLargest(const Fp2& y) {
+    return y.b.isZero() ? isLargest(y.a) : isLargest(y.b);
+}
+
+// 由 x 恢复 y^2 = x^3 + b 的一个解，按 largest 选取符号；x 不在曲线上时失败
+template <typename G, typename F>
+bool decompress(G& P, const F& x, const F& b, bool largest) {
+    F rhs, y;
+    F::sqr(rhs, x);
+    F::mul(rhs, rhs, x);
+    F::add(rhs, rhs, b);
+    if (!F::squareRoot(y, rhs)) return false;
+    if (isLargest(y) != largest) F::neg(y, y);
+    P.x = x;
+    P.y = y;
+    P.z = 1;
+    return P.isValid() && P.isValidOrder();
+}
+
+// 检查首字节标志位；无穷远点要求其余字节全零
+template <typename G>
+bool readFlags(G& P, const uint8_t* buf, size_t len, bool& done) {
+    done = false;
+    if (!(buf[0] & FLAG_COMPRESSED)) return false;
+    if (buf[0] & FLAG_INFINITY) {
+        done = true;
+        P.clear();
+        return (buf[0] & ~(FLAG_COMPRESSED | FLAG_INFINITY)) == 0 && allZero(buf + 1, len - 1);
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------
+// snarkjs .ptau：小端 Montgomery 形式的未压缩点
+// ------------------------------------------------------------------
+
+struct SnarkjsDecoder {
+    Fp r_inv; // Montgomery 因子 2^{-384}
+
+    SnarkjsDecoder() {
+        Fp r;
+        Fp::pow(r, Fp(2), static_cast<int64_t>(8 * FP_BYTES));
+        Fp::inv(r_inv, r);
+    }
+
+    bool fp(Fp& x, const uint8_t* p) const {
+        bool ok;
+        x.setArray(&ok, p, FP_BYTES);
+        if (ok) x *= r_inv;
+        return ok;
+    }
+
+    bool operator()(G1& P, const uint8_t* p) const {
+        if (allZero(p, 2 * FP_BYTES)) {
+            P.clear();
+            return true;
+        }
+        if (!fp(P.x, p) || !fp(P.y, p + FP_BYTES)) return false;
+        P.z = 1;
+        return P.isValid() && P.isValidOrder();
+    }
+
+    bool operator()(G2& P, const uint8_t* p) const {
+        if (allZero(p, 4 * FP_BYTES)) {
+            P.clear();
+            return true;
+        }
+        if (!fp(P.x.a, p) || !fp(P.x.b, p + FP_BYTES) ||
+            !fp(P.y.a, p + 2 * FP_BYTES) || !fp(P.y.b, p + 3 * FP_BYTES)) {
+            return false;
+        }
+        P.z = 1;
+        return P.isValid() && P.isValidOrder();
+    }
+};
+
+// Zcash 压缩编码
+struct CompressedDecoder {
+    bool operator()(G1& P, const uint8_t* p) const { return PowersOfTau::decodeG1(P, p); }
+    bool operator()(G2& P, const uint8_t* p) const { return PowersOfTau::decodeG2(P, p); }
+};
+
+// 文件中一张幂次表的位置
+struct TableLayout {
+    size_t offset = 0;
+    size_t stride = 0;
+    size_t count = 0;
+};
+
+struct PtauLayout {
+    TableLayout g1, g2;
+};
+
+PtauLayout snarkjsLayout(const MappedFile& file) {
+    const uint8_t* header = file.range(0, 12);
+    if (std::memcmp(header, "ptau", 4) != 0) {
+        throw std::runtime_error("PowersOfTau: missing ptau magic");
+    }
+    const uint32_t num_sections = readLE<uint32_t>(header + 8);
+
+    PtauLayout layout;
+    bool has_header = false;
+    size_t pos = 12;
+    for (uint32_t k = 0; k < num_sections; ++k) {
+        const uint8_t* sec = file.range(pos, 12);
+        const uint32_t type = readLE<uint32_t>(sec);
+        const uint64_t size = readLE<uint64_t>(sec + 4);
+        const size_t data = pos + 12;
+        file.range(data, size);
+        if (type == 1) {
+            // n8 与 q 必须对应 BLS12-381 的基域
+            const uint8_t* h = file.range(data, 4 + FP_BYTES);
+            if (readLE<uint32_t>(h) != FP_BYTES) {
+                throw std::runtime_error("PowersOfTau: ptau file is not for BLS12-381");
+            }
+            // q = (p - 1) + 1，按小端逐字节比较
+            uint8_t p_minus_one[FP_BYTES];
+            fpToBE(p_minus_one, -Fp(1));
+            std::reverse(p_minus_one, p_minus_one + FP_BYTES);
+            unsigned carry = 1;
+            for (size_t i = 0; i < FP_BYTES; ++i) {
+                unsigned byte = p_minus_one[i] + carry;
+                carry = byte >> 8;
+                if (static_cast<uint8_t>(byte) != h[4 + i]) {
+                    throw std::runtime_error("PowersOfTau: ptau file is not for BLS12-381");
+                }
+            }
+            has_header = true;
+        } else if (type == 2) {
+            layout.g1 = {data, 2 * FP_BYTES, static_cast<size_t>(size / (2 * FP_BYTES))};
+        } else if (type == 3) {
+            layout.g2 = {data, 4 * FP_BYTES, static_cast<size_t>(size / (4 * FP_BYTES))};
+        }
+        pos = data + size;
+    }
+    if (!has_header || layout.g1.count == 0 || layout.g2.count == 0) {
+        throw std::runtime_error("PowersOfTau: ptau file lacks header or tau sections");
+    }
+    return layout;
+}
+
+PtauLayout responseLayout(const MappedFile& file, size_t ceremony_power) {
+    if (ceremony_power == 0 || ceremony_power > 30) {
+        throw std::invalid_argument("PowersOfTau: ceremony_power must be set for response files");
+    }
+    const size_t tau_powers = size_t(1) << ceremony_power;
+    PtauLayout layout;
+    layout.g1 = {RESPONSE_HASH_BYTES, PowersOfTau::G1_COMPRESSED_BYTES, 2 * tau_powers - 1};
+    layout.g2 = {layout.g1.offset + layout.g1.count * layout.g1.stride, PowersOfTau::G2_COMPRESSED_BYTES, tau_powers};
+    file.range(layout.g2.offset, layout.g2.count * layout.g2.stride);
+    return layout;
+}
+
+/**
+ * @brief 按块解码一张幂次表：每块在多个线程上并行解压、检查，随后追加到表中。
+ * @details 峰值内存只有一块解码后的点，文件本身由内核按需换入。
+ */
+template <typename G, typename Decoder>
+void importTable(PowerTable<G>& table, const MappedFile& file, const TableLayout& layout,
+                 size_t count, const Decoder& decode, size_t num_threads) {
+    const size_t block = PowerTable<G>::CHUNK_SIZE;
+    const uint8_t* base = file.range(layout.offset, count * layout.stride);
+    std::vector<G> points;
+    for (size_t begin = 0; begin < count; begin += block) {
+        const size_t cnt = std::min(block, count - begin);
+        points.resize(cnt);
+        std::atomic<size_t> bad(count);
+        auto worker = [&](size_t lo, size_t hi) {
+            for (size_t k = lo; k < hi; ++k) {
+                if (!decode(points[k], base + (begin + k) * layout.stride)) {
+                    size_t expected = bad.load();
+                    while (begin + k < expected && !bad.compare_exchange_weak(expected, begin + k)) {}
+                }
+            }
+        };
+        const size_t threads_used = std::min(num_threads, cnt);
+        if (threads_used <= 1) {
+            worker(0, cnt);
+        } else {
+            std::vector<std::thread> threads;
+            size_t chunk = (cnt + threads_used - 1) / threads_used;
+            for (size_t lo = 0; lo < cnt; lo += chunk) {
+                threads.emplace_back(worker, lo, std::min(lo + chunk, cnt));
+            }
+            for (auto& t : threads) t.join();
+        }
+        if (bad.load() != count) {
+            throw std::runtime_error("PowersOfTau: invalid point at index " + std::to_string(bad.load()));
+        }
+        table.append(points);
+    }
+}
+
+} // namespace
+
+// ==========================================================================================
+// PowersOfTau - Zcash 压缩编码
+// ==========================================================================================
+
+namespace PowersOfTau {
+
+bool decodeG1(G1& P, const uint8_t* buf) {
+    bool done;
+    if (!readFlags(P, buf, G1_COMPRESSED_BYTES, done)) return false;
+    if (done) return true;
+    Fp x;
+    if (!fpFromBE(x, buf, 0x1F)) return false;
+    return decompress(P, x, Fp(4), (buf[0] & FLAG_LARGEST_Y) != 0);
+}
+
+bool decodeG2(G2& P, const uint8_t* buf) {
+    bool done;
+    if (!readFlags(P, buf, G2_COMPRESSED_BYTES, done)) return false;
+    if (done) return true;
+    Fp2 x;
+    if (!fpFromBE(x.b, buf, 0x1F) || !fpFromBE(x.a, buf + FP_BYTES)) return false;
+    Fp2 b;
+    b.a = 4;
+    b.b = 4;
+    return decompress(P, x, b, (buf[0] & FLAG_LARGEST_Y) != 0);
+}
+
+void encodeG1(uint8_t* buf, const G1& P) {
+    std::memset(buf, 0, G1_COMPRESSED_BYTES);
+    if (P.isZero()) {
+        buf[0] = FLAG_COMPRESSED | FLAG_INFINITY;
+        return;
+    }
+    G1 A = P;
+    A.normalize();
+    fpToBE(buf, A.x);
+    buf[0] |= FLAG_COMPRESSED | (isLargest(A.y) ? FLAG_LARGEST_Y : 0);
+}
+
+void encodeG2(uint8_t* buf, const G2& P) {
+    std::memset(buf, 0, G2_COMPRESSED_BYTES);
+    if (P.isZero()) {
+        buf[0] = FLAG_COMPRESSED | FLAG_INFINITY;
+        return;
+    }
+    G2 A = P;
+    A.normalize();
+    fpToBE(buf, A.x.b);
+    fpToBE(buf + FP_BYTES, A.x.a);
+    buf[0] |= FLAG_COMPRESSED | (isLargest(A.y) ? FLAG_LARGEST_Y : 0);
+}
+
+} // namespace PowersOfTau
+
+// ==========================================================================================
+// ExpressiveTrustedSetup - 仪式文件导入
+// ==========================================================================================
+
+std::unique_ptr<ExpressiveTrustedSetup> ExpressiveTrustedSetup::importPowersOfTau(
+    const std::string& path, const PtauImportOptions& options) {
+
+    MappedFile file(path, true);
+    PtauLayout layout;
+    try {
+        layout = (options.format == PtauFormat::SNARKJS_PTAU) ? snarkjsLayout(file)
+                                                              : responseLayout(file, options.ceremony_power);
+    } catch (const std::out_of_range&) {
+        throw std::runtime_error("PowersOfTau: truncated ceremony file " + path);
+    }
+
+    // 两张表等长：G1 表在仪式文件中约为 G2 表的两倍，多出的部分不需要
+    size_t count = std::min(layout.g1.count, layout.g2.count);
+    if (options.max_degree != 0) count = std::min(count, options.max_degree + 2);
+    if (count < 2) {
+        throw std::runtime_error("PowersOfTau: ceremony file has fewer than two powers");
+    }
+
+    size_t num_threads = options.num_threads;
+    if (num_threads == 0) {
+        num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    std::unique_ptr<ExpressiveTrustedSetup> setup(
+        new ExpressiveTrustedSetup(Fr(0), Fr(0), count - 2, options.storage, options.placement));
+    setup->has_secret = false;
+    if (options.format == PtauFormat::SNARKJS_PTAU) {
+        SnarkjsDecoder decoder;
+        importTable(setup->g2_s_powers, file, layout.g2, count, decoder, num_threads);
+        importTable(setup->g1_s_powers, file, layout.g1, count, decoder, num_threads);
+    } else {
+        CompressedDecoder decoder;
+        importTable(setup->g2_s_powers, file, layout.g2, count, decoder, num_threads);
+        importTable(setup->g1_s_powers, file, layout.g1, count, decoder, num_threads);
+    }
+    setup->g1_generator = setup->g1_s_powers.get(0);
+    setup->g2_generator = setup->g2_s_powers.get(0);
+    return setup;
+}
+
+} // namespace expressive_accumulator
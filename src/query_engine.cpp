@@ -0,0 +1,561 @@
+/**
+ * @file query_engine.cpp
+ * @brief 证明查询引擎的实现：表达式解析、查询计划与复合证明的生成和验证。
+ */
+#include "query_engine.h"
+#include "batch_inversion.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <stdexcept>
+
+namespace expressive_accumulator {
+
+namespace {
+
+enum class TokenType { NAME, INTERSECT, UNION, DIFFERENCE, LPAREN, RPAREN, END };
+
+struct Token {
+    TokenType type;
+    std::string text;
+};
+
+bool isNameChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+}
+
+std::vector<Token> tokenize(const std::string& text) {
+    // UTF-8 编码的 ∩ / ∪
+    static const std::string kIntersect = "\xE2\x88\xA9";
+    static const std::string kUnion = "\xE2\x88\xAA";
+
+    std::vector<Token> tokens;
+    size_t i = 0;
+    while (i < text.size()) {
+        char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (c == '&') {
+            tokens.push_back({TokenType::INTERSECT, "&"}); ++i;
+        } else if (c == '|') {
+            tokens.push_back({TokenType::UNION, "|"}); ++i;
+        } else if (c == '-' || c == '\\') {
+            tokens.push_back({TokenType::DIFFERENCE, "-"}); ++i;
+        } else if (c == '(') {
+            tokens.push_back({TokenType::LPAREN, "("}); ++i;
+        } else if (c == ')') {
+            tokens.push_back({TokenType::RPAREN, ")"}); ++i;
+        } else if (text.compare(i, kIntersect.size(), kIntersect) == 0) {
+            tokens.push_back({TokenType::INTERSECT, "&"}); i += kIntersect.size();
+        } else if (text.compare(i, kUnion.size(), kUnion) == 0) {
+            tokens.push_back({TokenType::UNION, "|"}); i += kUnion.size();
+        } else if (isNameChar(c)) {
+            size_t start = i;
+            while (i < text.size() && isNameChar(text[i])) ++i;
+            tokens.push_back({TokenType::NAME, text.substr(start, i - start)});
+        } else {
+            throw std::invalid_argument("query: unexpected character at offset " + std::to_string(i));
+        }
+    }
+    tokens.push_back({TokenType::END, ""});
+    return tokens;
+}
+
+// 将同类的多元运算展平后追加为 parent 的子节点
+void appendFlattened(QueryExpr& parent, const std::shared_ptr<QueryExpr>& child) {
+    if (child->op == parent.op) {
+        parent.children.insert(parent.children.end(), child->children.begin(), child->children.end());
+    } else {
+        parent.children.push_back(child);
+    }
+}
+
+class Parser {
+public:
+    explicit Parser(const std::string& text) : tokens(tokenize(text)), pos(0) {}
+
+    std::shared_ptr<QueryExpr> parse() {
+        auto expr = parseExpr();
+        expect(TokenType::END);
+        return expr;
+    }
+
+private:
+    const Token& peek() const { return tokens[pos]; }
+
+    void expect(TokenType type) {
+        if (peek().type != type) {
+            throw std::invalid_argument("query: unexpected token '" + peek().text + "'");
+        }
+        ++pos;
+    }
+
+    std::shared_ptr<QueryExpr> parseExpr() {
+        auto left = parseTerm();
+        while (peek().type == TokenType::UNION || peek().type == TokenType::DIFFERENCE) {
+            QueryOp op = (peek().type == TokenType::UNION) ? QueryOp::UNION : QueryOp::DIFFERENCE;
+            ++pos;
+            auto right = parseTerm();
+
+            auto node = std::make_shared<QueryExpr>();
+            node->op = op;
+            if (op == QueryOp::UNION) {
+                appendFlattened(*node, left);
+                appendFlattened(*node, right);
+            } else {
+                node->children = {left, right};
+            }
+            left = node;
+        }
+        return left;
+    }
+
+    std::shared_ptr<QueryExpr> parseTerm() {
+        auto left = parseFactor();
+        if (peek().type != TokenType::INTERSECT) return left;
+
+        auto node = std::make_shared<QueryExpr>();
+        node->op = QueryOp::INTERSECT;
+        appendFlattened(*node, left);
+        while (peek().type == TokenType::INTERSECT) {
+            ++pos;
+            appendFlattened(*node, parseFactor());
+        }
+        return node;
+    }
+
+    std::shared_ptr<QueryExpr> parseFactor() {
+        if (peek().type == TokenType::LPAREN) {
+            ++pos;
+            auto expr = parseExpr();
+            expect(TokenType::RPAREN);
+            return expr;
+        }
+        if (peek().type != TokenType::NAME) {
+            throw std::invalid_argument("query: expected accumulator name, got '" + peek().text + "'");
+        }
+        auto leaf = std::make_shared<QueryExpr>();
+        leaf->op = QueryOp::LEAF;
+        leaf->name = peek().text;
+        ++pos;
+        return leaf;
+    }
+
+    std::vector<Token> tokens;
+    size_t pos;
+};
+
+const char* opSymbol(QueryOp op) {
+    switch (op) {
+        case QueryOp::INTERSECT: return "&";
+        case QueryOp::UNION: return "|";
+        case QueryOp::DIFFERENCE: return "-";
+        default: return "";
+    }
+}
+
+bool isAssociative(QueryOp op) {
+    return op == QueryOp::INTERSECT || op == QueryOp::UNION;
+}
+
+// 由规范操作数列表构造规范键；交集/并集的操作数与顺序无关
+std::string makeKey(QueryOp op, std::vector<std::string> operands) {
+    if (isAssociative(op)) {
+        std::sort(operands.begin(), operands.end());
+    }
+    std::string key = opSymbol(op);
+    key += "(";
+    for (size_t i = 0; i < operands.size(); ++i) {
+        if (i > 0) key += ",";
+        key += operands[i];
+    }
+    key += ")";
+    return key;
+}
+
+void collectOperands(const QueryExpr& expr, QueryOp parent_op, std::vector<std::string>& out) {
+    if (expr.op == parent_op && isAssociative(parent_op)) {
+        for (const auto& child : expr.children) {
+            collectOperands(*child, parent_op, out);
+        }
+    } else {
+        out.push_back(expr.canonical());
+    }
+}
+
+// 在复合证明节点上计算规范键，证明者与验证者共用
+struct KeyTable {
+    std::vector<std::string> keys;
+    std::vector<std::vector<std::string>> operands;  ///< 交集/并集节点展平后的操作数
+
+    std::vector<std::string> operandsFor(QueryOp op, int idx, QueryOp node_op) const {
+        if (node_op == op && isAssociative(op)) return operands[idx];
+        return {keys[idx]};
+    }
+
+    void pushLeaf(const std::string& name) {
+        keys.push_back(name);
+        operands.push_back({name});
+    }
+
+    // 计算 left op right 的规范键与展平操作数，不修改表
+    std::string combinedKey(QueryOp op, int left, QueryOp left_op, int right, QueryOp right_op,
+                            std::vector<std::string>& ops) const {
+        ops = operandsFor(op, left, left_op);
+        std::vector<std::string> rhs = operandsFor(op, right, right_op);
+        ops.insert(ops.end(), rhs.begin(), rhs.end());
+        return makeKey(op, ops);
+    }
+
+    void pushCombined(QueryOp op, int left, QueryOp left_op, int right, QueryOp right_op) {
+        std::vector<std::string> ops;
+        keys.push_back(combinedKey(op, left, left_op, right, right_op, ops));
+        operands.push_back(std::move(ops));
+    }
+};
+
+} // namespace
+
+// ==========================================================================================
+// QueryExpr - 方法实现
+// ==========================================================================================
+
+std::shared_ptr<QueryExpr> QueryExpr::parse(const std::string& text) {
+    return Parser(text).parse();
+}
+
+std::string QueryExpr::canonical() const {
+    if (op == QueryOp::LEAF) return name;
+
+    std::vector<std::string> operands;
+    if (op == QueryOp::DIFFERENCE) {
+        operands = {children[0]->canonical(), children[1]->canonical()};
+    } else {
+        for (const auto& child : children) {
+            collectOperands(*child, op, operands);
+        }
+    }
+    return makeKey(op, operands);
+}
+
+// ==========================================================================================
+// QueryEngine - 方法实现
+// ==========================================================================================
+
+struct QueryEngine::PlanContext {
+    CompositeQueryProof proof;
+    std::vector<std::set<int>> sets;    ///< 每个节点的结果集合 (中间结果复用)
+    KeyTable key_table;
+    std::map<std::string, int> memo;    ///< 规范键 -> 节点下标
+};
+
+QueryEngine::QueryEngine(const ExpressiveTrustedSetup& setup) : trusted_setup(setup) {}
+
+void QueryEngine::registerAccumulator(const std::string& name, const ExpressiveAccumulator& acc) {
+    accumulators[name] = &acc;
+}
+
+CompositeQueryProof QueryEngine::evaluate(const std::string& expression) const {
+    return evaluate(*QueryExpr::parse(expression));
+}
+
+CompositeQueryProof QueryEngine::evaluate(const QueryExpr& expression) const {
+    PlanContext ctx;
+    ctx.proof.root = evaluateNode(expression, ctx);
+    ctx.proof.result = ctx.sets[ctx.proof.root];
+    ctx.proof.is_valid = true;
+    for (const auto& node : ctx.proof.nodes) {
+        if (node.op != QueryOp::LEAF && !node.intersection.is_valid) {
+            ctx.proof.is_valid = false;
+        }
+    }
+    return ctx.proof;
+}
+
+int QueryEngine::evaluateNode(const QueryExpr& expr, PlanContext& ctx) const {
+    std::string key = expr.canonical();
+    auto cached = ctx.memo.find(key);
+    if (cached != ctx.memo.end()) return cached->second;
+
+    if (expr.op == QueryOp::LEAF) {
+        auto it = accumulators.find(expr.name);
+        if (it == accumulators.end()) {
+            throw std::invalid_argument("query: unknown accumulator '" + expr.name + "'");
+        }
+        QueryProofNode node;
+        node.op = QueryOp::LEAF;
+        node.leaf_name = expr.name;
+        node.digest = it->second->getDigest();
+
+        int idx = static_cast<int>(ctx.proof.nodes.size());
+        ctx.proof.nodes.push_back(node);
+        ctx.sets.push_back(it->second->getElements());
+        ctx.key_table.pushLeaf(expr.name);
+        ctx.memo[key] = idx;
+        return idx;
+    }
+
+    if (expr.op == QueryOp::DIFFERENCE) {
+        int left = evaluateNode(*expr.children[0], ctx);
+        int right = evaluateNode(*expr.children[1], ctx);
+        return combine(QueryOp::DIFFERENCE, left, right, ctx);
+    }
+
+    // 多元交集/并集：先求各操作数，再按结果集合大小从小到大依次合并
+    std::vector<int> operands;
+    for (const auto& child : expr.children) {
+        operands.push_back(evaluateNode(*child, ctx));
+    }
+    std::stable_sort(operands.begin(), operands.end(), [&](int a, int b) {
+        if (ctx.sets[a].size() != ctx.sets[b].size()) return ctx.sets[a].size() < ctx.sets[b].size();
+        return ctx.key_table.keys[a] < ctx.key_table.keys[b];
+    });
+
+    // 若某对操作数的合并结果已在其他子表达式中算过，则从该对开始，复用已有节点
+    std::vector<std::string> scratch;
+    bool reused = false;
+    for (size_t i = 0; i < operands.size() && !reused; ++i) {
+        for (size_t j = i + 1; j < operands.size() && !reused; ++j) {
+            std::string pair_key = ctx.key_table.combinedKey(
+                expr.op, operands[i], ctx.proof.nodes[operands[i]].op,
+                operands[j], ctx.proof.nodes[operands[j]].op, scratch);
+            if (ctx.memo.count(pair_key)) {
+                int first = operands[i], second = operands[j];
+                operands.erase(operands.begin() + j);
+                operands.erase(operands.begin() + i);
+                operands.insert(operands.begin(), {first, second});
+                reused = true;
+            }
+        }
+    }
+
+    int current = operands[0];
+    for (size_t i = 1; i < operands.size(); ++i) {
+        current = combine(expr.op, current, operands[i], ctx);
+    }
+    return current;
+}
+
+int QueryEngine::combine(QueryOp op, int left, int right, PlanContext& ctx) const {
+    std::vector<std::string> flattened;
+    std::string key = ctx.key_table.combinedKey(op, left, ctx.proof.nodes[left].op,
+                                                right, ctx.proof.nodes[right].op, flattened);
+    auto cached = ctx.memo.find(key);
+    if (cached != ctx.memo.end()) return cached->second;
+
+    const std::set<int>& set_l = ctx.sets[left];
+    const std::set<int>& set_r = ctx.sets[right];
+
+    QueryProofNode node;
+    node.op = op;
+    node.left = left;
+    node.right = right;
+    node.intersection = ExpressiveAccumulator::generateIntersectionProof(set_l, set_r, trusted_setup);
+
+    std::set<int> result;
+    if (op == QueryOp::INTERSECT) {
+        result = CharacteristicPolynomial::intersection(set_l, set_r);
+        node.digest = node.intersection.intersection_digest_g1;
+    } else {
+        if (op == QueryOp::UNION) {
+            std::set_union(set_l.begin(), set_l.end(), set_r.begin(), set_r.end(),
+                           std::inserter(result, result.begin()));
+        } else {
+            std::set_difference(set_l.begin(), set_l.end(), set_r.begin(), set_r.end(),
+                                std::inserter(result, result.begin()));
+        }
+        Fr result_s = CharacteristicPolynomial(result).evaluate(trusted_setup.getSecretS());
+        G1::mul(node.digest.value, trusted_setup.getG1Generator(), result_s);
+    }
+
+    int idx = static_cast<int>(ctx.proof.nodes.size());
+    ctx.proof.nodes.push_back(node);
+    ctx.sets.push_back(std::move(result));
+    ctx.key_table.keys.push_back(key);
+    ctx.key_table.operands.push_back(std::move(flattened));
+    ctx.memo[key] = idx;
+    return idx;
+}
+
+bool QueryEngine::verify(const std::string& expression,
+                         const std::map<std::string, AccumulatorDigest>& digests,
+                         const CompositeQueryProof& proof,
+                         const ExpressiveTrustedSetup& setup) {
+    if (!proof.is_valid || proof.root < 0 || proof.root >= static_cast<int>(proof.nodes.size())) {
+        return false;
+    }
+
+    std::string expected_key;
+    try {
+        expected_key = QueryExpr::parse(expression)->canonical();
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+
+    G1 g1_gen = setup.getG1Generator();
+    G2 g2_gen = setup.getG2Generator();
+    std::vector<AccumulatorDigest> resolved(proof.nodes.size());
+    KeyTable keys;
+
+    for (size_t i = 0; i < proof.nodes.size(); ++i) {
+        const QueryProofNode& node = proof.nodes[i];
+
+        if (node.op == QueryOp::LEAF) {
+            auto it = digests.find(node.leaf_name);
+            if (it == digests.end()) return false;
+            resolved[i] = it->second; // 叶子摘要以验证者持有的输入为准
+            keys.pushLeaf(node.leaf_name);
+            continue;
+        }
+
+        if (node.left < 0 || node.right < 0 ||
+            node.left >= static_cast<int>(i) || node.right >= static_cast<int>(i)) {
+            return false;
+        }
+        const AccumulatorDigest& digest_l = resolved[node.left];
+        const AccumulatorDigest& digest_r = resolved[node.right];
+        if (!ExpressiveAccumulator::verifyIntersectionProof(digest_l, digest_r, node.intersection, setup)) {
+            return false;
+        }
+
+        GT lhs, rhs;
+        switch (node.op) {
+            case QueryOp::INTERSECT:
+                if (!(node.digest == node.intersection.intersection_digest_g1)) return false;
+                break;
+            case QueryOp::UNION:
+                // U = R · (L/I): e(U, g2) == e(R, W_QA)
+                pairing(lhs, node.digest.value, g2_gen);
+                pairing(rhs, digest_r.value, node.intersection.witness_QA_g2);
+                if (lhs != rhs) return false;
+                break;
+            case QueryOp::DIFFERENCE:
+                // D = L/I: e(D, g2) == e(g1, W_QA)
+                pairing(lhs, node.digest.value, g2_gen);
+                pairing(rhs, g1_gen, node.intersection.witness_QA_g2);
+                if (lhs != rhs) return false;
+                break;
+            default:
+                return false;
+        }
+
+        resolved[i] = node.digest;
+        keys.pushCombined(node.op, node.left, proof.nodes[node.left].op, node.right, proof.nodes[node.right].op);
+    }
+
+    // 计划必须与表达式语义一致
+    if (keys.keys[proof.root] != expected_key) return false;
+
+    // 根节点摘要必须与声明的结果集合一致
+    Fr result_s = CharacteristicPolynomial(proof.result).evaluate(setup.getSecretS());
+    G1 result_digest;
+    G1::mul(result_digest, g1_gen, result_s);
+    return resolved[proof.root].value == result_digest;
+}
+
+// ==========================================================================================
+// ThresholdQuery - 方法实现
+// ==========================================================================================
+
+ThresholdQueryProof ThresholdQuery::generate(const std::vector<const ExpressiveAccumulator*>& accs,
+                                             size_t threshold,
+                                             const ExpressiveTrustedSetup& setup) {
+    ThresholdQueryProof proof;
+    proof.threshold = threshold;
+    if (threshold == 0 || threshold > accs.size()) {
+        return proof;
+    }
+
+    // 1. 统计每个元素出现的集合数，得到结果集合
+    std::map<int, size_t> counts;
+    for (const ExpressiveAccumulator* acc : accs) {
+        for (int el : acc->getElements()) {
+            ++counts[el];
+        }
+    }
+    for (const auto& entry : counts) {
+        if (entry.second >= threshold) {
+            proof.result.insert(entry.first);
+        }
+    }
+
+    // 2. 每个集合的子集 S_i 与见证 W_i = g2^{(A_i \ S_i)(s)}
+    const Fr& secret_s = setup.getSecretS();
+    proof.subsets.resize(accs.size());
+    proof.witnesses.resize(accs.size());
+    for (size_t i = 0; i < accs.size(); ++i) {
+        const std::set<int>& elements = accs[i]->getElements();
+        proof.subsets[i] = CharacteristicPolynomial::intersection(elements, proof.result);
+
+        std::set<int> remainder;
+        std::set_difference(elements.begin(), elements.end(),
+                            proof.subsets[i].begin(), proof.subsets[i].end(),
+                            std::inserter(remainder, remainder.begin()));
+        Fr witness_s = CharacteristicPolynomial(remainder).evaluate(secret_s);
+        G2::mul(proof.witnesses[i], setup.getG2Generator(), witness_s);
+    }
+    // 见证一起规范化，序列化时不再逐个求逆
+    BatchInversion::normalizePoints(proof.witnesses);
+
+    proof.is_valid = true;
+    return proof;
+}
+
+bool ThresholdQuery::verify(const std::vector<AccumulatorDigest>& digests,
+                            const ThresholdQueryProof& proof,
+                            const ExpressiveTrustedSetup& setup) {
+    const size_t k = digests.size();
+    if (!proof.is_valid || proof.threshold == 0 || proof.threshold > k ||
+        proof.subsets.size() != k || proof.witnesses.size() != k) {
+        return false;
+    }
+
+    // 1. 组合检查：S_i ⊆ R，且 R 中每个元素至少出现在 threshold 个 S_i 中
+    std::map<int, size_t> counts;
+    for (const std::set<int>& subset : proof.subsets) {
+        for (int el : subset) {
+            if (!proof.result.count(el)) return false;
+            ++counts[el];
+        }
+    }
+    for (int el : proof.result) {
+        if (counts[el] < proof.threshold) return false;
+    }
+
+    // 2. 随机线性组合后的配对检查：e(Σ ρ_i·A_i, g2) == e(g1, Σ ρ_i·S_i(s)·W_i)
+    std::vector<Fr> rho = challenges(digests, proof);
+    const Fr& secret_s = setup.getSecretS();
+    std::vector<G1> digest_points(k);
+    std::vector<Fr> witness_scalars(k);
+    for (size_t i = 0; i < k; ++i) {
+        digest_points[i] = digests[i].value;
+        witness_scalars[i] = rho[i] * CharacteristicPolynomial(proof.subsets[i]).evaluate(secret_s);
+    }
+
+    G1 combined_digest;
+    G2 combined_witness;
+    G1::mulVec(combined_digest, digest_points.data(), rho.data(), k);
+    G2::mulVec(combined_witness, proof.witnesses.data(), witness_scalars.data(), k);
+
+    GT lhs, rhs;
+    pairing(lhs, combined_digest, setup.getG2Generator());
+    pairing(rhs, setup.getG1Generator(), combined_witness);
+    return lhs == rhs;
+}
+
+std::vector<Fr> ThresholdQuery::challenges(const std::vector<AccumulatorDigest>& digests,
+                                           const ThresholdQueryProof& proof) {
+    std::string transcript;
+    const std::vector<std::string> witnesses =
+        BatchInversion::serializePoints(proof.witnesses.data(), proof.witnesses.size());
+    for (size_t i = 0; i < proof.subsets.size(); ++i) {
+        transcript += "/" + std::to_string(i) + ":";
+        for (int el : proof.subsets[i]) {
+            transcript += std::to_string(el) + ",";
+        }
+        transcript += witnesses[i];
+    }
+    return fiatShamirChallenges("threshold_query/" + std::to_string(proof.threshold), digests, transcript);
+}
+
+} // namespace expressive_accumulator
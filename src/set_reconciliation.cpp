@@ -0,0 +1,201 @@
+/**
+ * @file set_reconciliation.cpp
+ * @brief 基于特征多项式采样值的集合协调实现。
+ */
+#include "set_reconciliation.h"
+#include <algorithm>
+#include <climits>
+#include <string>
+
+namespace expressive_accumulator {
+
+using FrPolynomial::Poly;
+
+namespace {
+
+// 将域元素映射回 int 元素，超出 int 范围（即不是合法元素）时返回 false
+bool toElement(const Fr& x, int& element) {
+    const std::string pos = x.getStr(10);
+    if (pos.size() <= 10) {
+        long long v = std::stoll(pos);
+        if (v <= INT_MAX) {
+            element = static_cast<int>(v);
+            return true;
+        }
+    }
+    const std::string neg = (-x).getStr(10);
+    if (neg.size() <= 10) {
+        long long v = std::stoll(neg);
+        if (v <= -static_cast<long long>(INT_MIN)) {
+            element = static_cast<int>(-v);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 求根并映射为元素集合，要求多项式恰好分裂为互异的一次因式
+bool rootsToElements(const Poly& p, std::set<int>& out) {
+    std::vector<Fr> roots;
+    if (!FrPolynomial::findRoots(roots, p)) return false;
+    for (const Fr& r : roots) {
+        int element;
+        if (!toElement(r, element)) return false;
+        out.insert(element);
+    }
+    return out.size() == roots.size();
+}
+
+} // namespace
+
+Fr SetReconciliation::samplePoint(size_t j) {
+    Fr z;
+    z.setHashOf("set_reconciliation/" + std::to_string(j));
+    return z;
+}
+
+ReconciliationSketch SetReconciliation::makeSketch(const ExpressiveAccumulator& acc, size_t max_difference) {
+    ReconciliationSketch sketch;
+    sketch.set_size = acc.getElements().size();
+    std::vector<Fr> points(max_difference + 1);
+    for (size_t j = 0; j < points.size(); ++j) {
+        points[j] = samplePoint(j);
+    }
+    sketch.evaluations = acc.getPolynomial().multiEvaluate(points);
+    return sketch;
+}
+
+/**
+ * @brief 解线性方程组 N(z_j) - f_j·D(z_j) = 0，N、D 首一且次数分别为 deg_num、deg_den。
+ * @details 未知量为 N、D 的低次系数，共 t = deg_num + deg_den 个，使用前 t 个采样点。
+ *          真实对称差小于 t 时方程组欠定，自由变量取 0 得到的任一解与真实解
+ *          相差一个公因式，由调用方约去。
+ */
+bool SetReconciliation::interpolate(Poly& numerator,
+                                    Poly& denominator,
+                                    const std::vector<Fr>& points,
+                                    const std::vector<Fr>& ratios,
+                                    size_t deg_num, size_t deg_den) {
+    const size_t t = deg_num + deg_den;
+    // 增广矩阵：列 [0, deg_num) 对应 n_i，列 [deg_num, t) 对应 d_i，最后一列为常数项
+    // Fr 的默认构造不清零，矩阵必须显式以 Fr(0) 填充，消元才不会读到未初始化的值
+    std::vector<std::vector<Fr>> m(t, std::vector<Fr>(t + 1, Fr(0)));
+    for (size_t row = 0; row < t; ++row) {
+        const Fr& z = points[row];
+        const Fr& f = ratios[row];
+        Fr power = 1;
+        for (size_t i = 0; i < std::max(deg_num, deg_den); ++i) {
+            if (i < deg_num) m[row][i] = power;
+            if (i < deg_den) m[row][deg_num + i] = -(f * power);
+            power *= z;
+        }
+        // 右端：f·z^{deg_den} - z^{deg_num}
+        Fr z_num, z_den;
+        Fr::pow(z_num, z, deg_num);
+        Fr::pow(z_den, z, deg_den);
+        m[row][t] = f * z_den - z_num;
+    }
+
+    // 高斯消元，记录每行的主元列
+    std::vector<long> pivot_col(t, -1);
+    size_t rank = 0;
+    for (size_t col = 0; col < t && rank < t; ++col) {
+        size_t sel = rank;
+        while (sel < t && m[sel][col].isZero()) ++sel;
+        if (sel == t) continue;
+        std::swap(m[sel], m[rank]);
+        Fr inv;
+        Fr::inv(inv, m[rank][col]);
+        for (size_t k = col; k <= t; ++k) m[rank][k] *= inv;
+        for (size_t r = 0; r < t; ++r) {
+            if (r == rank || m[r][col].isZero()) continue;
+            Fr c = m[r][col];
+            for (size_t k = col; k <= t; ++k) m[r][k] -= c * m[rank][k];
+        }
+        pivot_col[rank] = static_cast<long>(col);
+        ++rank;
+    }
+    // 零行右端非零说明方程组无解
+    for (size_t r = rank; r < t; ++r) {
+        if (!m[r][t].isZero()) return false;
+    }
+
+    std::vector<Fr> x(t, Fr(0));
+    for (size_t r = 0; r < rank; ++r) {
+        x[pivot_col[r]] = m[r][t];
+    }
+    numerator.assign(x.begin(), x.begin() + deg_num);
+    numerator.push_back(Fr(1));
+    denominator.assign(x.begin() + deg_num, x.end());
+    denominator.push_back(Fr(1));
+    return true;
+}
+
+ReconciliationResult SetReconciliation::reconcile(const ExpressiveAccumulator& local,
+                                                  const ReconciliationSketch& remote_sketch,
+                                                  const AccumulatorDigest& remote_digest,
+                                                  const ExpressiveTrustedSetup& setup) {
+    ReconciliationResult result;
+    const std::set<int>& local_set = local.getElements();
+    const size_t m = remote_sketch.evaluations.size();
+    const long delta = static_cast<long>(remote_sketch.set_size) - static_cast<long>(local_set.size());
+    const size_t abs_delta = static_cast<size_t>(delta < 0 ? -delta : delta);
+    if (abs_delta > m) return result;
+
+    // 取不超过 m、与 delta 同奇偶的最大 t 作为对称差上界
+    size_t t = m;
+    if ((t - abs_delta) % 2 != 0) --t;
+    const size_t deg_num = static_cast<size_t>((static_cast<long>(t) + delta) / 2);
+    const size_t deg_den = static_cast<size_t>((static_cast<long>(t) - delta) / 2);
+
+    // f_j = P_remote(z_j) / P_local(z_j)
+    std::vector<Fr> points(m), ratios(m);
+    for (size_t j = 0; j < m; ++j) {
+        points[j] = samplePoint(j);
+    }
+    std::vector<Fr> local_evals = local.getPolynomial().multiEvaluate(points);
+    for (size_t j = 0; j < m; ++j) {
+        if (local_evals[j].isZero()) return result;
+        ratios[j] = remote_sketch.evaluations[j] / local_evals[j];
+    }
+
+    Poly numerator, denominator;
+    if (!interpolate(numerator, denominator, points, ratios, deg_num, deg_den)) {
+        return result;
+    }
+
+    // 约去公因式，得到 N = P(B\A)、D = P(A\B)
+    Poly common = FrPolynomial::gcd(numerator, denominator);
+    if (!FrPolynomial::isOne(common)) {
+        Poly rem;
+        FrPolynomial::divRem(numerator, rem, Poly(numerator), common);
+        FrPolynomial::divRem(denominator, rem, Poly(denominator), common);
+    }
+
+    if (!rootsToElements(numerator, result.remote_only) ||
+        !rootsToElements(denominator, result.local_only)) {
+        result.remote_only.clear();
+        result.local_only.clear();
+        return result;
+    }
+
+    // local_only ⊆ A，remote_only ∩ A = ∅
+    result.remote_elements = local_set;
+    for (int e : result.local_only) {
+        if (result.remote_elements.erase(e) == 0) return result;
+    }
+    for (int e : result.remote_only) {
+        if (!result.remote_elements.insert(e).second) return result;
+    }
+    if (result.remote_elements.size() != remote_sketch.set_size) return result;
+
+    // 核对摘要：g1^{P_A(s)·N(s)/D(s)} == 对端摘要
+    const Fr& s = setup.getSecretS();
+    Fr ratio_s = FrPolynomial::evaluate(numerator, s) / FrPolynomial::evaluate(denominator, s);
+    G1 expected;
+    G1::mul(expected, local.getDigest().value, ratio_s);
+    result.success = (expected == remote_digest.value);
+    return result;
+}
+
+} // namespace expressive_accumulator
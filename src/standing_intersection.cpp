@@ -0,0 +1,164 @@
+/**
+ * @file standing_intersection.cpp
+ * @brief 常驻交集查询的增量维护实现。
+ * @details 维护不变式 a·Q_A + b·Q_B = 1。单元素更新只会让 Q_A 或 Q_B
+ *          乘上或除去一个线性因子 (z - x)，贝祖系数可通过一次综合除法
+ *          和一次常数倍修正恢复，不需要重新运行扩展欧几里得算法。
+ */
+#include "standing_intersection.h"
+#include <algorithm>
+#include <iterator>
+
+namespace expressive_accumulator {
+
+using FrPolynomial::Poly;
+
+StandingIntersectionQuery::StandingIntersectionQuery(
+    const ExpressiveAccumulator& acc_a,
+    const ExpressiveAccumulator& acc_b,
+    const ExpressiveTrustedSetup& setup)
+    : trusted_setup(setup), digest_a(acc_a.getDigest()), digest_b(acc_b.getDigest()) {
+    const std::set<int>& set_a = acc_a.getElements();
+    const std::set<int>& set_b = acc_b.getElements();
+
+    intersection_set = CharacteristicPolynomial::intersection(set_a, set_b);
+    std::set_difference(set_a.begin(), set_a.end(), intersection_set.begin(), intersection_set.end(),
+                        std::inserter(diff_a, diff_a.begin()));
+    std::set_difference(set_b.begin(), set_b.end(), intersection_set.begin(), intersection_set.end(),
+                        std::inserter(diff_b, diff_b.begin()));
+
+    poly_qa = FrPolynomial::fromRoots(diff_a);
+    poly_qb = FrPolynomial::fromRoots(diff_b);
+
+    // 只在构造时运行一次 xgcd，此后全部增量维护
+    Poly gcd;
+    FrPolynomial::xgcd(gcd, bezout_a, bezout_b, poly_qa, poly_qb);
+
+    intersection_s = CharacteristicPolynomial(intersection_set).evaluate(trusted_setup.getSecretS());
+
+    if (!FrPolynomial::isOne(gcd)) {
+        proof.is_valid = false;
+        return;
+    }
+    refreshProof();
+}
+
+bool StandingIntersectionQuery::applyUpdate(QuerySide side, const UpdateProof& update) {
+    if (!(update.old_digest == getDigest(side))) return false;
+    if (!ExpressiveAccumulator::verifyUpdateProof(update, trusted_setup)) return false;
+
+    if (update.op_type == UpdateOperation::ADD) {
+        addElement(side, update.element);
+    } else {
+        deleteElement(side, update.element);
+    }
+    return true;
+}
+
+void StandingIntersectionQuery::addElement(QuerySide side, int element) {
+    std::set<int>& own_diff = (side == QuerySide::A) ? diff_a : diff_b;
+    std::set<int>& other_diff = (side == QuerySide::A) ? diff_b : diff_a;
+    Poly& own_q = (side == QuerySide::A) ? poly_qa : poly_qb;
+    Poly& own_u = (side == QuerySide::A) ? bezout_a : bezout_b;
+    Poly& other_q = (side == QuerySide::A) ? poly_qb : poly_qa;
+    Poly& other_u = (side == QuerySide::A) ? bezout_b : bezout_a;
+
+    if (intersection_set.count(element) || own_diff.count(element)) {
+        return; // 元素已存在，集合不变
+    }
+
+    Fr x = element;
+    if (other_diff.count(element)) {
+        // x 从另一侧的差集移入交集：I 乘上 (z - x)，另一侧的商多项式除去 (z - x)
+        other_diff.erase(element);
+        intersection_set.insert(element);
+        removeRoot(other_q, other_u, own_q, own_u, x);
+        intersection_s *= (trusted_setup.getSecretS() - x);
+    } else {
+        own_diff.insert(element);
+        addRoot(own_q, own_u, other_q, other_u, x);
+    }
+    refreshProof();
+    refreshDigest(side);
+}
+
+void StandingIntersectionQuery::deleteElement(QuerySide side, int element) {
+    std::set<int>& own_diff = (side == QuerySide::A) ? diff_a : diff_b;
+    std::set<int>& other_diff = (side == QuerySide::A) ? diff_b : diff_a;
+    Poly& own_q = (side == QuerySide::A) ? poly_qa : poly_qb;
+    Poly& own_u = (side == QuerySide::A) ? bezout_a : bezout_b;
+    Poly& other_q = (side == QuerySide::A) ? poly_qb : poly_qa;
+    Poly& other_u = (side == QuerySide::A) ? bezout_b : bezout_a;
+
+    Fr x = element;
+    if (own_diff.count(element)) {
+        own_diff.erase(element);
+        removeRoot(own_q, own_u, other_q, other_u, x);
+    } else if (intersection_set.count(element)) {
+        // x 离开交集，成为另一侧差集的元素
+        intersection_set.erase(element);
+        other_diff.insert(element);
+        addRoot(other_q, other_u, own_q, own_u, x);
+        intersection_s /= (trusted_setup.getSecretS() - x);
+    } else {
+        return; // 元素不存在，集合不变
+    }
+    refreshProof();
+    refreshDigest(side);
+}
+
+/**
+ * @brief 向 p 添加根 x 并修正贝祖系数。
+ * @details 取 k = -u(x) / q(x)，则 u + k·q 在 x 处为零，
+ *          令 u' = (u + k·q) / (z - x)，v' = v - k·p，有
+ *          u'·p·(z - x) + v'·q = u·p + v·q = 1，且 deg u' < deg q 保持不变。
+ *          q(x) ≠ 0 由 p、q 互素保证。
+ */
+void StandingIntersectionQuery::addRoot(Poly& p, Poly& u, const Poly& q, Poly& v, const Fr& x) {
+    Fr k = -FrPolynomial::evaluate(u, x) / FrPolynomial::evaluate(q, x);
+    Poly shifted = FrPolynomial::add(u, FrPolynomial::scale(q, k));
+    FrPolynomial::divLinear(shifted, x);
+    v = FrPolynomial::sub(v, FrPolynomial::scale(p, k));
+    u.swap(shifted);
+    FrPolynomial::mulLinear(p, x);
+}
+
+/**
+ * @brief 从 p 中除去根 x 并修正贝祖系数。
+ * @details 令 p' = p / (z - x)，则 u·(z - x)·p' + v·q = 1。u·(z - x) 的次数
+ *          至多为 deg q，减去其对首一多项式 q 的常数倍商 c 即得
+ *          u' = u·(z - x) - c·q，v' = v + c·p'，次数约束随之恢复。
+ */
+void StandingIntersectionQuery::removeRoot(Poly& p, Poly& u, const Poly& q, Poly& v, const Fr& x) {
+    FrPolynomial::divLinear(p, x);
+    FrPolynomial::mulLinear(u, x);
+
+    const size_t deg_q = q.size() - 1;
+    if (u.size() > deg_q) {
+        Fr c = u[deg_q];
+        u = FrPolynomial::sub(u, FrPolynomial::scale(q, c));
+        v = FrPolynomial::add(v, FrPolynomial::scale(p, c));
+    }
+}
+
+void StandingIntersectionQuery::refreshProof() {
+    const Fr& s = trusted_setup.getSecretS();
+    G1 g1_gen = trusted_setup.getG1Generator();
+    G2 g2_gen = trusted_setup.getG2Generator();
+
+    G1::mul(proof.intersection_digest_g1.value, g1_gen, intersection_s);
+    G2::mul(proof.witness_QA_g2, g2_gen, FrPolynomial::evaluate(poly_qa, s));
+    G2::mul(proof.witness_QB_g2, g2_gen, FrPolynomial::evaluate(poly_qb, s));
+    G1::mul(proof.witness_a_g1, g1_gen, FrPolynomial::evaluate(bezout_a, s));
+    G1::mul(proof.witness_b_g1, g1_gen, FrPolynomial::evaluate(bezout_b, s));
+    proof.is_valid = true;
+}
+
+void StandingIntersectionQuery::refreshDigest(QuerySide side) {
+    const Poly& own_q = (side == QuerySide::A) ? poly_qa : poly_qb;
+    AccumulatorDigest& digest = (side == QuerySide::A) ? digest_a : digest_b;
+    Fr set_s = intersection_s * FrPolynomial::evaluate(own_q, trusted_setup.getSecretS());
+    G1::mul(digest.value, trusted_setup.getG1Generator(), set_s);
+}
+
+} // namespace expressive_accumulator
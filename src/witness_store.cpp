@@ -0,0 +1,276 @@
+/**
+ * @file witness_store.cpp
+ * @brief 冻结成员证明库的写出（最小完美哈希排布）与内存映射查询。
+ */
+#include "witness_store.h"
+#include "binary_codec.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace expressive_accumulator {
+
+namespace {
+
+const char MAGIC[8] = {'E', 'A', 'W', 'S', 'T', 'O', 'R', '2'};
+const size_t HEADER_BYTES = 64;
+const size_t FP_BYTES = 48;
+// int32 元素、1 字节无穷远标志、3 字节填充、四个坐标
+const size_t RECORD_BYTES = 8 + 4 * FP_BYTES;
+const size_t MAX_DIGEST_BYTES = 1024;
+// 平均每个桶的元素数
+const size_t KEYS_PER_BUCKET = 3;
+// 单个桶尝试的位移数上限，超过后换种子重建
+const uint32_t MAX_DISPLACEMENT = 1u << 22;
+const uint64_t MAX_SEEDS = 16;
+// 写出时每次缓冲的记录数
+const size_t WRITE_BATCH = 4096;
+
+using BinaryCodec::pad8;
+using BinaryCodec::readLE;
+using BinaryCodec::writeLE;
+
+// splitmix64 的最终混合，双射
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+size_t bucketOf(int element, uint64_t seed, size_t bucket_count) {
+    return static_cast<size_t>(mix(static_cast<uint32_t>(element) ^ seed) % bucket_count);
+}
+
+size_t slotOf(int element, uint64_t seed, uint32_t displacement, size_t count) {
+    const uint64_t key = static_cast<uint32_t>(element) | (static_cast<uint64_t>(displacement) << 32);
+    return static_cast<size_t>(mix(key ^ seed ^ 0x5851F42D4C957F2DULL) % count);
+}
+
+/**
+ * @brief hash-and-displace 构造：从最大的桶开始，为每个桶找到使其元素全部落入空槽位的位移。
+ * @return 某个桶在 MAX_DISPLACEMENT 次尝试内找不到位移时返回 false。
+ */
+bool buildPerfectHash(const std::vector<int>& keys, uint64_t seed, size_t bucket_count,
+                      std::vector<uint32_t>& displacements, std::vector<size_t>& slots) {
+    const size_t n = keys.size();
+    std::vector<std::vector<size_t>> buckets(bucket_count);
+    for (size_t i = 0; i < n; ++i) buckets[bucketOf(keys[i], seed, bucket_count)].push_back(i);
+    std::vector<size_t> order(bucket_count);
+    for (size_t b = 0; b < bucket_count; ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    displacements.assign(bucket_count, 0);
+    slots.assign(n, 0);
+    std::vector<uint8_t> taken(n, 0);
+    std::vector<size_t> candidate;
+    for (size_t b : order) {
+        const std::vector<size_t>& members = buckets[b];
+        if (members.empty()) break;
+        bool placed = false;
+        for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+            candidate.clear();
+            placed = true;
+            for (size_t i : members) {
+                size_t slot = slotOf(keys[i], seed, d, n);
+                if (taken[slot] || std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                    placed = false;
+                    break;
+                }
+                candidate.push_back(slot);
+            }
+            if (placed) {
+                displacements[b] = d;
+                for (size_t k = 0; k < members.size(); ++k) {
+                    slots[members[k]] = candidate[k];
+                    taken[candidate[k]] = 1;
+                }
+            }
+        }
+        if (!placed) return false;
+    }
+    return true;
+}
+
+void encodeRecord(uint8_t* out, int element, const G2& witness) {
+    std::memset(out, 0, RECORD_BYTES);
+    writeLE<uint32_t>(out, static_cast<uint32_t>(element));
+    if (witness.isZero()) {
+        out[4] = 1;
+        return;
+    }
+    G2 P = witness;
+    P.normalize();
+    const Fp* coords[4] = {&P.x.a, &P.x.b, &P.y.a, &P.y.b};
+    for (size_t k = 0; k < 4; ++k) {
+        if (coords[k]->serialize(out + 8 + k * FP_BYTES, FP_BYTES) != FP_BYTES) {
+            throw std::runtime_error("WitnessStore: coordinate serialization failed");
+        }
+    }
+}
+
+} // namespace
+
+// ==========================================================================================
+// WitnessStore - 冻结
+// ==========================================================================================
+
+size_t WitnessStore::freeze(const ExpressiveAccumulator& acc, const std::string& path, size_t num_threads) {
+    const std::vector<int> elements(acc.getElements().begin(), acc.getElements().end());
+    const size_t n = elements.size();
+
+    // 1. 最小完美哈希：n 个元素恰好占满 n 个槽位
+    const size_t bucket_count = std::max<size_t>(1, (n + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET);
+    std::vector<uint32_t> displacements;
+    std::vector<size_t> slots;
+    uint64_t seed = 0;
+    while (!buildPerfectHash(elements, mix(seed), bucket_count, displacements, slots)) {
+        if (++seed == MAX_SEEDS) {
+            throw std::runtime_error("WitnessStore: perfect hash construction failed");
+        }
+    }
+    seed = mix(seed);
+
+    // 2. 全部成员的见证（批量求逆、批量规范化）
+    std::vector<MembershipProof> proofs = acc.generateMembershipProofs(elements, num_threads);
+    std::vector<size_t> member_at(n);
+    for (size_t i = 0; i < n; ++i) member_at[slots[i]] = i;
+
+    // 3. 写入临时文件后改名
+    const std::string digest = acc.getDigest().serialize();
+    if (digest.size() > MAX_DIGEST_BYTES) {
+        throw std::runtime_error("WitnessStore: digest encoding too large");
+    }
+    const std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("WitnessStore: cannot create " + tmp_path);
+    }
+
+    std::vector<uint8_t> header(HEADER_BYTES, 0);
+    std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+    writeLE<uint64_t>(header.data() + 8, n);
+    writeLE<uint64_t>(header.data() + 16, bucket_count);
+    writeLE<uint64_t>(header.data() + 24, seed);
+    writeLE<uint32_t>(header.data() + 32, static_cast<uint32_t>(RECORD_BYTES));
+    writeLE<uint32_t>(header.data() + 36, static_cast<uint32_t>(digest.size()));
+    out.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    // 头部之后的全部字节计入 CRC，写完后回填到头部
+    uint32_t crc = 0;
+    std::vector<uint8_t> section(pad8(digest.size()), 0);
+    std::memcpy(section.data(), digest.data(), digest.size());
+    out.write(reinterpret_cast<const char*>(section.data()), section.size());
+    crc = BinaryCodec::crc32(section.data(), section.size(), crc);
+
+    section.assign(pad8(4 * bucket_count), 0);
+    for (size_t b = 0; b < bucket_count; ++b) writeLE<uint32_t>(section.data() + 4 * b, displacements[b]);
+    out.write(reinterpret_cast<const char*>(section.data()), section.size());
+    crc = BinaryCodec::crc32(section.data(), section.size(), crc);
+
+    std::vector<uint8_t> block(WRITE_BATCH * RECORD_BYTES);
+    for (size_t begin = 0; begin < n; begin += WRITE_BATCH) {
+        const size_t end = std::min(n, begin + WRITE_BATCH);
+        for (size_t slot = begin; slot < end; ++slot) {
+            const size_t i = member_at[slot];
+            encodeRecord(block.data() + (slot - begin) * RECORD_BYTES, elements[i], proofs[i].witness_g2);
+        }
+        out.write(reinterpret_cast<const char*>(block.data()), (end - begin) * RECORD_BYTES);
+        crc = BinaryCodec::crc32(block.data(), (end - begin) * RECORD_BYTES, crc);
+    }
+    uint8_t crc_bytes[4];
+    writeLE<uint32_t>(crc_bytes, crc);
+    out.seekp(40);
+    out.write(reinterpret_cast<const char*>(crc_bytes), sizeof(crc_bytes));
+    out.close();
+    if (!out) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("WitnessStore: write failed for " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("WitnessStore: cannot rename " + tmp_path + " to " + path);
+    }
+    return n;
+}
+
+// ==========================================================================================
+// WitnessStore - 查询
+// ==========================================================================================
+
+WitnessStore::WitnessStore(const std::string& path)
+    : file_(path), count_(0), bucket_count_(0), seed_(0), displacements_(nullptr), records_(nullptr) {
+    try {
+        const uint8_t* header = file_.range(0, HEADER_BYTES);
+        if (std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("WitnessStore: " + path + " is not a witness store");
+        }
+        const uint64_t count = readLE<uint64_t>(header + 8);
+        const uint64_t bucket_count = readLE<uint64_t>(header + 16);
+        seed_ = readLE<uint64_t>(header + 24);
+        const uint32_t record_bytes = readLE<uint32_t>(header + 32);
+        const uint32_t digest_bytes = readLE<uint32_t>(header + 36);
+        if (record_bytes != RECORD_BYTES || digest_bytes > MAX_DIGEST_BYTES || bucket_count == 0 ||
+            count > file_.size() / RECORD_BYTES || bucket_count > file_.size() / 4) {
+            throw std::runtime_error("WitnessStore: unsupported or corrupted header in " + path);
+        }
+        count_ = static_cast<size_t>(count);
+        bucket_count_ = static_cast<size_t>(bucket_count);
+
+        size_t offset = HEADER_BYTES;
+        const uint8_t* digest = file_.range(offset, digest_bytes);
+        digest_.deserialize(std::string(reinterpret_cast<const char*>(digest), digest_bytes));
+        offset += pad8(digest_bytes);
+        displacements_ = file_.range(offset, 4 * bucket_count_);
+        offset += pad8(4 * bucket_count_);
+        records_ = file_.range(offset, count_ * RECORD_BYTES);
+        if (offset + count_ * RECORD_BYTES != file_.size()) {
+            throw std::runtime_error("WitnessStore: unexpected trailing data in " + path);
+        }
+        // 打开时一次性校验完整性，此后查询只做探测与拷贝
+        if (BinaryCodec::crc32(file_.range(HEADER_BYTES, file_.size() - HEADER_BYTES), file_.size() - HEADER_BYTES) !=
+            readLE<uint32_t>(header + 40)) {
+            throw std::runtime_error("WitnessStore: checksum mismatch in " + path);
+        }
+    } catch (const std::out_of_range&) {
+        throw std::runtime_error("WitnessStore: " + path + " is truncated");
+    }
+}
+
+const uint8_t* WitnessStore::record(size_t slot) const {
+    return records_ + slot * RECORD_BYTES;
+}
+
+bool WitnessStore::lookup(int element, MembershipProof& proof) const {
+    if (count_ == 0) return false;
+    const size_t bucket = bucketOf(element, seed_, bucket_count_);
+    const uint32_t displacement = readLE<uint32_t>(displacements_ + 4 * bucket);
+    const uint8_t* r = record(slotOf(element, seed_, displacement, count_));
+    // 非成员也会落到某个槽位，以记录中的元素区分
+    if (static_cast<int>(readLE<uint32_t>(r)) != element) return false;
+
+    G2 witness;
+    if (r[4] > 1) {
+        throw std::runtime_error("WitnessStore: corrupted witness record");
+    }
+    if (r[4]) {
+        witness.clear();
+    } else {
+        Fp* coords[4] = {&witness.x.a, &witness.x.b, &witness.y.a, &witness.y.b};
+        for (size_t k = 0; k < 4; ++k) {
+            if (coords[k]->deserialize(r + 8 + k * FP_BYTES, FP_BYTES) == 0) {
+                throw std::runtime_error("WitnessStore: corrupted witness record");
+            }
+        }
+        witness.z = 1;
+    }
+    proof.witness_g2 = witness;
+    proof.is_member = true;
+    return true;
+}
+
+} // namespace expressive_accumulator
@@ -0,0 +1,562 @@
+/**
+ * @file write_ahead_log.cpp
+ * @brief 累加器预写日志：组提交、增量检查点与批量回放恢复。
+ */
+#include "write_ahead_log.h"
+#include "binary_codec.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace expressive_accumulator {
+
+namespace {
+
+using BinaryCodec::readLE;
+using BinaryCodec::writeLE;
+
+/*
+ * wal.log（小端）：
+ *   头部 16 字节：魔数 "EAWAL001"、基准序号（该日志之前最后一个检查点的序号）；
+ *   记录：uint32 载荷长度、uint32 载荷 CRC-32、载荷。
+ *   载荷：uint64 序号、uint8 操作 (0 添加 / 1 删除)、uint8 标志、2 字节保留、int32 元素；
+ *         标志含 FLAG_PROOF 时随后是 uint8 is_valid、uint8 is_member，
+ *         以及旧摘要、新摘要、删除见证的 IoSerialize 字节，各以 uint16 长度前缀。
+ *
+ * checkpoint.delta（小端）：
+ *   魔数 "EAWDELT1"、uint64 检查点序号、uint64 添加数、uint64 删除数、uint64 变长整数区字节数；
+ *   升序的添加元素与删除元素，各以 uint32 的变长整数编码；
+ *   之前全部字节的 uint32 CRC-32。
+ */
+const char LOG_MAGIC[8] = {'E', 'A', 'W', 'A', 'L', '0', '0', '1'};
+const char DELTA_MAGIC[8] = {'E', 'A', 'W', 'D', 'E', 'L', 'T', '1'};
+const size_t LOG_HEADER_BYTES = 16;
+const size_t FRAME_BYTES = 8;
+const size_t RECORD_FIXED_BYTES = 16;
+const size_t DELTA_HEADER_BYTES = 40;
+const size_t MAX_RECORD_BYTES = 4096;
+const uint8_t FLAG_PROOF = 1;
+
+const char* STATE_FILE = "/checkpoint.state";
+const char* DELTA_FILE = "/checkpoint.delta";
+const char* LOG_FILE = "/wal.log";
+
+std::runtime_error walError(const std::string& what) {
+    return std::runtime_error("WriteAheadLog: " + what);
+}
+
+bool fileExists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+bool dataSync(int fd) {
+#ifdef __linux__
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+void syncPath(const std::string& path, bool directory) {
+    const int fd = ::open(path.c_str(), directory ? O_RDONLY | O_DIRECTORY : O_RDONLY);
+    if (fd < 0) {
+        throw walError("cannot open " + path + " for sync");
+    }
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok) {
+        throw walError("fsync failed for " + path);
+    }
+}
+
+// 写入 path.tmp、落盘后改名，再让目录项落盘
+void writeFileAtomically(const std::string& dir, const std::string& path, const std::vector<uint8_t>& bytes,
+                         bool sync) {
+    const std::string tmp_path = path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw walError("cannot create " + tmp_path);
+    }
+    const bool ok = writeAll(fd, bytes.data(), bytes.size()) && (!sync || ::fsync(fd) == 0);
+    ::close(fd);
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw walError("write failed for " + path);
+    }
+    if (sync) syncPath(dir, true);
+}
+
+void putString(std::vector<uint8_t>& out, const std::string& s) {
+    if (s.size() > UINT16_MAX) {
+        throw walError("proof field too large");
+    }
+    uint8_t len[2];
+    writeLE<uint16_t>(len, static_cast<uint16_t>(s.size()));
+    out.insert(out.end(), len, len + 2);
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+bool getString(const uint8_t*& p, const uint8_t* end, std::string& s) {
+    if (end - p < 2) return false;
+    const size_t len = readLE<uint16_t>(p);
+    p += 2;
+    if (static_cast<size_t>(end - p) < len) return false;
+    s.assign(reinterpret_cast<const char*>(p), len);
+    p += len;
+    return true;
+}
+
+void encodeRecord(std::vector<uint8_t>& out, uint64_t lsn, UpdateOperation op, int element,
+                  const UpdateProof* proof) {
+    std::vector<uint8_t> payload(RECORD_FIXED_BYTES, 0);
+    writeLE<uint64_t>(payload.data(), lsn);
+    payload[8] = op == UpdateOperation::ADD ? 0 : 1;
+    payload[9] = proof != nullptr ? FLAG_PROOF : 0;
+    writeLE<uint32_t>(payload.data() + 12, static_cast<uint32_t>(element));
+    if (proof != nullptr) {
+        payload.push_back(proof->is_valid ? 1 : 0);
+        payload.push_back(proof->membership_proof.is_member ? 1 : 0);
+        putString(payload, proof->old_digest.serialize());
+        putString(payload, proof->new_digest.serialize());
+        putString(payload, proof->membership_proof.witness_g2.getStr(mcl::IoSerialize));
+    }
+    uint8_t frame[FRAME_BYTES];
+    writeLE<uint32_t>(frame, static_cast<uint32_t>(payload.size()));
+    writeLE<uint32_t>(frame + 4, BinaryCodec::crc32(payload.data(), payload.size()));
+    out.insert(out.end(), frame, frame + FRAME_BYTES);
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+bool decodeRecord(const uint8_t* p, size_t size, WalRecord& record) {
+    if (size < RECORD_FIXED_BYTES || p[8] > 1 || (p[9] & ~FLAG_PROOF) != 0) return false;
+    const uint8_t* end = p + size;
+    record.lsn = readLE<uint64_t>(p);
+    record.op = p[8] == 0 ? UpdateOperation::ADD : UpdateOperation::DELETE;
+    record.element = static_cast<int>(readLE<uint32_t>(p + 12));
+    record.has_proof = (p[9] & FLAG_PROOF) != 0;
+    p += RECORD_FIXED_BYTES;
+    if (!record.has_proof) return p == end;
+
+    UpdateProof& proof = record.proof;
+    std::string old_digest, new_digest, witness;
+    if (end - p < 2) return false;
+    proof.is_valid = p[0] != 0;
+    proof.membership_proof.is_member = p[1] != 0;
+    p += 2;
+    if (!getString(p, end, old_digest) || !getString(p, end, new_digest) || !getString(p, end, witness) || p != end) {
+        return false;
+    }
+    try {
+        proof.old_digest.deserialize(old_digest);
+        proof.new_digest.deserialize(new_digest);
+        proof.membership_proof.witness_g2.setStr(witness, mcl::IoSerialize);
+    } catch (const std::exception&) {
+        return false;
+    }
+    proof.op_type = record.op;
+    proof.element = record.element;
+    return true;
+}
+
+/**
+ * @brief 解析日志，遇到不完整、校验失败或序号不递增的记录即停止。
+ * @param valid_end 输出最后一条有效记录之后的文件偏移。
+ * @return 头部不符时返回 false。
+ */
+bool parseLog(const uint8_t* data, size_t size, uint64_t& base_lsn, std::vector<WalRecord>& records,
+              size_t& valid_end) {
+    if (size < LOG_HEADER_BYTES || std::memcmp(data, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) return false;
+    base_lsn = readLE<uint64_t>(data + 8);
+    size_t offset = LOG_HEADER_BYTES;
+    uint64_t previous = base_lsn;
+    while (size - offset >= FRAME_BYTES) {
+        const size_t len = readLE<uint32_t>(data + offset);
+        const uint32_t crc = readLE<uint32_t>(data + offset + 4);
+        if (len > MAX_RECORD_BYTES || size - offset - FRAME_BYTES < len) break;
+        const uint8_t* payload = data + offset + FRAME_BYTES;
+        WalRecord record;
+        if (BinaryCodec::crc32(payload, len) != crc || !decodeRecord(payload, len, record) ||
+            record.lsn <= previous) {
+            break;
+        }
+        previous = record.lsn;
+        records.push_back(record);
+        offset += FRAME_BYTES + len;
+    }
+    valid_end = offset;
+    return true;
+}
+
+std::vector<uint8_t> encodeDelta(uint64_t lsn, const std::vector<int>& added, const std::vector<int>& removed) {
+    std::vector<uint8_t> varints;
+    for (int el : added) BinaryCodec::putVarint(varints, static_cast<uint32_t>(el));
+    for (int el : removed) BinaryCodec::putVarint(varints, static_cast<uint32_t>(el));
+    std::vector<uint8_t> bytes(DELTA_HEADER_BYTES, 0);
+    std::memcpy(bytes.data(), DELTA_MAGIC, sizeof(DELTA_MAGIC));
+    writeLE<uint64_t>(bytes.data() + 8, lsn);
+    writeLE<uint64_t>(bytes.data() + 16, added.size());
+    writeLE<uint64_t>(bytes.data() + 24, removed.size());
+    writeLE<uint64_t>(bytes.data() + 32, varints.size());
+    bytes.insert(bytes.end(), varints.begin(), varints.end());
+    uint8_t crc[4];
+    writeLE<uint32_t>(crc, BinaryCodec::crc32(bytes.data(), bytes.size()));
+    bytes.insert(bytes.end(), crc, crc + 4);
+    return bytes;
+}
+
+uint64_t decodeDelta(const std::string& path, std::vector<int>& added, std::vector<int>& removed) {
+    MappedFile file(path, true);
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+    if (size < DELTA_HEADER_BYTES + 4 || std::memcmp(data, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0 ||
+        BinaryCodec::crc32(data, size - 4) != readLE<uint32_t>(data + size - 4) ||
+        readLE<uint64_t>(data + 32) != size - 4 - DELTA_HEADER_BYTES) {
+        throw walError(path + " is corrupted");
+    }
+    const uint64_t add_count = readLE<uint64_t>(data + 16);
+    const uint64_t remove_count = readLE<uint64_t>(data + 24);
+    if (add_count > size || remove_count > size) {
+        throw walError(path + " is corrupted");
+    }
+    const uint8_t* p = data + DELTA_HEADER_BYTES;
+    const uint8_t* end = data + size - 4;
+    for (uint64_t i = 0; i < add_count + remove_count; ++i) {
+        uint64_t v = 0;
+        if (!BinaryCodec::getVarint(p, end, v) || v > UINT32_MAX) {
+            throw walError(path + " is corrupted");
+        }
+        (i < add_count ? added : removed).push_back(static_cast<int>(static_cast<uint32_t>(v)));
+    }
+    if (p != end) {
+        throw walError(path + " is corrupted");
+    }
+    return readLE<uint64_t>(data + 8);
+}
+
+} // namespace
+
+// ==========================================================================================
+// WriteAheadLog - 打开与恢复
+// ==========================================================================================
+
+WriteAheadLog::WriteAheadLog(const std::string& dir, const ExpressiveTrustedSetup& setup, const WalOptions& options)
+    : dir_(dir), setup_(setup), options_(options), fd_(-1), flushing_(false), failed_(false), last_lsn_(0),
+      durable_lsn_(0), checkpoint_lsn_(0), log_bytes_(0) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    try {
+        drain(lock);
+    } catch (const std::exception&) {
+        // 析构时无法报告错误；已返回给调用者的操作都已落盘
+    }
+    if (fd_ >= 0) ::close(fd_);
+}
+
+std::unique_ptr<WriteAheadLog> WriteAheadLog::open(const std::string& dir, const ExpressiveTrustedSetup& setup,
+                                                   GroupType type, const WalOptions& options) {
+    if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw walError("cannot create directory " + dir);
+    }
+    std::unique_ptr<WriteAheadLog> wal(new WriteAheadLog(dir, setup, options));
+    wal->recover(type);
+    return wal;
+}
+
+void WriteAheadLog::recover(GroupType type) {
+    // 1. 完整快照
+    const std::string state_path = dir_ + STATE_FILE;
+    if (fileExists(state_path)) {
+        acc_ = ExpressiveAccumulator::load(state_path, setup_);
+    } else {
+        acc_.reset(new ExpressiveAccumulator(setup_, type));
+    }
+
+    // 2. 增量检查点：脏元素在检查点时的状态
+    const std::string delta_path = dir_ + DELTA_FILE;
+    if (fileExists(delta_path)) {
+        std::vector<int> added, removed;
+        checkpoint_lsn_ = decodeDelta(delta_path, added, removed);
+        acc_->applyUpdates(added, removed);
+        dirty_.insert(added.begin(), added.end());
+        dirty_.insert(removed.begin(), removed.end());
+    }
+
+    // 3. 日志尾部：按元素合并后批量回放，并截掉崩溃时未写完的记录
+    const std::string log_path = dir_ + LOG_FILE;
+    if (!fileExists(log_path)) {
+        last_lsn_ = durable_lsn_ = checkpoint_lsn_;
+        openLog(true, checkpoint_lsn_);
+        return;
+    }
+    uint64_t base_lsn = 0;
+    std::vector<WalRecord> records;
+    size_t valid_end = 0, file_size = 0;
+    {
+        MappedFile file(log_path, true);
+        file_size = file.size();
+        if (!parseLog(file.data(), file.size(), base_lsn, records, valid_end)) {
+            throw walError(log_path + " is not a write-ahead log");
+        }
+    }
+    if (base_lsn > checkpoint_lsn_) {
+        throw walError(log_path + " starts after the last checkpoint");
+    }
+    std::map<int, UpdateOperation> last_op;
+    last_lsn_ = checkpoint_lsn_;
+    for (const WalRecord& record : records) {
+        // 检查点之后、日志截断之前崩溃时，日志中可能仍有已检查点的记录
+        if (record.lsn <= checkpoint_lsn_) continue;
+        last_op[record.element] = record.op;
+        last_lsn_ = record.lsn;
+        ++stats_.replayed;
+    }
+    std::vector<int> added, removed;
+    for (const auto& entry : last_op) {
+        (entry.second == UpdateOperation::ADD ? added : removed).push_back(entry.first);
+        dirty_.insert(entry.first);
+    }
+    acc_->applyUpdates(added, removed);
+    durable_lsn_ = last_lsn_;
+
+    if (valid_end < file_size && ::truncate(log_path.c_str(), static_cast<off_t>(valid_end)) != 0) {
+        throw walError("cannot truncate " + log_path);
+    }
+    log_bytes_ = valid_end - LOG_HEADER_BYTES;
+    openLog(false, base_lsn);
+}
+
+void WriteAheadLog::openLog(bool create, uint64_t base_lsn) {
+    const std::string log_path = dir_ + LOG_FILE;
+    if (create) {
+        std::vector<uint8_t> header(LOG_HEADER_BYTES, 0);
+        std::memcpy(header.data(), LOG_MAGIC, sizeof(LOG_MAGIC));
+        writeLE<uint64_t>(header.data() + 8, base_lsn);
+        writeFileAtomically(dir_, log_path, header, options_.sync);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    fd_ = ::open(log_path.c_str(), O_WRONLY | O_APPEND);
+    if (fd_ < 0) {
+        throw walError("cannot open " + log_path);
+    }
+}
+
+// ==========================================================================================
+// WriteAheadLog - 写入与组提交
+// ==========================================================================================
+
+void WriteAheadLog::throwIfFailed() const {
+    if (failed_) {
+        throw walError("log write failed earlier; reopen " + dir_ + " to recover");
+    }
+}
+
+void WriteAheadLog::append(UpdateOperation op, int element, const UpdateProof* proof) {
+    encodeRecord(pending_, ++last_lsn_, op, element, proof);
+    dirty_.insert(element);
+    ++stats_.records;
+}
+
+UpdateProof WriteAheadLog::addElement(int element) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    throwIfFailed();
+    const bool changes = acc_->getElements().count(element) == 0;
+    UpdateProof proof = acc_->addElement(element);
+    if (!changes) return proof;
+    append(UpdateOperation::ADD, element, options_.log_proofs ? &proof : nullptr);
+    waitDurable(lock, last_lsn_);
+    maybeCheckpoint(lock);
+    return proof;
+}
+
+UpdateProof WriteAheadLog::deleteElement(int element) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    throwIfFailed();
+    UpdateProof proof = acc_->deleteElement(element);
+    if (!proof.is_valid) return proof;
+    append(UpdateOperation::DELETE, element, options_.log_proofs ? &proof : nullptr);
+    waitDurable(lock, last_lsn_);
+    maybeCheckpoint(lock);
+    return proof;
+}
+
+void WriteAheadLog::waitDurable(std::unique_lock<std::mutex>& lock, uint64_t lsn) {
+    while (durable_lsn_ < lsn) {
+        throwIfFailed();
+        if (!flushing_) {
+            flushPending(lock);
+        } else {
+            flushed_.wait(lock);
+        }
+    }
+}
+
+void WriteAheadLog::flushPending(std::unique_lock<std::mutex>& lock) {
+    flushing_ = true;
+    if (options_.group_commit_delay_us > 0) {
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(options_.group_commit_delay_us));
+        lock.lock();
+    }
+    std::vector<uint8_t> batch;
+    batch.swap(pending_);
+    const uint64_t batch_lsn = last_lsn_;
+    const int fd = fd_;
+
+    // 写盘期间释放锁，其他写者继续提交到下一批
+    lock.unlock();
+    const bool ok = writeAll(fd, batch.data(), batch.size()) && (!options_.sync || dataSync(fd));
+    lock.lock();
+
+    flushing_ = false;
+    if (ok) {
+        durable_lsn_ = batch_lsn;
+        log_bytes_ += batch.size();
+        ++stats_.group_commits;
+        if (options_.sync) ++stats_.syncs;
+    } else {
+        failed_ = true;
+    }
+    flushed_.notify_all();
+}
+
+void WriteAheadLog::drain(std::unique_lock<std::mutex>& lock) {
+    while (flushing_ || !pending_.empty()) {
+        throwIfFailed();
+        if (!flushing_) {
+            flushPending(lock);
+        } else {
+            flushed_.wait(lock);
+        }
+    }
+    throwIfFailed();
+}
+
+// ==========================================================================================
+// WriteAheadLog - 检查点
+// ==========================================================================================
+
+void WriteAheadLog::checkpoint() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    throwIfFailed();
+    checkpointLocked(lock);
+}
+
+void WriteAheadLog::maybeCheckpoint(std::unique_lock<std::mutex>& lock) {
+    if (options_.checkpoint_bytes == 0 || log_bytes_ < options_.checkpoint_bytes) return;
+    try {
+        checkpointLocked(lock);
+    } catch (const std::runtime_error&) {
+        // 本次操作已经落盘，日志仍然完整；下次超过阈值时重试
+    }
+}
+
+void WriteAheadLog::checkpointLocked(std::unique_lock<std::mutex>& lock) {
+    drain(lock);
+    // 此后一直持有锁，没有新的记录
+    const uint64_t lsn = last_lsn_;
+    const std::set<int>& current = acc_->getElements();
+    const bool full = static_cast<double>(dirty_.size()) >
+                      options_.full_snapshot_ratio * static_cast<double>(std::max<size_t>(1, current.size()));
+
+    std::vector<int> added, removed;
+    if (full) {
+        // 先写快照、再写空增量：两步之间崩溃时，旧增量加上日志回放的结果仍与新快照一致
+        const std::string state_path = dir_ + STATE_FILE;
+        const std::string staged_path = state_path + ".new";
+        acc_->save(staged_path);
+        if (options_.sync) syncPath(staged_path, false);
+        if (std::rename(staged_path.c_str(), state_path.c_str()) != 0) {
+            std::remove(staged_path.c_str());
+            throw walError("cannot rename " + staged_path + " to " + state_path);
+        }
+        if (options_.sync) syncPath(dir_, true);
+    } else {
+        for (int el : dirty_) (current.count(el) ? added : removed).push_back(el);
+    }
+    writeFileAtomically(dir_, dir_ + DELTA_FILE, encodeDelta(lsn, added, removed), options_.sync);
+    if (full) {
+        dirty_.clear();
+        ++stats_.full_snapshots;
+    }
+
+    // 检查点已落盘，截断日志
+    try {
+        openLog(true, lsn);
+    } catch (const std::runtime_error&) {
+        failed_ = true;
+        throw;
+    }
+    checkpoint_lsn_ = lsn;
+    log_bytes_ = 0;
+    ++stats_.checkpoints;
+}
+
+// ==========================================================================================
+// WriteAheadLog - 查询
+// ==========================================================================================
+
+std::vector<WalRecord> WriteAheadLog::scan(const std::string& dir) {
+    const std::string log_path = dir + LOG_FILE;
+    MappedFile file(log_path, true);
+    uint64_t base_lsn = 0;
+    size_t valid_end = 0;
+    std::vector<WalRecord> records;
+    if (!parseLog(file.data(), file.size(), base_lsn, records, valid_end)) {
+        throw walError(log_path + " is not a write-ahead log");
+    }
+    return records;
+}
+
+AccumulatorDigest WriteAheadLog::digest() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return acc_->getDigest();
+}
+
+bool WriteAheadLog::contains(int element) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return acc_->getElements().count(element) != 0;
+}
+
+size_t WriteAheadLog::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return acc_->getElements().size();
+}
+
+uint64_t WriteAheadLog::durableLsn() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return durable_lsn_;
+}
+
+WalStats WriteAheadLog::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace expressive_accumulator